@@ -0,0 +1,28 @@
+#ifndef BENCHSOURCE_H
+#define BENCHSOURCE_H
+
+#include <string>
+
+// 各基准共用的生成源码，使它们报告的数字在同一输入上测得。
+// 全局常量数组与变量之后是约 lines / 12 个函数，每个函数 12 行，语句与表达式种类较全
+// （声明、数组、常量、while/if、逻辑与关系运算、括号、一元运算、getint 与 printf），最后是空的 main
+inline std::string makeBenchSource(size_t lines)
+{
+    std::string source = "const int K[2] = {1, 2};\nint g = 3;\n";
+    for (size_t i = 0, line = 0; line < lines; ++i, line += 12)
+    {
+        std::string n = std::to_string(i % 97);
+        source += "int f" + std::to_string(i) + "(int a, int b[])\n{\n";
+        source += "    int x = a * 3 + b[0] - 7 / 2 + " + n + " * (4 - 1);\n";
+        source += "    int y[4] = {1 + 2, 2 * 3, -3, !4};\n";
+        source += "    const int k = (5 + " + n + ") / 7 * 2 - 1;\n";
+        source += "    while (x < 100 && a != 0 || x == k + 1)\n    {\n";
+        source += "        x = x + y[1] * k - (a - " + n + ") / 3;\n";
+        source += "        if (x >= 50 || a == 3 && -x < 2)\n            x = getint();\n    }\n";
+        source += "    printf(\"%d\\n\", x + a * 2 - 1);\n}\n";
+    }
+    source += "int main()\n{\n    return 0;\n}\n";
+    return source;
+}
+
+#endif // BENCHSOURCE_H
@@ -0,0 +1,134 @@
+// 扁平语法树基准：在生成的大程序上测量指针树到 FlatAst 的转换耗时与内存，
+// 并分别在两种表示上对所有表达式子树做常量求值（校验结果一致），比较遍历耗时。
+// 用法：flat_ast_bench [源码行数] [重复次数]
+#include "evalConstant.h"
+#include "flatAst.h"
+#include "benchSource.h"
+#include "parser.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace
+{
+    bool isEvaluable(Node::Kind kind)
+    {
+        switch (kind)
+        {
+        case Node::ND_Number:
+        case Node::ND_LVal:
+        case Node::ND_CallExp:
+        case Node::ND_PrimaryExp:
+        case Node::ND_UnaryExp:
+        case Node::ND_AddExp:
+        case Node::ND_MulExp:
+        case Node::ND_LOrExp:
+        case Node::ND_LAndExp:
+        case Node::ND_EqExp:
+        case Node::ND_RelExp:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    double milliseconds(std::chrono::steady_clock::time_point begin)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    size_t lines = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    size_t repeat = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 5;
+    std::string source = makeBenchSource(lines);
+
+    StringInterner interner;
+    AST::AstArena arena;
+    Lexer lexer(source, interner);
+    Parser parser(lexer, arena);
+    CompUnit *program = parser.parseCompUnit();
+
+    double bestBuild = 1e300;
+    FlatAst flat;
+    std::vector<Node *> origins;
+    for (size_t i = 0; i < repeat; ++i)
+    {
+        auto begin = std::chrono::steady_clock::now();
+        flat = FlatAst::build(*program);
+        bestBuild = std::min(bestBuild, milliseconds(begin));
+    }
+    FlatAst::build(*program, &origins);
+
+    // 先序线性扫描找出所有最大的表达式子树
+    std::vector<uint32_t> roots;
+    for (uint32_t i = 0; i < flat.size();)
+    {
+        if (isEvaluable(flat.kind(i)))
+        {
+            roots.push_back(i);
+            i = flat[i].end_;
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    EvalConstant evaluator;
+    double bestTree = 1e300;
+    double bestFolded = 1e300;
+    double bestFlat = 1e300;
+    long long treeSum = 0;
+    long long foldedSum = 0;
+    long long flatSum = 0;
+    for (size_t i = 0; i < repeat; ++i)
+    {
+        // 清除上一轮留下的折叠标注，使树上求值每轮都完整遍历
+        for (Node *node : origins)
+        {
+            if (auto *exp = llvm::dyn_cast<Exp>(node))
+            {
+                exp->folded_ = false;
+            }
+        }
+        treeSum = 0;
+        auto begin = std::chrono::steady_clock::now();
+        for (uint32_t root : roots)
+        {
+            treeSum += evaluator.Eval(origins[root]);
+        }
+        bestTree = std::min(bestTree, milliseconds(begin));
+
+        // 再次求值只读取根上的标注
+        foldedSum = 0;
+        begin = std::chrono::steady_clock::now();
+        for (uint32_t root : roots)
+        {
+            foldedSum += evaluator.Eval(origins[root]);
+        }
+        bestFolded = std::min(bestFolded, milliseconds(begin));
+
+        flatSum = 0;
+        begin = std::chrono::steady_clock::now();
+        for (uint32_t root : roots)
+        {
+            flatSum += evaluator.Eval(flat, root);
+        }
+        bestFlat = std::min(bestFlat, milliseconds(begin));
+    }
+    if (treeSum != flatSum || treeSum != foldedSum)
+    {
+        std::cerr << "evaluation mismatch: tree " << treeSum << ", folded " << foldedSum << ", flat " << flatSum
+                  << std::endl;
+        return 1;
+    }
+
+    std::cout << lines << " lines: " << flat.size() << " nodes, tree " << arena.bytesAllocated() << " bytes, flat "
+              << flat.size() * sizeof(FlatNode) << " bytes; build " << bestBuild << " ms" << std::endl;
+    std::cout << roots.size() << " expressions: tree eval " << bestTree << " ms, folded " << bestFolded
+              << " ms, flat eval " << bestFlat << " ms (best of " << repeat << ")" << std::endl;
+    return 0;
+}
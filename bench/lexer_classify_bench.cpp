@@ -0,0 +1,161 @@
+// 关键字/运算符识别微基准：对比原先基于 std::unordered_map<std::string, TokenType>
+// 的查找方式（构造临时 std::string，find 之后再 operator[]）与 Lexer 的完美哈希、参照词法分析器的分支匹配。
+// 用法：lexer_classify_bench [迭代轮数]
+#include "referenceLexer.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+
+namespace
+{
+    // 原 Lexer 成员表的副本（每个 Lexer 实例都会重新构造）
+    const std::unordered_map<std::string, TokenType> kMapKeywords = {
+        {"auto", TokenType::KEYWORD_AUTO}, {"break", TokenType::KEYWORD_BREAK}, {"case", TokenType::KEYWORD_CASE},
+        {"char", TokenType::KEYWORD_CHAR}, {"const", TokenType::KEYWORD_CONST}, {"continue", TokenType::KEYWORD_CONTINUE},
+        {"default", TokenType::KEYWORD_DEFAULT}, {"do", TokenType::KEYWORD_DO}, {"double", TokenType::KEYWORD_DOUBLE},
+        {"else", TokenType::KEYWORD_ELSE}, {"enum", TokenType::KEYWORD_ENUM}, {"extern", TokenType::KEYWORD_EXTERN},
+        {"float", TokenType::KEYWORD_FLOAT}, {"for", TokenType::KEYWORD_FOR}, {"goto", TokenType::KEYWORD_GOTO},
+        {"if", TokenType::KEYWORD_IF}, {"int", TokenType::KEYWORD_INT}, {"long", TokenType::KEYWORD_LONG},
+        {"register", TokenType::KEYWORD_REGISTER}, {"return", TokenType::KEYWORD_RETURN}, {"short", TokenType::KEYWORD_SHORT},
+        {"signed", TokenType::KEYWORD_SIGNED}, {"sizeof", TokenType::KEYWORD_SIZEOF}, {"static", TokenType::KEYWORD_STATIC},
+        {"struct", TokenType::KEYWORD_STRUCT}, {"switch", TokenType::KEYWORD_SWITCH}, {"typedef", TokenType::KEYWORD_TYPEDEF},
+        {"union", TokenType::KEYWORD_UNION}, {"unsigned", TokenType::KEYWORD_UNSIGNED}, {"void", TokenType::KEYWORD_VOID},
+        {"volatile", TokenType::KEYWORD_VOLATILE}, {"while", TokenType::KEYWORD_WHILE}, {"getint", TokenType::KEYWORD_GETINT},
+        {"printf", TokenType::KEYWORD_PRINTF}, {"main", TokenType::KEYWORD_MAIN}};
+
+    const std::unordered_map<std::string, TokenType> kMapOperators = {
+        {"+", TokenType::OPERATOR_PLUS}, {"-", TokenType::OPERATOR_MINUS}, {"*", TokenType::OPERATOR_MULTIPLY},
+        {"/", TokenType::OPERATOR_DIVIDE}, {"%", TokenType::OPERATOR_MODULO}, {"++", TokenType::OPERATOR_INCREMENT},
+        {"--", TokenType::OPERATOR_DECREMENT}, {"=", TokenType::OPERATOR_ASSIGN}, {"+=", TokenType::OPERATOR_AND_ASSIGN},
+        {"-=", TokenType::OPERATOR_MINUS_ASSIGN}, {"*=", TokenType::OPERATOR_MULTIPLY_ASSIGN}, {"/=", TokenType::OPERATOR_DIVIDE_ASSIGN},
+        {"%=", TokenType::OPERATOR_MODULO_ASSIGN}, {"&=", TokenType::OPERATOR_AND_ASSIGN}, {"|=", TokenType::OPERATOR_OR_ASSIGN},
+        {"^=", TokenType::OPERATOR_XOR_ASSIGN}, {"<<=", TokenType::OPERATOR_LEFT_SHIFT_ASSIGN}, {">>=", TokenType::OPERATOR_RIGHT_SHIFT_ASSIGN},
+        {"==", TokenType::OPERATOR_EQUAL}, {"!=", TokenType::OPERATOR_NOT_EQUAL}, {">", TokenType::OPERATOR_GREATER},
+        {"<", TokenType::OPERATOR_LESS}, {">=", TokenType::OPERATOR_GREATER_EQUAL}, {"<=", TokenType::OPERATOR_LESS_EQUAL},
+        {"&&", TokenType::OPERATOR_LOGICAL_AND}, {"||", TokenType::OPERATOR_LOGICAL_OR}, {"!", TokenType::OPERATOR_LOGICAL_NOT},
+        {"&", TokenType::OPERATOR_BITWISE_AND}, {"|", TokenType::OPERATOR_BITWISE_OR}, {"^", TokenType::OPERATOR_BITWISE_XOR},
+        {"~", TokenType::OPERATOR_BITWISE_NOT}, {"<<", TokenType::OPERATOR_LEFT_SHIFT}, {">>", TokenType::OPERATOR_RIGHT_SHIFT}};
+
+    // 原 readIdentifierOrKeyword 的查找方式
+    TokenType mapClassifyKeyword(std::string_view word)
+    {
+        std::string identifier(word);
+        auto &keywords = const_cast<std::unordered_map<std::string, TokenType> &>(kMapKeywords);
+        if (keywords.find(identifier) != keywords.end())
+        {
+            return keywords[identifier];
+        }
+        return TokenType::IDENTIFIER;
+    }
+
+    // 原 readOperator 的查找方式：依次构造三字、双字、单字键
+    TokenType mapClassifyOperator(std::string_view text, size_t &length)
+    {
+        auto &operators = const_cast<std::unordered_map<std::string, TokenType> &>(kMapOperators);
+        std::string first(1, text[0]);
+        std::string third(first);
+        third += text.size() > 1 ? text[1] : '\0';
+        third += text.size() > 2 ? text[2] : '\0';
+        if (operators.find(third) != operators.end())
+        {
+            length = 3;
+            return operators[third];
+        }
+        std::string second(first);
+        second += text.size() > 1 ? text[1] : '\0';
+        if (operators.find(second) != operators.end())
+        {
+            length = 2;
+            return operators[second];
+        }
+        if (operators.find(first) != operators.end())
+        {
+            length = 1;
+            return operators[first];
+        }
+        length = 0;
+        return TokenType::UNKNOW;
+    }
+
+    template <typename F>
+    double timeIt(F &&f)
+    {
+        auto begin = std::chrono::steady_clock::now();
+        f();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - begin).count();
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int rounds = argc > 1 ? std::atoi(argv[1]) : 200;
+
+    // 语料：关键字与典型标识符大致各半，运算符覆盖一到三字符
+    std::vector<std::string> words;
+    for (auto &entry : kMapKeywords)
+    {
+        words.push_back(entry.first);
+    }
+    const char *identifiers[] = {"i", "j", "arr", "sum", "result", "index", "tmp", "value",
+                                 "counter", "matrix_a", "buffer", "len", "n", "foo", "bar", "mainLoop"};
+    for (auto *identifier : identifiers)
+    {
+        words.push_back(identifier);
+        words.push_back(std::string(identifier) + "1");
+    }
+    std::vector<std::string> operators;
+    for (auto &entry : kMapOperators)
+    {
+        operators.push_back(entry.first + " x");
+    }
+
+    std::mt19937 rng(42);
+    std::vector<std::string_view> wordStream, operatorStream;
+    for (int i = 0; i < 100000; ++i)
+    {
+        wordStream.push_back(words[rng() % words.size()]);
+        operatorStream.push_back(operators[rng() % operators.size()]);
+    }
+
+    // 先校验两种实现结果一致
+    for (auto word : wordStream)
+    {
+        if (mapClassifyKeyword(word) != Lexer::classifyKeyword(word))
+        {
+            std::cerr << "keyword mismatch: " << word << std::endl;
+            return 1;
+        }
+    }
+    for (auto text : operatorStream)
+    {
+        size_t mapLength = 0, length = 0;
+        if (mapClassifyOperator(text, mapLength) != ReferenceLexer::classifyOperator(text, length) || mapLength != length)
+        {
+            std::cerr << "operator mismatch: " << text << std::endl;
+            return 1;
+        }
+    }
+
+    size_t checksum = 0;
+    double mapKeywordNs = timeIt([&]
+                                 { for (int r = 0; r < rounds; ++r) for (auto word : wordStream) checksum += static_cast<size_t>(mapClassifyKeyword(word)); });
+    double hashKeywordNs = timeIt([&]
+                                  { for (int r = 0; r < rounds; ++r) for (auto word : wordStream) checksum += static_cast<size_t>(Lexer::classifyKeyword(word)); });
+    double mapOperatorNs = timeIt([&]
+                                  { for (int r = 0; r < rounds; ++r) for (auto text : operatorStream) { size_t length; checksum += static_cast<size_t>(mapClassifyOperator(text, length)) + length; } });
+    double switchOperatorNs = timeIt([&]
+                                     { for (int r = 0; r < rounds; ++r) for (auto text : operatorStream) { size_t length; checksum += static_cast<size_t>(ReferenceLexer::classifyOperator(text, length)) + length; } });
+
+    double lookups = static_cast<double>(rounds) * wordStream.size();
+    std::cout << "keyword  unordered_map: " << mapKeywordNs / lookups << " ns/lookup" << std::endl;
+    std::cout << "keyword  perfect hash : " << hashKeywordNs / lookups << " ns/lookup"
+              << "  (x" << mapKeywordNs / hashKeywordNs << ")" << std::endl;
+    std::cout << "operator unordered_map: " << mapOperatorNs / lookups << " ns/lookup" << std::endl;
+    std::cout << "operator switch trie  : " << switchOperatorNs / lookups << " ns/lookup"
+              << "  (x" << mapOperatorNs / switchOperatorNs << ")" << std::endl;
+    std::cout << "checksum " << checksum << std::endl;
+    return 0;
+}
@@ -0,0 +1,85 @@
+// 并行词法分析扩展性基准：对同一份生成源码，依次用 1..N 个线程调用 tokenizeParallel()，
+// 校验结果与顺序 tokenize() 完全一致，并输出吞吐量与相对顺序扫描的加速比。
+// 用法：lexer_parallel_bench [源码 MB 数] [最大线程数，默认为硬件并发数]
+#include "lexer.h"
+#include "threadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace
+{
+    // 块注释、字符串与普通代码交替出现，块边界会落在各种上下文中
+    std::string makeSource(size_t bytes)
+    {
+        std::string source;
+        int i = 0;
+        while (source.size() < bytes)
+        {
+            std::string n = std::to_string(i);
+            source += "/* helper " + n + "\n * int fake(int a) { return \"not code\"; }\n */\n";
+            source += "int f" + n + "(int a, int b[])\n{\n";
+            source += "    int sum" + n + " = 0; // running total\n";
+            source += "    while (a > 0)\n    {\n        sum" + n + " = sum" + n + " + b[a] * " + n + ";\n";
+            source += "        a = a - 1;\n    }\n";
+            source += "    printf(\"f" + n + ": %d /* not a comment */\\n\", sum" + n + ");\n";
+            source += "    return sum" + n + ";\n}\n\n";
+            ++i;
+        }
+        return source;
+    }
+
+    size_t digest(const TokenBuffer &tokens)
+    {
+        size_t hash = tokens.size();
+        for (size_t i = 0; i < tokens.size(); ++i)
+        {
+            hash = hash * 31 + static_cast<size_t>(tokens.kind(i));
+            hash = hash * 31 + static_cast<size_t>(tokens.offset(i));
+            hash = hash * 31 + static_cast<size_t>(tokens.symbol(i));
+        }
+        return hash;
+    }
+
+    double seconds(std::chrono::steady_clock::time_point begin)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    size_t megabytes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 32;
+    size_t maxThreads = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : std::max(1u, std::thread::hardware_concurrency());
+    std::string source = makeSource(megabytes << 20);
+
+    StringInterner interner;
+    Lexer sequential(source, interner);
+    auto begin = std::chrono::steady_clock::now();
+    sequential.tokenize();
+    double baseline = seconds(begin);
+    size_t expected = digest(sequential.getTokens());
+    std::cout << "sequential: " << sequential.getTokens().size() << " tokens, "
+              << source.size() / baseline / (1 << 20) << " MB/s" << std::endl;
+
+    for (size_t threads = 1; threads <= maxThreads; ++threads)
+    {
+        ThreadPool pool(threads);
+        StringInterner parallelInterner;
+        Lexer parallel(source, parallelInterner);
+        begin = std::chrono::steady_clock::now();
+        parallel.tokenizeParallel(pool);
+        double elapsed = seconds(begin);
+        if (digest(parallel.getTokens()) != expected)
+        {
+            std::cerr << threads << " threads: token mismatch" << std::endl;
+            return 1;
+        }
+        std::cout << threads << " threads: " << source.size() / elapsed / (1 << 20) << " MB/s, speedup "
+                  << baseline / elapsed << "x" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,95 @@
+// 空白/注释跳过基准：在注释与缩进占多数的生成源码上，分别用标量、SSE2、AVX2 实现完整扫描一遍，
+// 校验三者产生的 token（含行列号）完全一致，并输出吞吐量。
+// 用法：lexer_skip_bench [源码 MB 数]
+#include "charScanner.h"
+#include "lexer.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace
+{
+    std::string makeSource(size_t bytes)
+    {
+        std::string source;
+        int i = 0;
+        while (source.size() < bytes)
+        {
+            source += "/*\n * block comment ";
+            source += std::to_string(i);
+            source += "\n * that spans a few lines of text ...\n */\n";
+            source += "int f" + std::to_string(i) + "(int a)\n{\n";
+            source += "        // line comment with some words in it\n";
+            source += "        if (a > 0)\n        {\n                return a - 1;   // trailing\n        }\n";
+            source += "\t\treturn a;\n}\n\n\n";
+            ++i;
+        }
+        return source;
+    }
+
+    // 所有 token 的摘要，用于比较不同实现的结果
+    size_t digest(const TokenBuffer &tokens)
+    {
+        size_t hash = tokens.size();
+        for (size_t i = 0; i < tokens.size(); ++i)
+        {
+            hash = hash * 31 + static_cast<size_t>(tokens.kind(i));
+            hash = hash * 31 + static_cast<size_t>(tokens.offset(i));
+            hash = hash * 31 + tokens.text(i).size();
+        }
+        return hash;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    size_t megabytes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 16;
+    std::string source = makeSource(megabytes << 20);
+    std::string commentBody = source;
+    for (size_t pos = commentBody.find("*/"); pos != std::string::npos; pos = commentBody.find("*/", pos))
+    {
+        commentBody[pos] = ' ';
+    }
+
+    size_t expected = 0;
+    bool first = true;
+    for (CharScanner::Isa isa : {CharScanner::Isa::Scalar, CharScanner::Isa::Sse2, CharScanner::Isa::Avx2})
+    {
+        if (!CharScanner::useIsa(isa))
+        {
+            std::cout << CharScanner::isaName(isa) << ": not supported" << std::endl;
+            continue;
+        }
+
+        StringInterner interner;
+        Lexer lexer(source, interner);
+        auto begin = std::chrono::steady_clock::now();
+        lexer.tokenize();
+        auto end = std::chrono::steady_clock::now();
+
+        size_t hash = digest(lexer.getTokens());
+        if (first)
+        {
+            expected = hash;
+            first = false;
+        }
+        else if (hash != expected)
+        {
+            std::cerr << CharScanner::isaName(isa) << ": token mismatch" << std::endl;
+            return 1;
+        }
+
+        // 单独测量扫描原语：把整份源码当作一段块注释体
+        auto scanBegin = std::chrono::steady_clock::now();
+        size_t stop = CharScanner::findCommentEnd(commentBody, 0);
+        auto scanEnd = std::chrono::steady_clock::now();
+
+        double seconds = std::chrono::duration<double>(end - begin).count();
+        double scanSeconds = std::chrono::duration<double>(scanEnd - scanBegin).count();
+        std::cout << CharScanner::isaName(isa) << ": tokenize " << lexer.getTokens().size() << " tokens, "
+                  << source.size() / seconds / (1 << 20) << " MB/s; comment scan "
+                  << commentBody.size() / scanSeconds / (1 << 20) << " MB/s (stop " << stop << ")" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,121 @@
+// 语法分析基准：在约 10 万行（数千个函数）的生成源码上测量解析耗时、每个 token 的平均耗时、
+// 解析期间的堆分配次数，以及语法树（AstArena）的节点数、占用字节数与释放耗时；
+// 另外测量流式模式（边扫描边解析）的总耗时，以及 1..N 个线程并行解析函数定义的耗时。
+// 用法：parser_bench [源码行数] [重复次数]
+#include "benchSource.h"
+#include "parser.h"
+#include "threadPool.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <thread>
+
+namespace
+{
+    size_t allocationCount = 0;
+
+    double milliseconds(std::chrono::steady_clock::time_point begin)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    }
+}
+
+void *operator new(size_t size)
+{
+    ++allocationCount;
+    if (void *p = std::malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    std::free(p);
+}
+
+int main(int argc, char *argv[])
+{
+    size_t lines = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    size_t repeat = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 5;
+    std::string source = makeBenchSource(lines);
+
+    StringInterner interner;
+    Lexer lexer(source, interner);
+    lexer.tokenize();
+
+    double bestParse = 1e300;
+    double bestTeardown = 1e300;
+    for (size_t i = 0; i < repeat; ++i)
+    {
+        auto *arena = new AST::AstArena();
+        size_t allocations = allocationCount;
+        auto begin = std::chrono::steady_clock::now();
+        Parser parser(lexer.getTokens(), *arena);
+        AST::CompUnit *program = parser.parseCompUnit();
+        double parse = milliseconds(begin);
+        allocations = allocationCount - allocations;
+        size_t functions = program->funcDefs_.size();
+        size_t nodes = arena->nodeCount();
+        size_t bytes = arena->bytesAllocated();
+
+        begin = std::chrono::steady_clock::now();
+        delete arena;
+        double teardown = milliseconds(begin);
+
+        bestParse = std::min(bestParse, parse);
+        bestTeardown = std::min(bestTeardown, teardown);
+        if (i == 0)
+        {
+            std::cout << lines << " lines, " << lexer.getTokens().size() << " tokens, " << functions
+                      << " functions: " << nodes << " nodes, " << bytes << " arena bytes, " << allocations
+                      << " heap allocations during parse" << std::endl;
+        }
+    }
+
+    double bestStream = 1e300;
+    for (size_t i = 0; i < repeat; ++i)
+    {
+        AST::AstArena arena;
+        auto begin = std::chrono::steady_clock::now();
+        Lexer streaming(source, interner);
+        Parser parser(streaming, arena);
+        parser.parseCompUnit();
+        bestStream = std::min(bestStream, milliseconds(begin));
+    }
+
+    std::cout << "parse " << bestParse << " ms (" << bestParse * 1e6 / lexer.getTokens().size()
+              << " ns/token), teardown " << bestTeardown << " ms; streaming lex+parse " << bestStream
+              << " ms (best of " << repeat << ")" << std::endl;
+
+    // 并行解析函数定义：线程数从 1 倍增到硬件并发数
+    size_t maxThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    for (size_t threads = 1;; threads = std::min(threads * 2, maxThreads))
+    {
+        ThreadPool pool(threads);
+        double best = 1e300;
+        for (size_t i = 0; i < repeat; ++i)
+        {
+            AST::AstArena arena;
+            auto begin = std::chrono::steady_clock::now();
+            Parser parser(lexer.getTokens(), arena);
+            parser.parseCompUnit(&pool);
+            best = std::min(best, milliseconds(begin));
+        }
+        std::cout << "parallel parse, " << threads << " threads: " << best << " ms (" << bestParse / best
+                  << "x sequential)" << std::endl;
+        if (threads == maxThreads)
+        {
+            break;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,184 @@
+// 符号表基准：模拟生成代码中深层嵌套的语句块——每层作用域定义若干局部变量（部分遮蔽外层同名变量），
+// 并在最内层反复查找各层及全局的名字。分别用每个作用域一张哈希表的栈（逐层探查）与 SymbolTable
+// （单表 + 撤销日志）执行同一操作序列，比较耗时与堆分配次数，并校验两者的查找结果一致。
+// 用法：symbol_table_bench [嵌套深度] [块数] [重复次数]
+#include "symbolTable.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <unordered_map>
+
+namespace
+{
+    size_t allocationCount = 0;
+
+    constexpr size_t kGlobals = 64;       // 全局名字数
+    constexpr size_t kLocalsPerScope = 4; // 每层定义的局部变量数
+    constexpr size_t kLookupsPerScope = 16;
+
+    // 每个作用域一张哈希表、查找从内到外逐层探查的符号表
+    class MapStackTable
+    {
+        std::vector<std::unordered_map<SymbolId, std::unique_ptr<Symbol>>> scopes_;
+
+    public:
+        MapStackTable() { scopes_.emplace_back(); }
+        void enterScope() { scopes_.emplace_back(); }
+        void exitScope() { scopes_.pop_back(); }
+        Symbol *addSymbol(SymbolId id)
+        {
+            auto symbol = std::make_unique<VariableSymbol>();
+            symbol->id_ = id;
+            Symbol *added = symbol.get();
+            scopes_.back()[id] = std::move(symbol);
+            return added;
+        }
+        Symbol *lookup(SymbolId id)
+        {
+            for (auto it = scopes_.rbegin(); it != scopes_.rend(); ++it)
+            {
+                auto found = it->find(id);
+                if (found != it->end())
+                    return found->second.get();
+            }
+            return nullptr;
+        }
+    };
+
+    class FlatTable
+    {
+        SymbolTable table_;
+
+    public:
+        explicit FlatTable(StringInterner &interner) : table_(interner) {}
+        void enterScope() { table_.enterScope(); }
+        void exitScope() { table_.exitScope(); }
+        Symbol *addSymbol(SymbolId id)
+        {
+            VariableSymbol *symbol = table_.create<VariableSymbol>();
+            symbol->id_ = id;
+            return table_.addSymbol(symbol);
+        }
+        Symbol *lookup(SymbolId id) { return table_.lookup(id); }
+    };
+
+    // 第 depth 层第 k 个局部变量的名字：与全局名字及外层名字部分重叠，以产生遮蔽
+    SymbolId localName(const std::vector<SymbolId> &names, size_t depth, size_t k)
+    {
+        return names[(depth * 3 + k * 17) % names.size()];
+    }
+
+    // 执行一组嵌套块并返回所有查找结果的校验和（符号的名字编号与定义深度）
+    template <typename Table>
+    unsigned long long run(Table &table, const std::vector<SymbolId> &names, size_t depth, size_t blocks)
+    {
+        unsigned long long checksum = 0;
+        for (size_t g = 0; g < kGlobals; ++g)
+        {
+            table.addSymbol(names[g]);
+        }
+        for (size_t block = 0; block < blocks; ++block)
+        {
+            for (size_t d = 1; d <= depth; ++d)
+            {
+                table.enterScope();
+                for (size_t k = 0; k < kLocalsPerScope; ++k)
+                {
+                    if (Symbol *symbol = table.addSymbol(localName(names, d, k)))
+                    {
+                        symbol->lineDefined_ = static_cast<int>(d);
+                    }
+                }
+                for (size_t k = 0; k < kLookupsPerScope; ++k)
+                {
+                    Symbol *symbol = table.lookup(names[(block + d * 7 + k * 13) % names.size()]);
+                    checksum = checksum * 31 + (symbol ? symbol->id_ * 1000 + symbol->lineDefined_ : 1);
+                }
+            }
+            for (size_t d = 1; d <= depth; ++d)
+            {
+                table.exitScope();
+            }
+        }
+        return checksum;
+    }
+
+    double milliseconds(std::chrono::steady_clock::time_point begin)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    }
+
+    template <typename Make>
+    double measure(Make make, const std::vector<SymbolId> &names, size_t depth, size_t blocks, size_t repeat,
+                   unsigned long long &checksum, size_t &allocations)
+    {
+        double best = 1e300;
+        for (size_t r = 0; r < repeat; ++r)
+        {
+            auto table = make();
+            size_t before = allocationCount;
+            auto begin = std::chrono::steady_clock::now();
+            checksum = run(*table, names, depth, blocks);
+            best = std::min(best, milliseconds(begin));
+            allocations = allocationCount - before;
+        }
+        return best;
+    }
+}
+
+void *operator new(size_t size)
+{
+    ++allocationCount;
+    if (void *p = std::malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    std::free(p);
+}
+
+int main(int argc, char *argv[])
+{
+    size_t depth = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200;
+    size_t blocks = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 500;
+    size_t repeat = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 5;
+
+    StringInterner interner;
+    std::vector<SymbolId> names;
+    for (size_t i = 0; i < kGlobals * 4; ++i)
+    {
+        names.push_back(interner.intern("v" + std::to_string(i)));
+    }
+
+    unsigned long long mapChecksum = 0;
+    unsigned long long flatChecksum = 0;
+    size_t mapAllocations = 0;
+    size_t flatAllocations = 0;
+    double mapMs = measure([]
+                           { return std::make_unique<MapStackTable>(); },
+                           names, depth, blocks, repeat, mapChecksum, mapAllocations);
+    double flatMs = measure([&interner]
+                            { return std::make_unique<FlatTable>(interner); },
+                            names, depth, blocks, repeat, flatChecksum, flatAllocations);
+    if (mapChecksum != flatChecksum)
+    {
+        std::cerr << "lookup mismatch: map stack " << mapChecksum << ", SymbolTable " << flatChecksum << std::endl;
+        return 1;
+    }
+
+    std::cout << "depth " << depth << ", " << blocks << " blocks: scope map stack " << mapMs << " ms, "
+              << mapAllocations << " allocations; SymbolTable " << flatMs << " ms, " << flatAllocations
+              << " allocations (best of " << repeat << ")" << std::endl;
+    return 0;
+}
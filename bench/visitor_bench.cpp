@@ -0,0 +1,280 @@
+// 访问者分派基准：同一份遍历逻辑分别经虚函数 Visitor（accept + visit 两次间接调用）与
+// StaticVisitor（具体类型直接调用，抽象类型按种类查函数表）遍历生成的大程序语法树，比较耗时并校验结果一致。
+// 用法：visitor_bench [源码行数] [重复次数]
+#include "benchSource.h"
+#include "parser.h"
+#include "staticVisitor.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <type_traits>
+
+namespace
+{
+    // 统计节点数与字面量之和；Virtual 为 true 时经虚函数接口分派，否则经 StaticVisitor
+    template <bool Virtual>
+    class Walker : public std::conditional_t<Virtual, Visitor, StaticVisitor<Walker<Virtual>>>
+    {
+    public:
+        size_t nodes_ = 0;
+        long long sum_ = 0;
+
+        void visit(CompUnit &node)
+        {
+            ++nodes_;
+            for (auto *decl : node.decls_)
+                enter(decl);
+            for (auto *func : node.funcDefs_)
+                enter(func);
+            enter(node.mainfuncDef_);
+        }
+        void visit(ConstDef &node)
+        {
+            ++nodes_;
+            for (auto *dim : node.dimensions_)
+                enter(dim);
+            enter(node.initVal_);
+        }
+        void visit(ConstDecl &node)
+        {
+            ++nodes_;
+            enter(node.bType_);
+            for (auto *def : node.constDefs_)
+                enter(def);
+        }
+        void visit(VarDef &node)
+        {
+            ++nodes_;
+            for (auto *dim : node.constExps_)
+                enter(dim);
+            enter(node.initVal_);
+        }
+        void visit(VarDecl &node)
+        {
+            ++nodes_;
+            enter(node.bType_);
+            for (auto *def : node.varDefs_)
+                enter(def);
+        }
+        void visit(BType &)
+        {
+            ++nodes_;
+        }
+        void visit(InitVal &node)
+        {
+            ++nodes_;
+            if (auto *exp = std::get_if<Exp *>(&node.value_))
+                enter(*exp);
+            else
+                for (auto *item : std::get<llvm::ArrayRef<InitVal *>>(node.value_))
+                    enter(item);
+        }
+        void visit(ConstInitVal &node)
+        {
+            ++nodes_;
+            if (auto *exp = std::get_if<Exp *>(&node.value_))
+                enter(*exp);
+            else
+                for (auto *item : std::get<llvm::ArrayRef<ConstInitVal *>>(node.value_))
+                    enter(item);
+        }
+        void visit(ExpStmt &node)
+        {
+            ++nodes_;
+            enter(node.exp_);
+        }
+        void visit(Block &node)
+        {
+            ++nodes_;
+            for (auto *item : node.items_)
+                enter(item);
+        }
+        void visit(BlockItem &node)
+        {
+            ++nodes_;
+            enter(node.item_);
+        }
+        void visit(AssignStmt &node)
+        {
+            ++nodes_;
+            enter(node.lval_);
+            enter(node.exp_);
+        }
+        void visit(IfStmt &node)
+        {
+            ++nodes_;
+            enter(node.cond_);
+            enter(node.thenBranch_);
+            enter(node.elseBranch_);
+        }
+        void visit(WhileStmt &node)
+        {
+            ++nodes_;
+            enter(node.cond_);
+            enter(node.body_);
+        }
+        void visit(ReturnStmt &node)
+        {
+            ++nodes_;
+            enter(node.exp_);
+        }
+        void visit(IOStmt &node)
+        {
+            ++nodes_;
+            enter(node.target_);
+            for (auto *arg : node.args_)
+                enter(arg);
+        }
+        void visit(Number &node)
+        {
+            ++nodes_;
+            sum_ += node.value_;
+        }
+        void visit(LVal &node)
+        {
+            ++nodes_;
+            for (auto *index : node.indices_)
+                enter(index);
+        }
+        void visit(PrimaryExp &node)
+        {
+            ++nodes_;
+            std::visit([this](auto *operand) { enter(operand); }, node.operand_);
+        }
+        void visit(UnaryExp &node)
+        {
+            ++nodes_;
+            enter(node.operand_);
+        }
+        void visit(AddExp &node)
+        {
+            visitLayer(node.elements_);
+        }
+        void visit(MulExp &node)
+        {
+            visitLayer(node.elements_);
+        }
+        void visit(LOrExp &node)
+        {
+            visitLayer(node.elements_);
+        }
+        void visit(LAndExp &node)
+        {
+            visitLayer(node.elements_);
+        }
+        void visit(EqExp &node)
+        {
+            visitLayer(node.elements_);
+        }
+        void visit(RelExp &node)
+        {
+            visitLayer(node.elements_);
+        }
+        void visit(CallExp &node)
+        {
+            ++nodes_;
+            for (auto *arg : node.args_)
+                enter(arg);
+        }
+        void visit(FuncParam &node)
+        {
+            ++nodes_;
+            enter(node.bType_);
+            for (auto *dim : node.dimSizes_)
+                enter(dim);
+        }
+        void visit(FuncDef &node)
+        {
+            ++nodes_;
+            enter(node.returnType_);
+            for (auto *param : node.params_)
+                enter(param);
+            enter(node.body_);
+        }
+        void visit(MainFuncDef &node)
+        {
+            ++nodes_;
+            enter(node.body_);
+        }
+        void visit(FuncType &)
+        {
+            ++nodes_;
+        }
+
+    private:
+        // 保留子节点的静态类型，StaticVisitor 对具体类型直接调用 visit
+        template <typename T>
+        void enter(T *node)
+        {
+            if (!node)
+                return;
+            if constexpr (Virtual)
+                node->accept(*this);
+            else
+                this->visitNode(node);
+        }
+
+        void visitLayer(llvm::ArrayRef<std::variant<Exp *, TokenType>> elements)
+        {
+            ++nodes_;
+            for (auto &elem : elements)
+                if (auto *exp = std::get_if<Exp *>(&elem))
+                    enter(*exp);
+        }
+    };
+
+    double milliseconds(std::chrono::steady_clock::time_point begin)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    }
+
+    template <bool Virtual>
+    double measure(CompUnit &program, size_t repeat, size_t &nodes, long long &sum)
+    {
+        double best = 1e300;
+        for (size_t i = 0; i < repeat; ++i)
+        {
+            Walker<Virtual> walker;
+            auto begin = std::chrono::steady_clock::now();
+            if constexpr (Virtual)
+                program.accept(walker);
+            else
+                walker.visitNode(program);
+            best = std::min(best, milliseconds(begin));
+            nodes = walker.nodes_;
+            sum = walker.sum_;
+        }
+        return best;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    size_t lines = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    size_t repeat = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10;
+    std::string source = makeBenchSource(lines);
+
+    StringInterner interner;
+    AST::AstArena arena;
+    Lexer lexer(source, interner);
+    Parser parser(lexer, arena);
+    CompUnit *program = parser.parseCompUnit();
+
+    size_t virtualNodes = 0;
+    size_t staticNodes = 0;
+    long long virtualSum = 0;
+    long long staticSum = 0;
+    double virtualMs = measure<true>(*program, repeat, virtualNodes, virtualSum);
+    double staticMs = measure<false>(*program, repeat, staticNodes, staticSum);
+    if (virtualNodes != staticNodes || virtualSum != staticSum || virtualNodes != arena.nodeCount())
+    {
+        std::cerr << "traversal mismatch: virtual " << virtualNodes << " nodes, static " << staticNodes
+                  << " nodes, arena " << arena.nodeCount() << std::endl;
+        return 1;
+    }
+
+    std::cout << lines << " lines, " << staticNodes << " nodes: virtual Visitor " << virtualMs
+              << " ms, StaticVisitor " << staticMs << " ms (best of " << repeat << ")" << std::endl;
+    return 0;
+}
@@ -3,6 +3,9 @@
 #include <vector>
 #include <string>
 #include <iostream>
+#include <string_view>
+#include <iterator>
+#include <algorithm>
 
 enum class ErrorLevel
 {
@@ -19,18 +22,53 @@ enum class ErrorType
     CodeGenError   // 代码生成错误
 };
 
+// 延迟格式化的错误描述：format 为字符串字面量，其中 {0} 代换为 subject，{1} 代换为 detail，
+// 只在输出时才拼接成 std::string。subject 通常引用源码或驻留表中的名字，须存活至错误输出
+struct ErrorMessage
+{
+    const char *format;
+    std::string_view subject;
+    std::string detail; // 异常信息等少数需要复制的内容
+
+    ErrorMessage(const char *format, std::string_view subject = {}, std::string detail = {})
+        : format(format), subject(subject), detail(std::move(detail)) {}
+
+    std::string str() const
+    {
+        std::string text;
+        for (const char *p = format; *p; ++p)
+        {
+            if (p[0] == '{' && (p[1] == '0' || p[1] == '1') && p[2] == '}')
+            {
+                if (p[1] == '0')
+                    text += subject;
+                else
+                    text += detail;
+                p += 2;
+            }
+            else
+            {
+                text += *p;
+            }
+        }
+        return text;
+    }
+};
+
 struct ErrorInfo
 {
-    ErrorLevel level;    // 错误级别
-    char errorCode;      // 规范中的a-m错误码
-    int lineNumber;      // 错误行号
-    std::string message; // 错误描述
-    ErrorType type;      // 错误类型
-
-    ErrorInfo(ErrorLevel l, char code, int line, const std::string &msg, ErrorType t)
-        : level(l), errorCode(code), lineNumber(line), message(msg), type(t) {}
+    ErrorLevel level;     // 错误级别
+    char errorCode;       // 规范中的a-m错误码
+    int lineNumber;       // 错误行号
+    ErrorMessage message; // 错误描述
+    ErrorType type;       // 错误类型
+
+    ErrorInfo(ErrorLevel l, char code, int line, ErrorMessage msg, ErrorType t)
+        : level(l), errorCode(code), lineNumber(line), message(std::move(msg)), type(t) {}
 };
 
+// 一次编译（或其中一部分）的错误集合，由编译过程持有而不是全局共享。
+// 每个实例只由一个线程写入，不加锁：并行的各部分各用一个实例，完成后由持有者按源码顺序 merge
 class ErrorManager
 {
 private:
@@ -38,22 +76,29 @@ private:
     bool hasFatalError_ = false;
 
 public:
-    // 单例模式获取实例
-    static ErrorManager &getInstance()
-    {
-        static ErrorManager instance;
-        return instance;
-    }
+    ErrorManager() = default;
+    ErrorManager(const ErrorManager &) = delete;
+    ErrorManager &operator=(const ErrorManager &) = delete;
 
-    void addError(ErrorLevel level, char code, int line, const std::string &msg, ErrorType type)
+    void addError(ErrorLevel level, char code, int line, ErrorMessage msg, ErrorType type)
     {
         if (level == ErrorLevel::ERROR)
         {
             hasFatalError_ = true; // 如果是错误，设置为致命错误
         }
-        errors_.emplace_back(level, code, line, msg, type);
+        errors_.emplace_back(level, code, line, std::move(msg), type);
     }
 
+    // 把 other 中的错误按原顺序追加到本实例之后并清空 other；调用时 other 的写入者须已结束
+    void merge(ErrorManager &other)
+    {
+        hasFatalError_ = hasFatalError_ || other.hasFatalError_;
+        std::move(other.errors_.begin(), other.errors_.end(), std::back_inserter(errors_));
+        other.clear();
+    }
+
+    const std::vector<ErrorInfo> &errors() const { return errors_; }
+
     void reportErrors() const
     {
         for (const auto &error : errors_)
@@ -93,7 +138,7 @@ public:
             std::cerr << levelStr << " (" << typeStr << ") "
                       << "Error Code: " << error.errorCode
                       << " at Line " << error.lineNumber
-                      << ": " << error.message << std::endl;
+                      << ": " << error.message.str() << std::endl;
         }
     }
 
@@ -3,69 +3,104 @@
 
 #include "symbolTable.h"
 #include "astSysy.h"
+#include "staticVisitor.h"
 #include "evalConstant.h"
+#include "functionPrototype.h"
+#include "threadPool.h"
 #include <iostream>
+#include <memory>
 #include <variant>
 
 using namespace AST;
 
-class SemanticAnalyzer : public Visitor
+// 语义分析：检查声明与引用，并把每个 LVal、CallExp 解析到的符号以及每个定义登记的符号标注在语法树上，
+// 代码生成沿标注访问符号而不再按名字查找。符号归 symbolTable（及各函数体分析器的符号表）所有，分析器须存活至代码生成结束。
+// 分两个阶段：先顺序登记全局声明与全部函数签名，再检查各函数体；函数体只读全局作用域，可分块并行检查，
+// 每块的错误先写入本块的 ErrorManager，完成后按源码顺序合并
+class SemanticAnalyzer : public StaticVisitor<SemanticAnalyzer>
 {
 public:
     SymbolTable symbolTable;
     ErrorManager &errorManager; // 错误管理器
     EvalConstant evalConstant;  // 用于常量表达式求值
 
-    SemanticAnalyzer() : errorManager(ErrorManager::getInstance())
+    // 错误写入 errors，由调用者（编译过程）持有并输出
+    SemanticAnalyzer(StringInterner &interner, ErrorManager &errors)
+        : symbolTable(interner), errorManager(errors), interner(interner)
     {
     }
 
-    // 遍历编译单元
-    void visit(CompUnit &node) override;
+    // 多文件编译：在全局作用域登记其他编译单元定义的函数，须在遍历编译单元之前调用
+    // 符号引用原型（代码生成据此声明外部函数），prototypes 须存活至代码生成结束
+    void declareFunctions(llvm::ArrayRef<FunctionPrototype> prototypes);
+
+    // 分析编译单元；pool 非空时函数体在线程池中并行检查，诊断顺序与顺序检查相同
+    void analyze(CompUnit &node, ThreadPool *pool);
+
+    // 遍历编译单元（顺序检查）
+    void visit(CompUnit &node);
 
     // 声明相关
-    void visit(ConstDef &) override;
-    void visit(VarDef &node) override;
-    void visit(ConstDecl &node) override;
-    void visit(VarDecl &node) override;
-    void visit(BType &node) override;
-    void visit(InitVal &node) override;
-    void visit(ConstInitVal &node) override;
+    void visit(ConstDef &);
+    void visit(VarDef &node);
+    void visit(ConstDecl &node);
+    void visit(VarDecl &node);
+    void visit(BType &node);
+    void visit(InitVal &node);
+    void visit(ConstInitVal &node);
 
     // 函数及形参
-    void visit(FuncDef &node) override;
-    void visit(MainFuncDef &node) override;
-    void visit(FuncParam &node) override;
+    void visit(FuncDef &node);
+    void visit(MainFuncDef &node);
+    void visit(FuncParam &node);
 
     // 语句
-    void visit(ExpStmt &node) override;
-    void visit(Block &node) override;
-    void visit(BlockItem &node) override;
-    void visit(AssignStmt &node) override;
-    void visit(IfStmt &node) override;
-    void visit(WhileStmt &node) override;
-    void visit(ReturnStmt &node) override;
-    void visit(IOStmt &node) override;
+    void visit(ExpStmt &node);
+    void visit(Block &node);
+    void visit(BlockItem &node);
+    void visit(AssignStmt &node);
+    void visit(IfStmt &node);
+    void visit(WhileStmt &node);
+    void visit(ReturnStmt &node);
+    void visit(IOStmt &node);
 
     // 表达式
-    void visit(Number &node) override;
-    void visit(LVal &node) override;
-    void visit(PrimaryExp &node) override;
-    void visit(UnaryExp &node) override;
-    void visit(AddExp &node) override;
-    void visit(MulExp &node) override;
-    void visit(LOrExp &node) override;
-    void visit(LAndExp &node) override;
-    void visit(EqExp &node) override;
-    void visit(RelExp &node) override;
-    void visit(CallExp &node) override;
+    void visit(Number &node);
+    void visit(LVal &node);
+    void visit(PrimaryExp &node);
+    void visit(UnaryExp &node);
+    void visit(AddExp &node);
+    void visit(MulExp &node);
+    void visit(LOrExp &node);
+    void visit(LAndExp &node);
+    void visit(EqExp &node);
+    void visit(RelExp &node);
+    void visit(CallExp &node);
     void visit(FuncType &);
 
 private:
+    StringInterner &interner;
+    // 正在检查第几个函数体（main 排在全部函数之后），在此之后定义的函数视为未定义；签名阶段不限制
+    size_t currentFunction = SIZE_MAX;
+    // 检查函数体的分析器，各持有一张以 symbolTable 为外层的符号表，局部符号归其所有
+    std::vector<std::unique_ptr<SemanticAnalyzer>> bodyAnalyzers;
+    // 正在检查的实参本身是一个 LVal 时为该 LVal：数组可以不带满下标整体作为实参传递
+    const LVal *arrayArgument = nullptr;
+
+    // 函数体分析器：局部符号登记在自己的符号表中，错误写入 errors
+    SemanticAnalyzer(SemanticAnalyzer &global, ErrorManager &errors);
+
+    // 第一阶段：登记第 order 个函数的签名，错误写入 errors
+    void declareFunction(FuncDef &node, size_t order, ErrorManager &errors);
+    // 第二阶段：检查第 first 到 last - 1 个函数体；签名阶段的错误在各函数体的错误之前合并
+    void checkBodies(CompUnit &node, size_t first, size_t last, std::vector<ErrorManager> &signatureErrors);
+    // 按名字查找引用的符号，隐藏当前函数之后才定义的函数
+    Symbol *resolve(SymbolId id) const;
+
     int evaluateConstExp(ConstInitVal *initVal);
     int evaluateExp(Node *node);
-    bool checkAndEvaluateInitList(const std::vector<std::unique_ptr<InitVal>> &initList, const std::vector<int> &dimensions, size_t currentDim, EvalConstant &evaluator, std::vector<int> &evaluatedValues, ErrorManager &errorManager, const std::string &varName);
-    bool checkAndEvaluateConstInitList(const std::vector<std::unique_ptr<ConstInitVal>> &initList, const std::vector<int> &dimensions, size_t currentDim, EvalConstant &evaluator, std::vector<int> &evaluatedValues, ErrorManager &errorManager, const std::string &varName);
+    bool checkAndEvaluateInitList(const llvm::ArrayRef<InitVal *> &initList, const std::vector<int> &dimensions, size_t currentDim, EvalConstant &evaluator, std::vector<int> &evaluatedValues, ErrorManager &errorManager, std::string_view varName);
+    bool checkAndEvaluateConstInitList(const llvm::ArrayRef<ConstInitVal *> &initList, const std::vector<int> &dimensions, size_t currentDim, EvalConstant &evaluator, std::vector<int> &evaluatedValues, ErrorManager &errorManager, std::string_view varName);
 };
 
 #endif // SEMANTICANALYZER_H
\ No newline at end of file
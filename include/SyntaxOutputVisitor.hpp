@@ -1,25 +1,27 @@
 #ifndef SYNTAXOUTPUTVISITOR_HPP
 #define SYNTAXOUTPUTVISITOR_HPP
 #include "parser.h"
+#include "staticVisitor.h"
 #include <iostream>
 #include <memory>
 #include <unordered_set>
 
-class SyntaxOutputVisitor : public Visitor
+class SyntaxOutputVisitor : public StaticVisitor<SyntaxOutputVisitor>
 {
 public:
     explicit SyntaxOutputVisitor(std::ostream &os = std::cout) : os_(os) {}
 
     // 实现所有visit方法
     // 编译单元节点
-    void visit(CompUnit &node) override
+    void visit(CompUnit &node)
     {
         // 遍历全局声明和函数定义
         for (auto &decl : node.decls_)
-            decl->accept(*this);
+            visitNode(decl);
         for (auto &func : node.funcDefs_)
-            func->accept(*this);
-        node.mainfuncDef_->accept(*this);
+            visitNode(func);
+        if (node.mainfuncDef_)
+            visitNode(node.mainfuncDef_);
         outputNonTerminal("CompUnit");
     }
 
@@ -33,20 +35,20 @@ public:
         for (auto &dim : node.dimensions_)
         {
             std::cout << "[" << std::endl;
-            dim->accept(*this); // 解析ConstExp
+            visitAs(dim, Layer::AddExp); // 解析ConstExp
             std::cout << "]" << std::endl;
         }
 
         // 处理等号和初始化值
         std::cout << "ASSIGN =" << std::endl; // '='
 
-        node.initVal_->accept(*this); // 解析ConstInitVal
+        visitNode(node.initVal_); // 解析ConstInitVal
     }
-    void visit(ConstDecl &node) override
+    void visit(ConstDecl &node)
     {
         // 不输出Decl节点（根据文档要求过滤）
         for (auto &def : node.constDefs_)
-            def->accept(*this);
+            visitNode(def);
     }
     void visit(VarDef &node)
     {
@@ -55,23 +57,23 @@ public:
         for (auto &dim : node.constExps_)
         {
             std::cout << "[" << std::endl;
-            dim->accept(*this);
+            visitAs(dim, Layer::AddExp);
             std::cout << "]" << std::endl;
         }
         if (node.hasInit)
         {
             std::cout << "ASSIGN =" << std::endl;
-            node.initVal_->accept(*this);
+            visitNode(node.initVal_);
         }
         std::cout << "<VarDef>" << std::endl;
     }
     void visit(VarDecl &node)
     {
-        node.bType_->accept(*this);
+        visitNode(node.bType_);
         // 不输出Decl非终结符，遍历所有VarDef
         for (auto &def : node.varDefs_)
         {
-            def->accept(*this);
+            visitNode(def);
         }
 
         std::cout << "SEMICN ;" << std::endl;
@@ -88,7 +90,7 @@ public:
         std::cout << "LBRACE {" << std::endl; // 输出 '{'
         for (auto &item : node.items_)
         {
-            item->accept(*this); // 遍历BlockItem（自动过滤BlockItem标签）
+            visitNode(item); // 遍历BlockItem（自动过滤BlockItem标签）
         }
         std::cout << "RBRACE }" << std::endl; // 输出 '}'
         outputNonTerminal("Block");           // 输出 <Block>
@@ -96,9 +98,9 @@ public:
 
     void visit(AssignStmt &node)
     {
-        node.lval_->accept(*this);            // 输出左值（如 IDENFR a）
+        visitNode(node.lval_);            // 输出左值（如 IDENFR a）
         std::cout << "ASSIGN =" << std::endl; // 输出 '='
-        node.exp_->accept(*this);             // 输出右值表达式
+        visitAs(node.exp_, Layer::AddExp);    // 输出右值表达式
         outputNonTerminal("Exp");
         std::cout << "SEMICN ;" << std::endl; // 输出 ';'
         outputNonTerminal("Stmt");            // 输出 <Stmt>
@@ -108,15 +110,15 @@ public:
     {
         std::cout << "if" << std::endl; // 输出 'if'
         std::cout << "(" << std::endl;  // 输出 '('
-        node.cond_->accept(*this);      // 输出条件表达式
+        visitAs(node.cond_, Layer::LOrExp); // 输出条件表达式
         std::cout << ")" << std::endl;  // 输出 ')'
 
-        node.thenBranch_->accept(*this); // 输出 then 分支
+        visitNode(node.thenBranch_); // 输出 then 分支
 
         if (node.elseBranch_)
         {
             std::cout << "else" << std::endl; // 输出 'else'
-            node.elseBranch_->accept(*this);  // 输出 else 分支
+            visitNode(node.elseBranch_);  // 输出 else 分支
         }
         outputNonTerminal("Stmt"); // 输出 <Stmt>
     }
@@ -125,9 +127,9 @@ public:
     {
         std::cout << "while" << std::endl; // 输出 'while'
         std::cout << "(";                  // 输出 '('
-        node.cond_->accept(*this);         // 输出条件表达式
+        visitAs(node.cond_, Layer::LOrExp); // 输出条件表达式
         std::cout << ")" << std::endl;     // 输出 ')'
-        node.body_->accept(*this);         // 输出循环体
+        visitNode(node.body_);         // 输出循环体
         outputNonTerminal("Stmt");         // 输出 <Stmt>
     }
 
@@ -136,7 +138,7 @@ public:
         std::cout << "RETURN return" << std::endl; // 输出 'return'
         if (node.exp_)
         {
-            node.exp_->accept(*this); // 输出返回值表达式
+            visitAs(node.exp_, Layer::AddExp); // 输出返回值表达式
             outputNonTerminal("Exp");
         }
         std::cout << "SEMICN ;" << std::endl; // 输出 ';'
@@ -147,7 +149,7 @@ public:
     {
         if (node.kind == IOStmt::IOKind::Getint)
         {
-            node.target_->accept(*this); // 输出目标左值
+            visitNode(node.target_); // 输出目标左值
 
             std::cout << "ASSIGN =" << std::endl;
             std::cout << "GETINTTK getint" << std::endl;
@@ -167,7 +169,7 @@ public:
                 std::cout << "COMMA ," << std::endl;
                 for (size_t i = 0; i < node.args_.size(); ++i)
                 {
-                    node.args_[i]->accept(*this);
+                    visitAs(node.args_[i], Layer::AddExp);
                     outputNonTerminal("Exp");
                     if (i != node.args_.size() - 1)
                     {
@@ -189,7 +191,7 @@ public:
         for (auto &index : node.indices_)
         {
             std::cout << "[" << std::endl;
-            index->accept(*this); // 解析下标表达式
+            visitAs(index, Layer::AddExp); // 解析下标表达式
             std::cout << "]" << std::endl;
         }
         outputNonTerminal("LVal"); // 输出 <LVal>
@@ -198,7 +200,7 @@ public:
     void visit(UnaryExp &node)
     {
         // 逻辑与InitVal类似，但只能包含ConstExp
-        node.operand_->accept(*this);
+        visitAs(node.operand_, Layer::PrimaryExp);
         outputNonTerminal("UnaryExp");
     }
 
@@ -206,9 +208,9 @@ public:
     {
         for (auto &elem : node.elements_)
         {
-            if (auto ptr = std::get_if<std::unique_ptr<Exp>>(&elem))
+            if (auto ptr = std::get_if<Exp *>(&elem))
             {
-                (*ptr)->accept(*this); // 递归处理MulExp
+                visitAs(*ptr, Layer::MulExp); // 递归处理MulExp
             }
             else
             {
@@ -222,9 +224,9 @@ public:
     {
         for (auto &elem : node.elements_)
         {
-            if (auto ptr = std::get_if<std::unique_ptr<Exp>>(&elem))
+            if (auto ptr = std::get_if<Exp *>(&elem))
             {
-                (*ptr)->accept(*this); // 递归处理UnaryExp
+                visitAs(*ptr, Layer::UnaryExp); // 递归处理UnaryExp
             }
             else
             {
@@ -239,9 +241,9 @@ public:
     {
         for (auto &elem : node.elements_)
         {
-            if (auto ptr = std::get_if<std::unique_ptr<Exp>>(&elem))
+            if (auto ptr = std::get_if<Exp *>(&elem))
             {
-                (*ptr)->accept(*this); // 递归处理LAndExp
+                visitAs(*ptr, Layer::LAndExp); // 递归处理LAndExp
             }
             else
             {
@@ -255,9 +257,9 @@ public:
     {
         for (auto &elem : node.elements_)
         {
-            if (auto ptr = std::get_if<std::unique_ptr<Exp>>(&elem))
+            if (auto ptr = std::get_if<Exp *>(&elem))
             {
-                (*ptr)->accept(*this); // 递归处理EqExp
+                visitAs(*ptr, Layer::EqExp); // 递归处理EqExp
             }
             else
             {
@@ -271,9 +273,9 @@ public:
     {
         for (auto &elem : node.elements_)
         {
-            if (auto ptr = std::get_if<std::unique_ptr<Exp>>(&elem))
+            if (auto ptr = std::get_if<Exp *>(&elem))
             {
-                (*ptr)->accept(*this); // 递归处理RelExp
+                visitAs(*ptr, Layer::RelExp); // 递归处理RelExp
             }
             else
             {
@@ -288,9 +290,9 @@ public:
     {
         for (auto &elem : node.elements_)
         {
-            if (auto ptr = std::get_if<std::unique_ptr<Exp>>(&elem))
+            if (auto ptr = std::get_if<Exp *>(&elem))
             {
-                (*ptr)->accept(*this); // 递归处理AddExp
+                visitAs(*ptr, Layer::AddExp); // 递归处理AddExp
             }
             else
             {
@@ -310,7 +312,7 @@ public:
         // 解析参数列表
         for (size_t i = 0; i < node.args_.size(); ++i)
         {
-            node.args_[i]->accept(*this);
+            visitAs(node.args_[i], Layer::AddExp);
             if (i != node.args_.size() - 1)
             {
                 std::cout << ","; // 输出逗号分隔符
@@ -339,21 +341,21 @@ public:
             std::cout << "[";
             if (dim)
             {
-                dim->accept(*this); // 解析维度表达式（ConstExp）
+                visitAs(dim, Layer::AddExp); // 解析维度表达式（ConstExp）
             }
             std::cout << "]";
         }
         outputNonTerminal("FuncParam");
     }
 
-    void visit(FuncDef &node) override
+    void visit(FuncDef &node)
     {
         std::cout << node.name_;
         std::cout << "(" << std::endl;
         for (auto &param : node.params_)
-            param->accept(*this);
+            visitNode(param);
         std::cout << ")" << std::endl;
-        node.body_->accept(*this);
+        visitNode(node.body_);
         outputNonTerminal("FuncDef");
     }
 
@@ -363,7 +365,7 @@ public:
         std::cout << "MAINTK main" << std::endl;
         std::cout << "LPARENT (" << std::endl; // 输出 '('
         std::cout << "RPARENT )" << std::endl; // 输出 ')'
-        node.body_->accept(*this);             // 解析函数体（Block）
+        visitNode(node.body_);             // 解析函数体（Block）
         outputNonTerminal("MainFuncDef");      // 输出 <MainFuncDef>
     }
 
@@ -375,22 +377,22 @@ public:
     void visit(InitVal &node)
     {
 
-        if (std::holds_alternative<std::unique_ptr<AST::Exp>>(node.value_))
+        if (std::holds_alternative<AST::Exp *>(node.value_))
         {
-            auto *exp = std::get_if<std::unique_ptr<AST::Exp>>(&node.value_);
+            auto *exp = std::get_if<AST::Exp *>(&node.value_);
 
-            // auto exp = std::get<std::unique_ptr<AST::Exp>>(node.value_);
+            // auto exp = std::get<AST::Exp *>(node.value_);
             //  解析单个表达式
-            (*exp)->accept(*this);
+            visitAs(*exp, Layer::AddExp);
         }
         else
         {
-            auto *list = std::get_if<std::vector<std::unique_ptr<AST::InitVal>>>(&node.value_);
+            auto *list = std::get_if<llvm::ArrayRef<AST::InitVal *>>(&node.value_);
             std::cout << "{";
             for (size_t i = 0; i < (*list).size(); ++i)
             {
 
-                (*list)[i]->accept(*this); // 递归解析子初始化值
+                visitNode((*list)[i]); // 递归解析子初始化值
 
                 if (i != (*list).size() - 1)
                 {
@@ -406,20 +408,20 @@ public:
     void visit(ConstInitVal &node)
     {
         // 逻辑与InitVal类似，但只能包含ConstExp
-        if (std::holds_alternative<std::unique_ptr<AST::Exp>>(node.value_))
+        if (std::holds_alternative<AST::Exp *>(node.value_))
         {
-            auto *exp = std::get_if<std::unique_ptr<AST::Exp>>(&node.value_);
+            auto *exp = std::get_if<AST::Exp *>(&node.value_);
 
-            (*exp)->accept(*this);
+            visitAs(*exp, Layer::AddExp);
         }
         else
         {
-            auto *list = std::get_if<std::vector<std::unique_ptr<AST::ConstInitVal>>>(&node.value_);
+            auto *list = std::get_if<llvm::ArrayRef<AST::ConstInitVal *>>(&node.value_);
 
             std::cout << "(" << std::endl;
             for (size_t i = 0; i < (*list).size(); ++i)
             {
-                (*list)[i]->accept(*this);
+                visitNode((*list)[i]);
                 if (i != (*list).size() - 1)
                 {
                     std::cout << "," << std::endl;
@@ -433,29 +435,29 @@ public:
 
     void visit(BlockItem &node)
     {
-        node.item_->accept(*this);
+        visitNode(node.item_);
     }
 
     void visit(PrimaryExp &node)
     {
-        if (std::holds_alternative<std::unique_ptr<AST::Exp>>(node.operand_))
+        if (std::holds_alternative<AST::Exp *>(node.operand_))
         {
-            auto *exp = std::get_if<std::unique_ptr<AST::Exp>>(&node.operand_);
+            auto *exp = std::get_if<AST::Exp *>(&node.operand_);
 
-            (*exp)->accept(*this);
+            visitAs(*exp, Layer::AddExp);
             outputNonTerminal("Exp");
         }
-        else if (std::holds_alternative<std::unique_ptr<AST::LVal>>(node.operand_))
+        else if (std::holds_alternative<AST::LVal *>(node.operand_))
         {
-            auto *lVal = std::get_if<std::unique_ptr<AST::LVal>>(&node.operand_);
+            auto *lVal = std::get_if<AST::LVal *>(&node.operand_);
 
-            (*lVal)->accept(*this);
+            visitNode((*lVal));
         }
         else
         {
-            auto *num = std::get_if<std::unique_ptr<AST::Number>>(&node.operand_);
+            auto *num = std::get_if<AST::Number *>(&node.operand_);
 
-            (*num)->accept(*this);
+            visitNode((*num));
         }
 
         outputNonTerminal("PrimaryExp");
@@ -468,6 +470,58 @@ public:
     }
 
 private:
+    // 表达式所处的文法层，由低到高；Atom 为 LVal、Number 等 PrimaryExp 的子节点
+    enum class Layer
+    {
+        Atom,
+        PrimaryExp,
+        UnaryExp,
+        MulExp,
+        AddExp,
+        RelExp,
+        EqExp,
+        LAndExp,
+        LOrExp
+    };
+
+    static Layer layerOf(const Exp &exp)
+    {
+        switch (exp.getKind())
+        {
+        case Node::ND_PrimaryExp:
+        case Node::ND_CallExp:
+            return Layer::PrimaryExp;
+        case Node::ND_UnaryExp:
+            return Layer::UnaryExp;
+        case Node::ND_MulExp:
+            return Layer::MulExp;
+        case Node::ND_AddExp:
+            return Layer::AddExp;
+        case Node::ND_RelExp:
+            return Layer::RelExp;
+        case Node::ND_EqExp:
+            return Layer::EqExp;
+        case Node::ND_LAndExp:
+            return Layer::LAndExp;
+        case Node::ND_LOrExp:
+            return Layer::LOrExp;
+        default:
+            return Layer::Atom;
+        }
+    }
+
+    // 解析器不为只有一个操作数的层建节点，输出时按文法位置补齐这些层的非终结符
+    void visitAs(Exp *exp, Layer layer)
+    {
+        static const char *const names[] = {"", "PrimaryExp", "UnaryExp", "MulExp", "AddExp",
+                                            "RelExp", "EqExp", "LAndExp", "LOrExp"};
+        visitNode(exp);
+        for (int l = static_cast<int>(layerOf(*exp)) + 1; l <= static_cast<int>(layer); ++l)
+        {
+            outputNonTerminal(names[l]);
+        }
+    }
+
     std::ostream &os_;
     const std::unordered_set<std::string> skipped_rules_ = {"BlockItem", "Decl", "BType"};
 
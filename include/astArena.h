@@ -0,0 +1,97 @@
+#ifndef ASTARENA_H
+#define ASTARENA_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Allocator.h"
+#include <memory>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace AST
+{
+    // AST 节点的线性（bump）分配区
+    // 由一次编译持有：Parser 把所有节点和子节点数组都分配在这里，节点之间以普通指针相连，不表示所有权。
+    // 节点的析构函数不会被调用，整棵树随 AstArena 按块一次释放，因此节点成员不能持有堆内存
+    // （名字、类型名等字符串都是指向源码缓冲区的 string_view，子节点列表是 arena 中的数组；
+    // 从缓存重建的树没有源码缓冲区，字符串改为指向驻留表或本 arena 的副本）。
+    class AstArena
+    {
+    public:
+        AstArena() = default;
+        AstArena(const AstArena &) = delete;
+        AstArena &operator=(const AstArena &) = delete;
+
+        template <typename T, typename... Args>
+        T *make(Args &&...args)
+        {
+            ++nodeCount_;
+            return new (allocator_.Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        }
+
+        // 把解析时临时收集的子节点列表复制到 arena 中
+        template <typename T>
+        llvm::ArrayRef<T> copy(llvm::ArrayRef<T> items)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "arena 数组元素不会被析构");
+            if (items.empty())
+            {
+                return llvm::ArrayRef<T>();
+            }
+            T *data = allocator_.Allocate<T>(items.size());
+            std::uninitialized_copy(items.begin(), items.end(), data);
+            return llvm::ArrayRef<T>(data, items.size());
+        }
+
+        template <typename T>
+        llvm::ArrayRef<T> copy(const llvm::SmallVectorImpl<T> &items)
+        {
+            return copy(llvm::ArrayRef<T>(items));
+        }
+
+        // 把字符串复制到 arena 中，返回的视图随 arena 一起释放
+        std::string_view copy(std::string_view text)
+        {
+            llvm::ArrayRef<char> chars = copy(llvm::ArrayRef<char>(text.data(), text.size()));
+            return std::string_view(chars.data(), chars.size());
+        }
+
+        // 派生一个子 arena，供并行解析的一个任务独占使用；子 arena 由本 arena 持有并随其释放。
+        // fork() 本身不是线程安全的，应在分派任务之前由持有者线程调用
+        AstArena &fork()
+        {
+            forks_.push_back(std::make_unique<AstArena>());
+            return *forks_.back();
+        }
+
+        // 均包含派生出的子 arena
+        size_t nodeCount() const
+        {
+            size_t count = nodeCount_;
+            for (const auto &child : forks_)
+            {
+                count += child->nodeCount();
+            }
+            return count;
+        }
+        size_t bytesAllocated() const
+        {
+            size_t bytes = allocator_.getBytesAllocated();
+            for (const auto &child : forks_)
+            {
+                bytes += child->bytesAllocated();
+            }
+            return bytes;
+        }
+
+    private:
+        llvm::BumpPtrAllocator allocator_;
+        size_t nodeCount_ = 0;
+        std::vector<std::unique_ptr<AstArena>> forks_;
+    };
+}
+
+#endif // ASTARENA_H
@@ -0,0 +1,36 @@
+#ifndef ASTCACHE_H
+#define ASTCACHE_H
+
+#include "flatAst.h"
+#include <cstdint>
+#include <string>
+
+// 语法树的二进制缓存
+// 源码未变时直接读回上次解析得到的语法树，同时跳过词法分析与语法分析。
+// 文件内容是语法树的 FlatAst 编码，以源码的 xxHash64 命名；文件格式（本机字节序）：
+//   头部     magic "CCLA" | version u32 | 源码哈希 u64 | 源码长度 u64 | 节点数 u32 | 标识符数 u32 | 格式串数 u32 | 保留 u32
+//   节点     FlatNode × 节点数
+//   标识符   (长度 u32 + 字节) × 标识符数，按驻留编号 1, 2, ... 的顺序
+//   格式串   (长度 u32 + 字节) × 格式串数
+// 读回时按编号顺序重新驻留标识符，再把节点中的编号换成新编号，在调用者的 arena 中重建指针树。
+// 只缓存语法分析的结果，语义分析仍在每次编译时进行。
+class AstCache
+{
+public:
+    // 格式、FlatAst 编码或语法规则变化时递增，旧版本的缓存文件会被视为未命中
+    static constexpr uint32_t kVersion = 1;
+
+    explicit AstCache(std::string directory);
+
+    std::string pathFor(std::string_view source) const;
+    // 命中时在 arena 中重建语法树并返回根节点，未命中或文件损坏时返回 nullptr。
+    // 重建的树中名字指向 interner，格式串复制到 arena，不引用 source
+    AST::CompUnit *load(std::string_view source, AST::AstArena &arena, StringInterner &interner) const;
+    // 保存 program 的扁平编码，先写临时文件再改名
+    bool store(std::string_view source, AST::CompUnit &program, const StringInterner &interner) const;
+
+private:
+    std::string directory_;
+};
+
+#endif // ASTCACHE_H
@@ -2,21 +2,25 @@
 #ifndef SYSY_ASTSYSY_H
 #define SYSY_ASTSYSY_H
 
-#include <memory>
+#include "astArena.h"
 #include "lexer.h"
-#include <vector>
+#include "llvm/Support/Casting.h"
 #include <variant>
 
+class Symbol; // symbolTable.h
+
 namespace AST
 {
     // 前向声明访问者类
     class Visitor;
 
     // AST节点基类
+    // 具体类型由 kind_ 标识：各类的 classof 配合 llvm::isa/cast/dyn_cast 使用，遍历整棵树用 StaticVisitor（见 staticVisitor.h），
+    // 均不依赖 RTTI。Exp 与 Stmt 的子类种类连续排列（见 Exp::classof、Stmt::classof），新增种类时需保持。
     class Node
     {
     public:
-        enum Kind
+        enum Kind : uint8_t // 单字节，Exp 的折叠结果可放进 Node 的尾部填充
         {
             ND_Decl,
             ND_Exp,
@@ -60,6 +64,7 @@ namespace AST
             return kind_;
         }
 
+        // 节点分配在 AstArena 中，析构函数不会被调用
         virtual ~Node() = default;
         virtual void accept(Visitor &visitor) = 0;
     };
@@ -69,6 +74,31 @@ namespace AST
     {
     public:
         Decl(Kind kind) : Node(kind) {}
+        static bool classof(const Node *node)
+        {
+            return node->getKind() == ND_ConstDecl || node->getKind() == ND_VarDecl;
+        }
+    };
+
+    // 语义分析为表达式标注的类型，占一个字节：
+    //   Int      int 值；
+    //   Array    数组或数组的一部分（如二维数组只取一维下标），rank_ 为剩余维数，
+    //            各维长度为所引用数组符号 dimensions_ 的最后 rank_ 个；
+    //   Pointer  数组形参本身，即退化为指向首元素的指针，首维长度未知，rank_ 为形参的维数
+    // 未定义的名字等无法确定类型时为 Unknown
+    struct ExpType
+    {
+        enum Kind : uint8_t
+        {
+            Unknown,
+            Int,
+            Array,
+            Pointer
+        };
+        Kind kind_ : 2;
+        uint8_t rank_ : 6;
+
+        ExpType(Kind kind = Unknown, uint8_t rank = 0) : kind_(kind), rank_(rank) {}
     };
 
     // 表达式基类
@@ -76,6 +106,21 @@ namespace AST
     {
     public:
         Exp(Kind kind) : Node(kind) {}
+        static bool classof(const Node *node)
+        {
+            return node->getKind() >= ND_LVal && node->getKind() <= ND_Number;
+        }
+
+        // 常量折叠的标注：EvalConstant 第一次成功求值本子树且子树为常量（不含变量引用与函数调用）时写入，
+        // 之后的求值直接返回 foldedValue_，不再遍历子树。语义分析对维度、初始化值等求值时即完成标注，代码生成读取标注。
+        // 求值失败（如除零）或子树不是常量时不标注，再次求值会再次遍历
+        bool folded_ = false;
+        // 语义分析的类型标注，与 folded_ 一起放在 foldedValue_ 之前的填充字节中，Exp 仍为 16 字节。
+        // isLValue_ 为真时代码生成得到的是 int 对象的地址，取值时须加载；
+        // 只有一个操作数的表达式层（如未折叠的单项 AddExp）沿用操作数的标注
+        ExpType type_;
+        bool isLValue_ = false;
+        int foldedValue_ = 0;
     };
 
     // 语句基类
@@ -83,6 +128,10 @@ namespace AST
     {
     public:
         Stmt(Kind kind) : Node(kind) {}
+        static bool classof(const Node *node)
+        {
+            return (node->getKind() >= ND_ExpStmt && node->getKind() <= ND_IOStmt) || node->getKind() == ND_Block;
+        }
     };
 
     // 声明节点
@@ -184,10 +233,11 @@ namespace AST
     {
     public:
         CompUnit() : Node(ND_CompUnit) {}
+        static bool classof(const Node *node) { return node->getKind() == ND_CompUnit; }
 
-        std::vector<std::unique_ptr<Decl>> decls_;       // 全局声明（变量/常量）
-        std::vector<std::unique_ptr<FuncDef>> funcDefs_; // 函数定义
-        std::unique_ptr<MainFuncDef> mainfuncDef_;       // 主函数
+        llvm::ArrayRef<Decl *> decls_;       // 全局声明（变量/常量）
+        llvm::ArrayRef<FuncDef *> funcDefs_; // 函数定义
+        MainFuncDef *mainfuncDef_ = nullptr;       // 主函数
 
         void accept(Visitor &v) override
         {
@@ -201,9 +251,10 @@ namespace AST
     {
     public:
         ConstDecl() : Decl(ND_ConstDecl) {}
+        static bool classof(const Node *node) { return node->getKind() == ND_ConstDecl; }
 
-        std::unique_ptr<BType> bType_;
-        std::vector<std::unique_ptr<ConstDef>> constDefs_;
+        BType *bType_ = nullptr;
+        llvm::ArrayRef<ConstDef *> constDefs_;
 
         void accept(Visitor &v) override
         {
@@ -216,10 +267,13 @@ namespace AST
     {
     public:
         ConstDef() : Node(ND_ConstDef) {}
-        std::string name_;
-        std::vector<std::unique_ptr<Exp>> dimensions_;
-        std::unique_ptr<ConstInitVal> initVal_;
+        static bool classof(const Node *node) { return node->getKind() == ND_ConstDef; }
+        std::string_view name_; // 指向源码缓冲区
+        SymbolId nameId_ = kNoSymbol;
+        llvm::ArrayRef<Exp *> dimensions_;
+        ConstInitVal *initVal_ = nullptr;
         bool hasInit = false;
+        Symbol *symbol_ = nullptr; // 语义分析为本定义登记的符号，重复定义时为空
 
         void accept(Visitor &v) override
         {
@@ -232,8 +286,9 @@ namespace AST
     {
     public:
         VarDecl() : Decl(ND_VarDecl) {}
-        std::unique_ptr<BType> bType_;
-        std::vector<std::unique_ptr<VarDef>> varDefs_;
+        static bool classof(const Node *node) { return node->getKind() == ND_VarDecl; }
+        BType *bType_ = nullptr;
+        llvm::ArrayRef<VarDef *> varDefs_;
 
         void accept(Visitor &v) override
         {
@@ -245,7 +300,8 @@ namespace AST
     {
     public:
         BType() : Node(ND_BType) {}
-        std::string typeName_{"int"};
+        static bool classof(const Node *node) { return node->getKind() == ND_BType; }
+        std::string_view typeName_{"int"};
 
         void accept(Visitor &v) override
         {
@@ -258,10 +314,13 @@ namespace AST
     {
     public:
         VarDef() : Node(ND_VarDef) {}
-        std::string name_;
-        std::vector<std::unique_ptr<Exp>> constExps_;
-        std::unique_ptr<InitVal> initVal_; // 可为空
+        static bool classof(const Node *node) { return node->getKind() == ND_VarDef; }
+        std::string_view name_; // 指向源码缓冲区
+        SymbolId nameId_ = kNoSymbol;
+        llvm::ArrayRef<Exp *> constExps_;
+        InitVal *initVal_ = nullptr; // 可为空
         bool hasInit = false;
+        Symbol *symbol_ = nullptr; // 语义分析为本定义登记的符号，重复定义时为空
 
         void accept(Visitor &v) override
         {
@@ -275,10 +334,13 @@ namespace AST
     {
     public:
         FuncParam() : Node(ND_FuncParam) {}
-        std::unique_ptr<BType> bType_;
-        std::string name_;
-        std::vector<std::unique_ptr<Exp>> dimSizes_; // 数组维度（第一维可缺）Exp指向 BinaryAdd
+        static bool classof(const Node *node) { return node->getKind() == ND_FuncParam; }
+        BType *bType_ = nullptr;
+        std::string_view name_; // 指向源码缓冲区
+        SymbolId nameId_ = kNoSymbol;
+        llvm::ArrayRef<Exp *> dimSizes_; // 数组维度（第一维可缺）Exp指向 BinaryAdd
         bool isArray_;
+        Symbol *symbol_ = nullptr; // 语义分析为本形参登记的符号，重复定义时为空
 
         void accept(Visitor &v) override
         {
@@ -291,7 +353,8 @@ namespace AST
     {
     public:
         MainFuncDef() : Node(ND_MainFuncDef) {}
-        std::unique_ptr<Block> body_;
+        static bool classof(const Node *node) { return node->getKind() == ND_MainFuncDef; }
+        Block *body_ = nullptr;
 
         void accept(Visitor &v) override
         {
@@ -304,10 +367,13 @@ namespace AST
     {
     public:
         FuncDef() : Node(ND_FuncDef) {}
-        std::unique_ptr<FuncType> returnType_; //"int" 或 "void"
-        std::string name_;
-        std::vector<std::unique_ptr<FuncParam>> params_;
-        std::unique_ptr<Block> body_;
+        static bool classof(const Node *node) { return node->getKind() == ND_FuncDef; }
+        FuncType *returnType_ = nullptr; //"int" 或 "void"
+        std::string_view name_; // 指向源码缓冲区
+        SymbolId nameId_ = kNoSymbol;
+        llvm::ArrayRef<FuncParam *> params_;
+        Block *body_ = nullptr;
+        Symbol *symbol_ = nullptr; // 语义分析为本函数登记的符号，重复定义时为空
 
         void accept(Visitor &v) override
         {
@@ -321,7 +387,8 @@ namespace AST
     {
     public:
         ExpStmt() : Stmt(ND_ExpStmt) {}
-        std::unique_ptr<Exp> exp_;
+        static bool classof(const Node *node) { return node->getKind() == ND_ExpStmt; }
+        Exp *exp_ = nullptr;
 
         void accept(Visitor &v) override
         {
@@ -333,7 +400,8 @@ namespace AST
     {
     public:
         Block() : Stmt(ND_Block) {}
-        std::vector<std::unique_ptr<BlockItem>> items_;
+        static bool classof(const Node *node) { return node->getKind() == ND_Block; }
+        llvm::ArrayRef<BlockItem *> items_;
 
         void accept(Visitor &v) override
         {
@@ -346,7 +414,8 @@ namespace AST
     {
     public:
         BlockItem() : Node(ND_BlockItem) {}
-        std::unique_ptr<Node> item_; // Decl Or Stmt
+        static bool classof(const Node *node) { return node->getKind() == ND_BlockItem; }
+        Node *item_ = nullptr; // Decl Or Stmt
 
         void accept(Visitor &v) override
         {
@@ -359,8 +428,9 @@ namespace AST
     {
     public:
         AssignStmt() : Stmt(ND_AssignStmt) {}
-        std::unique_ptr<LVal> lval_;
-        std::unique_ptr<Exp> exp_;
+        static bool classof(const Node *node) { return node->getKind() == ND_AssignStmt; }
+        LVal *lval_ = nullptr;
+        Exp *exp_ = nullptr;
 
         void accept(Visitor &v) override
         {
@@ -373,9 +443,10 @@ namespace AST
     {
     public:
         IfStmt() : Stmt(ND_IfStmt) {}
-        std::unique_ptr<LOrExp> cond_;
-        std::unique_ptr<Stmt> thenBranch_;
-        std::unique_ptr<Stmt> elseBranch_; // 可为null
+        static bool classof(const Node *node) { return node->getKind() == ND_IfStmt; }
+        Exp *cond_ = nullptr; // Cond，只有一个操作数时不带 LOrExp/LAndExp 层
+        Stmt *thenBranch_ = nullptr;
+        Stmt *elseBranch_ = nullptr; // 可为null
 
         void accept(Visitor &v) override
         {
@@ -388,8 +459,9 @@ namespace AST
     {
     public:
         WhileStmt() : Stmt(ND_WhileStmt) {}
-        std::unique_ptr<LOrExp> cond_;
-        std::unique_ptr<Stmt> body_;
+        static bool classof(const Node *node) { return node->getKind() == ND_WhileStmt; }
+        Exp *cond_ = nullptr; // 同 IfStmt::cond_
+        Stmt *body_ = nullptr;
 
         void accept(Visitor &v) override
         {
@@ -402,7 +474,8 @@ namespace AST
     {
     public:
         ReturnStmt() : Stmt(ND_ReturnStmt) {}
-        std::unique_ptr<Exp> exp_; // 可为null
+        static bool classof(const Node *node) { return node->getKind() == ND_ReturnStmt; }
+        Exp *exp_ = nullptr; // 可为null
 
         void accept(Visitor &v) override
         {
@@ -415,15 +488,16 @@ namespace AST
     {
     public:
         IOStmt() : Stmt(ND_IOStmt) {}
+        static bool classof(const Node *node) { return node->getKind() == ND_IOStmt; }
         enum class IOKind
         {
             Getint,
             Printf
         };
         IOKind kind;
-        std::unique_ptr<LVal> target_;           // getint时使用
-        std::string formatString_;               // printf时使用
-        std::vector<std::unique_ptr<Exp>> args_; // printf的参数
+        LVal *target_ = nullptr;           // getint时使用
+        std::string_view formatString_;          // printf时使用（含引号，指向源码缓冲区）
+        llvm::ArrayRef<Exp *> args_; // printf的参数
 
         void accept(Visitor &v) override
         {
@@ -438,8 +512,11 @@ namespace AST
     {
     public:
         LVal() : Exp(ND_LVal) {}
-        std::string name_;
-        std::vector<std::unique_ptr<Exp>> indices_; // 数组下标（可为空）
+        static bool classof(const Node *node) { return node->getKind() == ND_LVal; }
+        std::string_view name_; // 指向源码缓冲区
+        SymbolId nameId_ = kNoSymbol;
+        llvm::ArrayRef<Exp *> indices_; // 数组下标（可为空）
+        Symbol *symbol_ = nullptr;      // 语义分析解析到的符号，未定义时为空
 
         void accept(Visitor &v) override
         {
@@ -451,7 +528,8 @@ namespace AST
     {
     public:
         PrimaryExp() : Exp(ND_PrimaryExp) {}
-        std::variant<std::unique_ptr<Exp>, std::unique_ptr<LVal>, std::unique_ptr<Number>> operand_;
+        static bool classof(const Node *node) { return node->getKind() == ND_PrimaryExp; }
+        std::variant<Exp *, LVal *, Number *> operand_;
 
         void accept(Visitor &v) override
         {
@@ -464,6 +542,7 @@ namespace AST
     {
     public:
         UnaryExp() : Exp(ND_UnaryExp) {}
+        static bool classof(const Node *node) { return node->getKind() == ND_UnaryExp; }
         enum class Op
         {
             Plus,
@@ -472,7 +551,7 @@ namespace AST
             Init
         };
         Op op = Op::Init;
-        std::unique_ptr<Exp> operand_; // 可能是函数调用或一元表达式
+        Exp *operand_ = nullptr; // 可能是函数调用或一元表达式
 
         void accept(Visitor &v) override
         {
@@ -485,7 +564,8 @@ namespace AST
     {
     public:
         AddExp() : Exp(ND_AddExp) {}
-        std::vector<std::variant<std::unique_ptr<Exp>, TokenType>> elements_;
+        static bool classof(const Node *node) { return node->getKind() == ND_AddExp; }
+        llvm::ArrayRef<std::variant<Exp *, TokenType>> elements_;
 
         void accept(Visitor &v) override { v.visit(*this); }
     };
@@ -495,7 +575,8 @@ namespace AST
     {
     public:
         MulExp() : Exp(ND_MulExp) {}
-        std::vector<std::variant<std::unique_ptr<Exp>, TokenType>> elements_;
+        static bool classof(const Node *node) { return node->getKind() == ND_MulExp; }
+        llvm::ArrayRef<std::variant<Exp *, TokenType>> elements_;
 
         void accept(Visitor &v) override { v.visit(*this); }
     };
@@ -504,7 +585,8 @@ namespace AST
     {
     public:
         LOrExp() : Exp(ND_LOrExp) {}
-        std::vector<std::variant<std::unique_ptr<Exp>, TokenType>> elements_;
+        static bool classof(const Node *node) { return node->getKind() == ND_LOrExp; }
+        llvm::ArrayRef<std::variant<Exp *, TokenType>> elements_;
 
         void accept(Visitor &v) override { v.visit(*this); }
     };
@@ -513,7 +595,8 @@ namespace AST
     {
     public:
         LAndExp() : Exp(ND_LAndExp) {}
-        std::vector<std::variant<std::unique_ptr<Exp>, TokenType>> elements_;
+        static bool classof(const Node *node) { return node->getKind() == ND_LAndExp; }
+        llvm::ArrayRef<std::variant<Exp *, TokenType>> elements_;
 
         void accept(Visitor &v) override { v.visit(*this); }
     };
@@ -522,7 +605,8 @@ namespace AST
     {
     public:
         EqExp() : Exp(ND_EqExp) {}
-        std::vector<std::variant<std::unique_ptr<Exp>, TokenType>> elements_;
+        static bool classof(const Node *node) { return node->getKind() == ND_EqExp; }
+        llvm::ArrayRef<std::variant<Exp *, TokenType>> elements_;
 
         void accept(Visitor &v) override { v.visit(*this); }
     };
@@ -531,7 +615,8 @@ namespace AST
     {
     public:
         RelExp() : Exp(ND_RelExp) {}
-        std::vector<std::variant<std::unique_ptr<Exp>, TokenType>> elements_;
+        static bool classof(const Node *node) { return node->getKind() == ND_RelExp; }
+        llvm::ArrayRef<std::variant<Exp *, TokenType>> elements_;
 
         void accept(Visitor &v) override { v.visit(*this); }
     };
@@ -541,8 +626,11 @@ namespace AST
     {
     public:
         CallExp() : Exp(ND_CallExp) {}
-        std::string funcName;
-        std::vector<std::unique_ptr<Exp>> args_;
+        static bool classof(const Node *node) { return node->getKind() == ND_CallExp; }
+        std::string_view funcName;
+        SymbolId funcId_ = kNoSymbol;
+        llvm::ArrayRef<Exp *> args_;
+        Symbol *symbol_ = nullptr; // 语义分析解析到的符号，未定义时为空
 
         void accept(Visitor &v) override
         {
@@ -555,6 +643,7 @@ namespace AST
     {
     public:
         Number() : Exp(ND_Number) {}
+        static bool classof(const Node *node) { return node->getKind() == ND_Number; }
         int value_;
 
         void accept(Visitor &v) override
@@ -569,7 +658,8 @@ namespace AST
     {
     public:
         FuncType() : Node(ND_FuncType) {}
-        std::string typeName_;
+        static bool classof(const Node *node) { return node->getKind() == ND_FuncType; }
+        std::string_view typeName_; // 指向源码缓冲区
 
         void accept(Visitor &v) override
         {
@@ -581,7 +671,8 @@ namespace AST
     {
     public:
         ConstInitVal() : Node(ND_ConstInitVal) {}
-        std::variant<std::unique_ptr<Exp>, std::vector<std::unique_ptr<ConstInitVal>>> value_;
+        static bool classof(const Node *node) { return node->getKind() == ND_ConstInitVal; }
+        std::variant<Exp *, llvm::ArrayRef<ConstInitVal *>> value_;
 
         void accept(Visitor &v) override
         {
@@ -594,7 +685,8 @@ namespace AST
     {
     public:
         InitVal() : Node(ND_InitVal) {}
-        std::variant<std::unique_ptr<Exp>, std::vector<std::unique_ptr<InitVal>>> value_;
+        static bool classof(const Node *node) { return node->getKind() == ND_InitVal; }
+        std::variant<Exp *, llvm::ArrayRef<InitVal *>> value_;
 
         void accept(Visitor &v) override
         {
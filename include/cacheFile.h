@@ -0,0 +1,110 @@
+#ifndef CACHEFILE_H
+#define CACHEFILE_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/raw_ostream.h"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 编译缓存文件（TokenCache、AstCache）共用的读写工具
+// 缓存文件以源码的 xxHash64 命名，内容按本机字节序直接写出，只供同一台机器上的后续编译读回。
+namespace cachefile
+{
+    // 缓存目录下以源码哈希命名的文件路径，extension 含点号（如 ".tok"）
+    std::string pathFor(std::string_view directory, std::string_view source, std::string_view extension);
+
+    uint64_t hash(std::string_view source);
+
+    // 创建目录后先写临时文件再改名，避免并发编译读到半个文件；任一步失败时返回 false
+    bool writeAtomically(const std::string &directory, const std::string &path,
+                         llvm::function_ref<void(llvm::raw_ostream &)> write);
+
+    template <typename T>
+    void writeArray(llvm::raw_ostream &os, llvm::ArrayRef<T> values)
+    {
+        os.write(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+    }
+
+    template <typename T>
+    void writeValue(llvm::raw_ostream &os, const T &value)
+    {
+        os.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    // 长度 u32 + 字节
+    void writeString(llvm::raw_ostream &os, std::string_view text);
+
+    // 顺序读取缓存内容，越界时置 failed_ 且不再前进
+    class Reader
+    {
+    public:
+        explicit Reader(llvm::StringRef data) : data_(data), failed_(false) {}
+
+        template <typename T>
+        void readArray(std::vector<T> &values, size_t count)
+        {
+            // 先按剩余长度校验，损坏的计数不能触发巨大的分配
+            if (failed_ || count > data_.size() / sizeof(T))
+            {
+                failed_ = true;
+                return;
+            }
+            values.resize(count);
+            read(values.data(), count * sizeof(T));
+        }
+
+        void read(void *out, size_t size)
+        {
+            if (failed_ || size > data_.size())
+            {
+                failed_ = true;
+                return;
+            }
+            std::memcpy(out, data_.data(), size);
+            data_ = data_.drop_front(size);
+        }
+
+        llvm::StringRef take(size_t size)
+        {
+            if (failed_ || size > data_.size())
+            {
+                failed_ = true;
+                return llvm::StringRef();
+            }
+            llvm::StringRef result = data_.take_front(size);
+            data_ = data_.drop_front(size);
+            return result;
+        }
+
+        // 读取 writeString 写出的字符串，视图指向被读取的缓冲区
+        std::string_view readString()
+        {
+            uint32_t length = 0;
+            read(&length, sizeof(length));
+            llvm::StringRef text = take(length);
+            return std::string_view(text.data(), text.size());
+        }
+
+        bool failed() const
+        {
+            return failed_;
+        }
+
+        // 读取完毕且恰好用完全部内容
+        bool complete() const
+        {
+            return !failed_ && data_.empty();
+        }
+
+    private:
+        llvm::StringRef data_;
+        bool failed_;
+    };
+}
+
+#endif // CACHEFILE_H
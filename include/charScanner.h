@@ -0,0 +1,33 @@
+#ifndef CHARSCANNER_H
+#define CHARSCANNER_H
+
+#include <cstddef>
+#include <string_view>
+
+// 词法分析用的按块字符扫描
+// 一次比较 16（SSE2）或 32（AVX2）个字节，得到位掩码后用 ctz 定位；扫描不统计行号，需要时由调用方按偏移换算。
+// 运行时按 CPU 能力选择实现，非 x86 平台使用逐字节的标量实现
+namespace CharScanner
+{
+    enum class Isa
+    {
+        Scalar,
+        Sse2,
+        Avx2
+    };
+
+    // 从 pos 开始跳过空白字符（与 isspace 一致），返回第一个非空白字符的位置
+    size_t skipWhitespace(std::string_view text, size_t pos);
+    // 返回从 pos 开始的第一个 '\n' 的位置，不存在时返回 text.size()
+    size_t findLineEnd(std::string_view text, size_t pos);
+    // 返回从 pos 开始的第一个 "*/" 中 '*' 的位置，不存在时返回 text.size()
+    size_t findCommentEnd(std::string_view text, size_t pos);
+
+    // 当前使用的实现
+    Isa activeIsa();
+    // 强制使用指定实现（用于测试与基准），CPU 不支持时返回 false 且不做修改
+    bool useIsa(Isa isa);
+    const char *isaName(Isa isa);
+}
+
+#endif // CHARSCANNER_H
@@ -4,8 +4,10 @@
 #include <memory>
 #include <vector>
 #include "astSysy.h"
+#include "staticVisitor.h"
 #include "symbolTable.h"
 #include "evalConstant.h"
+#include "functionPrototype.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/IRBuilder.h"
@@ -29,7 +31,7 @@ using namespace llvm;
 // source -> llvm ir -> run -> output
 // .ll -> module -> {function, global variable, type, constant} -> {basic block, instruction} -> {value, type}
 
-class CodeGenerator : public AST::Visitor
+class CodeGenerator : public AST::StaticVisitor<CodeGenerator>
 {
 public:
     // 初始化/清理
@@ -38,6 +40,9 @@ public:
 
     void emitMIPSAssembly(const std::string &outputFilename);
     void emitIRToFile(const std::string &outputFilename);
+    // 输出任意模块（如多文件编译链接后的模块）
+    static void emitMIPSAssembly(llvm::Module &module, const std::string &outputFilename);
+    static void emitIRToFile(llvm::Module &module, const std::string &outputFilename);
 
     // 主入口
     void generateCode(AST::CompUnit &compUnit);
@@ -45,7 +50,7 @@ public:
     // 获取生成的模块
     std::unique_ptr<llvm::Module> getModule() { return std::move(module_); }
 
-    // Visitor模式接口
+    // 访问者接口（StaticVisitor 按节点种类静态分派）
     // 编译单元节点
     void visit(CompUnit &node);
 
@@ -96,31 +101,30 @@ private:
     llvm::Function *currentFunc_ = nullptr;
 
 private:
-    void AddLocalVarToMap(llvm::Value *addr, llvm::Type *ty, llvm::StringRef name);
-    void AddGlobalVarToMap(llvm::Value *addr, llvm::Type *ty, llvm::StringRef name);
-    std::pair<llvm::Value *, llvm::Type *> GetVarByName(llvm::StringRef name);
-
-    void PushScope();
-    void PopScope();
-    void ClearVarScope();
-
-    llvm::Value *loadIfPointer(llvm::Value *v);
+    // 名字解析由语义分析完成（见 LVal::symbol_ 等）：定义处把存储写入符号，引用处从符号读取
+    void bindStorage(Symbol *symbol, llvm::Value *storage);
+    // 调用的目标函数；其他编译单元的函数按原型在此声明
+    llvm::Function *calleeOf(CallExp &node);
+    llvm::Function *declareFunction(const FunctionPrototype &prototype);
+
+    // 语义分析把 exp 标注为左值时 v 是 int 的地址，加载其值；否则 v 已是值
+    llvm::Value *loadIfLValue(Exp *exp, llvm::Value *v);
+    // 各维长度为 dims 的 int 数组类型，dims 为空时为 int
+    llvm::Type *arrayType(llvm::ArrayRef<int> dims);
+    // 数组形参的类型：指向去掉首维后的数组的指针
+    llvm::Type *arrayParamType(llvm::ArrayRef<int> innerDims);
+
+    // 条件表达式：补上被折叠的单操作数 LOrExp/LAndExp 层的 "!= 0" 归一化
+    void emitTruthValue(const std::string &name);
+    void emitLAndOperand(Exp *exp);
+    void emitCondition(Exp *exp);
 
 private:
-    // 符号表
-    llvm::SmallVector<llvm::StringMap<std::pair<llvm::Value *, llvm::Type *>>> localVarMap;
-    llvm::StringMap<std::pair<llvm::Value *, llvm::Type *>> globalVarMap;
-
     llvm::Value *currentValue_ = nullptr;
 
     Function *createGetintFunction(Module *module, LLVMContext &context);
 
     EvalConstant evalConstant;
-
-    // PointerType * 与 ArrayType * 之间的转换
-    std::unordered_map<Type*,Type *> pointerTypeToArray_; 
-
-    bool isAddr; // 是否是地址
 };
 
 #endif // CODEGENERATOR_H
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define EVAL_CONSTANT_H
 
 #include "astSysy.h"
+#include "flatAst.h"
 #include <variant>
 using namespace AST;
 
@@ -9,9 +10,18 @@ class EvalConstant
 {
 public:
     // 入口函数，传入 AST 基类指针，返回求值结果，只支持int型
+    // 变量引用与函数调用求值为 0；不含二者的子树的结果标注在 Exp 上（见 Exp::folded_），同一子树再次求值时直接读取
     int Eval(Node *node);
+    // 最近一次 Eval(Node *) 的子树是否为常量（不含变量引用与函数调用）
+    bool isConstant() const { return constant_; }
+    // 在扁平语法树上求值以 index 为根的子树，语义与 Eval(Node *) 一致
+    int Eval(const FlatAst &ast, uint32_t index);
 
 private:
+    bool constant_ = true;
+
+    int EvalNode(Node *node);
+    int EvalUncached(Node *node);
     int VisitNumberExp(Number *exp);
     int VisitAddExp(AddExp *exp);
     int VisitMulExp(MulExp *exp);
@@ -25,6 +35,7 @@ private:
     int VisitCallExp(CallExp *exp);
     int VisitInitVal(InitVal *initVal);
     int VisitConstInitVal(ConstInitVal *constInitVal);
+    int EvalFlatLayer(const FlatAst &ast, uint32_t index);
 };
 
 #endif // EVAL_CONSTANT_H
\ No newline at end of file
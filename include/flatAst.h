@@ -0,0 +1,154 @@
+#ifndef FLATAST_H
+#define FLATAST_H
+
+#include "astSysy.h"
+#include "stringInterner.h"
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+class AstCache;
+
+namespace AST
+{
+    // 扁平语法树中的一个节点（12 字节）
+    // 节点按先序连续存放：子节点从 index + 1 开始，每个子节点的 end_ 即下一个兄弟的下标，
+    // 最后一个子节点的 end_ 等于父节点的 end_。遍历只在数组上前移，没有指针跳转。
+    struct FlatNode
+    {
+        uint8_t kind_;    // Node::Kind
+        uint8_t op_;      // 二元层的操作数：连接本节点与前一个操作数的运算符（TokenType），首个操作数为 UNKNOW
+        uint8_t unaryOp_; // UnaryExp::Op
+        uint8_t flags_;   // FlatAst::Flag 的组合
+        uint32_t end_;    // 子树结束下标（不含）
+        int32_t value_;   // Number 的值；带名字的节点为 SymbolId；printf 为格式串下标
+
+        Node::Kind kind() const
+        {
+            return static_cast<Node::Kind>(kind_);
+        }
+        TokenType op() const
+        {
+            return static_cast<TokenType>(op_);
+        }
+    };
+
+    static_assert(sizeof(FlatNode) == 12, "FlatNode 应保持紧凑");
+
+    // 扁平编码的语法树：由指针树经 FlatAst::build 转换得到，只读；materialize 做反向转换
+    // 各节点的子节点顺序与指针树中的字段顺序一致：
+    //   CompUnit      decls_..., funcDefs_..., [mainfuncDef_]
+    //   ConstDecl     bType_, constDefs_...          VarDecl   bType_, varDefs_...
+    //   ConstDef      dimensions_..., initVal_       VarDef    constExps_..., [initVal_]
+    //   FuncDef       returnType_, params_..., body_ FuncParam dimSizes_...（首维为空时置 kEmptyFirstDim，不占节点）
+    //   MainFuncDef   body_                          Block     items_...
+    //   BlockItem     item_                          ExpStmt   exp_
+    //   AssignStmt    lval_, exp_                    IfStmt    cond_, thenBranch_, [elseBranch_]
+    //   WhileStmt     cond_, body_                   ReturnStmt [exp_]
+    //   IOStmt        getint: target_；printf: args_...
+    //   LVal          indices_...                    CallExp   args_...
+    //   PrimaryExp    operand_                       UnaryExp  operand_
+    //   AddExp 等二元层 各操作数，运算符内联在操作数的 op_ 中
+    //   InitVal/ConstInitVal 表达式或子初始化值列表（置 kList）
+    class FlatAst
+    {
+    public:
+        enum Flag : uint8_t
+        {
+            kHasInit = 1 << 0,       // ConstDef/VarDef 带初始化值
+            kList = 1 << 1,          // InitVal/ConstInitVal 为 { ... } 列表
+            kPrintf = 1 << 2,        // IOStmt 为 printf，否则为 getint
+            kArray = 1 << 3,         // FuncParam 为数组形参
+            kEmptyFirstDim = 1 << 4, // FuncParam 首维为 []
+            kVoid = 1 << 5,          // FuncType 为 void
+        };
+
+        // 兄弟节点区间 [first, end) 上的迭代器，++ 跳过整棵子树
+        class ChildIterator
+        {
+        public:
+            ChildIterator(const FlatAst &ast, uint32_t index) : ast_(&ast), index_(index) {}
+            uint32_t operator*() const
+            {
+                return index_;
+            }
+            ChildIterator &operator++()
+            {
+                index_ = ast_->nodes_[index_].end_;
+                return *this;
+            }
+            bool operator!=(const ChildIterator &other) const
+            {
+                return index_ != other.index_;
+            }
+
+        private:
+            const FlatAst *ast_;
+            uint32_t index_;
+        };
+
+        class ChildRange
+        {
+        public:
+            ChildRange(const FlatAst &ast, uint32_t first, uint32_t end) : ast_(ast), first_(first), end_(end) {}
+            ChildIterator begin() const
+            {
+                return ChildIterator(ast_, first_);
+            }
+            ChildIterator end() const
+            {
+                return ChildIterator(ast_, end_);
+            }
+            bool empty() const
+            {
+                return first_ == end_;
+            }
+
+        private:
+            const FlatAst &ast_;
+            uint32_t first_;
+            uint32_t end_;
+        };
+
+        // 把指针树转换为扁平编码；origins 非空时按下标记录每个扁平节点对应的原节点，便于逐步迁移
+        static FlatAst build(CompUnit &root, std::vector<Node *> *origins = nullptr);
+
+        // 由扁平编码重建指针树，节点分配在 arena 中：名字取 interner 中 value_ 对应的拼写，格式串复制到 arena，
+        // 形参的 BType 按 int 补建。编码不合法（如读自损坏的缓存文件）时返回 nullptr
+        CompUnit *materialize(AstArena &arena, const StringInterner &interner) const;
+
+        static constexpr uint32_t kRoot = 0;
+
+        uint32_t size() const
+        {
+            return static_cast<uint32_t>(nodes_.size());
+        }
+        const FlatNode &operator[](uint32_t index) const
+        {
+            return nodes_[index];
+        }
+        Node::Kind kind(uint32_t index) const
+        {
+            return nodes_[index].kind();
+        }
+        ChildRange children(uint32_t index) const
+        {
+            return ChildRange(*this, index + 1, nodes_[index].end_);
+        }
+        // printf 的格式串（含引号，指向源码缓冲区）
+        std::string_view string(uint32_t index) const
+        {
+            return strings_[nodes_[index].value_];
+        }
+
+    private:
+        friend class FlatAstBuilder;
+        friend class FlatAstMaterializer;
+        friend class ::AstCache;
+
+        std::vector<FlatNode> nodes_;
+        std::vector<std::string_view> strings_;
+    };
+}
+
+#endif // FLATAST_H
@@ -0,0 +1,28 @@
+#ifndef FUNCTIONPROTOTYPE_H
+#define FUNCTIONPROTOTYPE_H
+
+#include "astSysy.h"
+#include <string>
+#include <vector>
+
+// 函数原型：多文件编译时，一个编译单元定义的函数以原型的形式交给其他单元，
+// 供其语义分析登记函数符号、代码生成声明外部函数。
+// 原型只保存拼写与求值后的维度，不引用语法树和驻留表，可以在各单元的线程之间共享。
+struct FunctionParamShape
+{
+    bool isArray_ = false;
+    std::vector<int> innerDims_; // 数组形参除首维外各维的长度
+};
+
+struct FunctionPrototype
+{
+    std::string name_;
+    bool returnsInt_ = true;
+    std::vector<FunctionParamShape> params_;
+};
+
+// 收集编译单元中定义的函数（不含 main）的原型，按定义顺序排列
+// 数组形参的维度在此求值并标注在语法树上，之后各线程只读取标注
+std::vector<FunctionPrototype> collectPrototypes(AST::CompUnit &unit);
+
+#endif // FUNCTIONPROTOTYPE_H
@@ -1,11 +1,15 @@
 #ifndef LEXER_H
 #define LEXER_H
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <unordered_map>
 #include <list>
 #include <iostream>
+#include "stringInterner.h"
+
+class ThreadPool;
 
 // 定义词法单元类型
 
@@ -122,143 +126,122 @@ class Token
 {
 public:
     Token();
-    Token(TokenType tokentype, std::string value, int line, int colume);
+    Token(TokenType tokentype, std::string_view value, uint32_t offset);
     TokenType tokenType_;
-    std::string value_;
-    int line_;
-    int colume_;
+    std::string_view value_; // 指向源码缓冲区（或静态错误信息）的视图，不持有内存
+    uint32_t offset_;        // token 在源码中的起始偏移，行列号由 Lexer::location() 按需换算
+    SymbolId symbol_ = kNoSymbol; // 标识符的驻留编号，其余 token 为 kNoSymbol
 
     // 将 TokenType 转换为字符串，方便调试和输出
     static std::string tokenTypeToString(TokenType type);
-    friend std::ostream &operator<<(std::ostream &os, const Token &token);
+};
+
+static_assert(static_cast<int>(TokenType::ERROR) < 256, "TokenBuffer 以 uint8_t 保存 TokenType");
+
+// 源码位置（行列号均从 1 开始）
+struct SourceLocation
+{
+    int line;
+    int column;
+};
+
+// 行首偏移表
+// 只有输出 token 或报告错误时才需要行列号，因此首次查询时才扫描源码建立，之后二分查找
+class LineTable
+{
+public:
+    explicit LineTable(std::string_view source);
+    SourceLocation locate(uint32_t offset) const;
+
+private:
+    std::string_view source_;
+    mutable std::vector<uint32_t> lineStarts_; // 各行首字符的偏移，为空表示尚未建立
+};
+
+// 按列存放（SoA）的 token 序列
+// 每个 token 只占 kind/offset/length/symbol 四列共 13 字节，文本从源码切片得到，不保存行列号；
+// Parser 的 check()/match() 只访问紧凑的 kind 列。
+// 错误 token 的文本是错误信息而不是源码，此时 length 列保存错误信息在 messages_ 中的下标。
+class TokenBuffer
+{
+public:
+    explicit TokenBuffer(std::string_view source);
+
+    void push(const Token &token);
+    // 按列整体追加 other 中下标不小于 from 的 token
+    void append(const TokenBuffer &other, size_t from);
+    void setSymbol(size_t index, SymbolId symbol);
+    void reserve(size_t count);
+    size_t size() const;
+
+    TokenType kind(size_t index) const;
+    uint32_t offset(size_t index) const;
+    std::string_view text(size_t index) const;
+    SymbolId symbol(size_t index) const;
+    // 按下标还原出完整的 Token
+    Token operator[](size_t index) const;
+
+private:
+    friend class TokenCache;
+
+    std::string_view source_;
+    std::vector<uint8_t> kinds_;
+    std::vector<uint32_t> offsets_;
+    std::vector<uint32_t> lengths_;
+    std::vector<SymbolId> symbols_;
+    std::vector<std::string_view> messages_;
 };
 
 class Lexer
 {
 public:
-    explicit Lexer(std::string sourceCode);
+    // sourceCode 由调用方持有，必须在整个编译过程中保持有效；标识符驻留到 interner 中
+    Lexer(std::string_view sourceCode, StringInterner &interner);
     void tokenize(); // 扫描文本，序列化token，调用gettoken
-    std::vector<Token> getTokens();
+    // 并行版本的 tokenize()：把源码切成若干块交给线程池推测扫描，再顺序拼接，
+    // 结果（token、偏移与标识符编号）与 tokenize() 完全相同。
+    // 每块至少 minChunkSize 字节，源码不足两块时退化为 tokenize()
+    static constexpr size_t kMinChunkSize = 256 * 1024;
+    void tokenizeParallel(ThreadPool &pool, size_t minChunkSize = kMinChunkSize);
+    const TokenBuffer &getTokens() const;
+
+    // 扫描并返回下一个 token，供 TokenStream 按需拉取
+    Token getNextToken();
+
+    // 把源码偏移换算为行列号
+    SourceLocation location(uint32_t offset) const;
 
     void printTokens();
 
+    // 关键字/界符识别，直接作用于原始字符，不构造字符串（运算符由扫描状态机直接识别）
+    // 关键字：编译期生成的完美哈希表；不是关键字时返回 IDENTIFIER
+    static TokenType classifyKeyword(std::string_view word);
+    // 界符：单字符分支，不是界符时返回 UNKNOW
+    static TokenType classifyPunctuation(char c);
+
 private:
-    std::string sourceCode_; // 源代码
+    friend class TokenCache;
+
+    std::string_view sourceCode_; // 源代码
+    StringInterner &interner_;
     size_t currentPosition_; // 当前读取位置
-    int currentLine_;        // 当前行
-    int currentColumn_;      // 当前列
-
-    std::unordered_map<std::string, TokenType> keywords_ = {
-        {"auto", TokenType::KEYWORD_AUTO},
-        {"break", TokenType::KEYWORD_BREAK},
-        {"case", TokenType::KEYWORD_CASE},
-        {"char", TokenType::KEYWORD_CHAR},
-        {"const", TokenType::KEYWORD_CONST},
-        {"continue", TokenType::KEYWORD_CONTINUE},
-        {"default", TokenType::KEYWORD_DEFAULT},
-        {"do", TokenType::KEYWORD_DO},
-        {"double", TokenType::KEYWORD_DOUBLE},
-        {"else", TokenType::KEYWORD_ELSE},
-        {"enum", TokenType::KEYWORD_ENUM},
-        {"extern", TokenType::KEYWORD_EXTERN},
-        {"float", TokenType::KEYWORD_FLOAT},
-        {"for", TokenType::KEYWORD_FOR},
-        {"goto", TokenType::KEYWORD_GOTO},
-        {"if", TokenType::KEYWORD_IF},
-        {"int", TokenType::KEYWORD_INT},
-        {"long", TokenType::KEYWORD_LONG},
-        {"register", TokenType::KEYWORD_REGISTER},
-        {"return", TokenType::KEYWORD_RETURN},
-        {"short", TokenType::KEYWORD_SHORT},
-        {"signed", TokenType::KEYWORD_SIGNED},
-        {"sizeof", TokenType::KEYWORD_SIZEOF},
-        {"static", TokenType::KEYWORD_STATIC},
-        {"struct", TokenType::KEYWORD_STRUCT},
-        {"switch", TokenType::KEYWORD_SWITCH},
-        {"typedef", TokenType::KEYWORD_TYPEDEF},
-        {"union", TokenType::KEYWORD_UNION},
-        {"unsigned", TokenType::KEYWORD_UNSIGNED},
-        {"void", TokenType::KEYWORD_VOID},
-        {"volatile", TokenType::KEYWORD_VOLATILE},
-        {"while", TokenType::KEYWORD_WHILE},
-
-        {"getint",TokenType::KEYWORD_GETINT},
-        {"printf",TokenType::KEYWORD_PRINTF},
-        {"main",TokenType::KEYWORD_MAIN}};
-
-    std::unordered_map<std::string, TokenType> operators_ = {
-        {"+", TokenType::OPERATOR_PLUS},
-        {"-", TokenType::OPERATOR_MINUS},
-        {"*", TokenType::OPERATOR_MULTIPLY},
-        {"/", TokenType::OPERATOR_DIVIDE},
-        {"%", TokenType::OPERATOR_MODULO},
-        {"++", TokenType::OPERATOR_INCREMENT},
-        {"--", TokenType::OPERATOR_DECREMENT},
-
-        // 赋值运算符
-        {"=", TokenType::OPERATOR_ASSIGN},
-        {"+=", TokenType::OPERATOR_AND_ASSIGN},
-        {"-=", TokenType::OPERATOR_MINUS_ASSIGN},
-        {"*=", TokenType::OPERATOR_MULTIPLY_ASSIGN},
-        {"/=", TokenType::OPERATOR_DIVIDE_ASSIGN},
-        {"%=", TokenType::OPERATOR_MODULO_ASSIGN},
-        {"&=", TokenType::OPERATOR_AND_ASSIGN},
-        {"|=", TokenType::OPERATOR_OR_ASSIGN},
-        {"^=", TokenType::OPERATOR_XOR_ASSIGN},
-        {"<<=", TokenType::OPERATOR_LEFT_SHIFT_ASSIGN},
-        {">>=", TokenType::OPERATOR_RIGHT_SHIFT_ASSIGN},
-
-        // 关系运算符
-        {"==", TokenType::OPERATOR_EQUAL},
-        {"!=", TokenType::OPERATOR_NOT_EQUAL},
-        {">", TokenType::OPERATOR_GREATER},
-        {"<", TokenType::OPERATOR_LESS},
-        {">=", TokenType::OPERATOR_GREATER_EQUAL},
-        {"<=", TokenType::OPERATOR_LESS_EQUAL},
-
-        // 逻辑运算符
-        {"&&", TokenType::OPERATOR_LOGICAL_AND},
-        {"||", TokenType::OPERATOR_LOGICAL_OR},
-        {"!", TokenType::OPERATOR_LOGICAL_NOT},
-
-        // 位运算符
-        {"&", TokenType::OPERATOR_BITWISE_AND},
-        {"|", TokenType::OPERATOR_BITWISE_OR},
-        {"^", TokenType::OPERATOR_BITWISE_XOR},
-        {"~", TokenType::OPERATOR_BITWISE_NOT},
-        {"<<", TokenType::OPERATOR_LEFT_SHIFT},
-        {">>", TokenType::OPERATOR_RIGHT_SHIFT}};
-        
-    std::unordered_map<std::string, TokenType> punctuations_ = {
-        {"(", TokenType::PUNCTUATION_LEFT_PAREN},
-        {")", TokenType::PUNCTUATION_RIGHT_PAREN},
-        {"{", TokenType::PUNCTUATION_LEFT_BRACE},
-        {"}", TokenType::PUNCTUATION_RIGHT_BRACE},
-        {"[", TokenType::PUNCTUATION_LEFT_BRACKET},
-        {"]", TokenType::PUNCTUATION_RIGHT_BRACKET},
-        {",", TokenType::PUNCTUATION_COMMA},
-        {";", TokenType::PUNCTUATION_SEMICOLON},
-        {":", TokenType::PUNCTUATION_COLON},
-        {".", TokenType::PUNCTUATION_DOT},
-        {"->", TokenType::PUNCTUATION_ARROW}};
-
-    std::vector<Token> tokens_;
+    LineTable lines_;
 
-private:
-    Token getNextToken();
+    TokenBuffer tokens_;
 
+    // 不在源码中出现的动态错误信息（如非法后缀），供错误 token 的 value_ 引用
+    std::list<std::string> messages_;
+
+private:
     char peek(size_t ahead = 0) const;
     char advance();
 
     void skipWhitespaceOrComments();
-    Token readIdentifierOrKeyword();
+    // 从当前位置逐个扫描 token，直到扫描起点不小于 end 或遇到文件结束；
+    // resume 为每个 token 记录扫描它时的起点（调用 getNextToken 前的位置）
+    void tokenizeUntil(size_t end, std::vector<uint32_t> &resume);
+    // 数字写法有误时由状态机回退到这里，逐字符读取并给出具体错误信息
     Token readNumber();
-    Token readString();
-    Token readOperator();
-    Token readSymbol();
-
-    bool isOperator(char c);
-    bool isSymbol(char c);
 };
 
 #endif
\ No newline at end of file
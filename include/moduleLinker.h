@@ -0,0 +1,32 @@
+#ifndef MODULELINKER_H
+#define MODULELINKER_H
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include <memory>
+#include <string>
+
+// 多文件编译的链接：各编译单元在自己线程的 LLVMContext 中生成模块并写成位码，
+// 再由 ModuleLinker 在同一个上下文中读回，用 llvm::Linker 依次链接成一个模块。
+// 各单元都带有内置 getint 的定义，只保留第一个单元的那份，其余单元的改为声明。
+class ModuleLinker
+{
+public:
+    explicit ModuleLinker(llvm::LLVMContext &context);
+
+    // 模块的位码，可在任意线程调用
+    static std::string serialize(const llvm::Module &module);
+
+    // 读回位码并链接进合并模块；name 用于诊断。读回或链接失败（如函数重复定义）时输出诊断并返回 false
+    bool add(llvm::StringRef bitcode, llvm::StringRef name);
+
+    // 取走合并后的模块，没有成功加入任何单元时为空
+    std::unique_ptr<llvm::Module> take() { return std::move(merged_); }
+
+private:
+    llvm::LLVMContext &context_;
+    std::unique_ptr<llvm::Module> merged_;
+};
+
+#endif // MODULELINKER_H
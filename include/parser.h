@@ -3,82 +3,97 @@
 
 #include "astSysy.h"
 #include "lexer.h"
+#include "tokenStream.h"
 #include <vector>
 #include <memory>
 #include <stdexcept>
-#include "symbolTable.h"
 #include "ErrorManager.h"
 using namespace AST;
 
+class ThreadPool;
+
 class Parser
 {
 public:
-    explicit Parser(std::vector<Token> &tokens, SymbolTable &symbolTable);
-    // 编译单元解析
-    std::unique_ptr<CompUnit> parseCompUnit();
+    // 回放 Lexer::tokenize() 得到的完整 token 序列
+    explicit Parser(const TokenBuffer &tokens, AstArena &arena);
+    // 流式解析：按需从 lexer 拉取 token，扫描与解析交替进行
+    explicit Parser(Lexer &lexer, AstArena &arena);
+    // 编译单元解析，返回的语法树分配在 arena 中
+    // 给出 pool 且为回放模式时，顶层函数定义按花括号配对切分后在 pool 上并行解析，
+    // 各任务使用 arena 派生的子 arena；funcDefs_ 的顺序与源码一致
+    CompUnit *parseCompUnit(ThreadPool *pool = nullptr);
 
 private:
-    SymbolTable &symbolTable_;
-    std::vector<Token> &tokens_;
-    size_t current_;
-    Token token_;
+    // 只解析 tokens 中 [begin, end) 区间，供并行解析的任务使用
+    Parser(const TokenBuffer &tokens, size_t begin, size_t end, AstArena &arena);
+
+    AstArena &arena_;
+    const TokenBuffer *buffer_; // 回放模式的 token 序列，流式模式为空
+    TokenStream tokens_;
 
 
     // =======辅助方法====================================================================
-    Token peek(size_t ahead = 0) const;
-    Token advance();
+    // 均返回 TokenStream 环形缓冲区中的引用，不复制 token；引用在下一次 advance 之前有效
+    const Token &current()
+    {
+        return tokens_.peek();
+    }
+    const Token &peek(size_t ahead = 0);
+    const Token &advance();
     bool match(TokenType type);
-    bool check(TokenType type) const;
+    bool check(TokenType type);
 
     // 非终结符解析函数
     // 声明解析
-    std::unique_ptr<Decl> parseDecl();
-    std::unique_ptr<ConstDecl> parseConstDecl();
-    std::unique_ptr<ConstDef> parseConstDef();
-    std::unique_ptr<VarDecl> parseVarDecl();
-    std::unique_ptr<VarDef> parseVarDef();
+    Decl *parseDecl();
+    ConstDecl *parseConstDecl();
+    ConstDef *parseConstDef();
+    VarDecl *parseVarDecl();
+    VarDef *parseVarDef();
 
     // 函数定义解析
-    std::unique_ptr<FuncDef> parseFuncDef();
-    std::unique_ptr<MainFuncDef> parseMainFuncDef();
-    std::unique_ptr<FuncParam> parseFuncParam();
+    bool isFuncDefStart();
+    void parseFuncDefsParallel(ThreadPool &pool, llvm::SmallVectorImpl<FuncDef *> &funcDefs);
+    FuncDef *parseFuncDef();
+    MainFuncDef *parseMainFuncDef();
+    FuncParam *parseFuncParam();
 
     // 语句解析
-    std::unique_ptr<Block> parseBlock();
-    std::unique_ptr<BlockItem> parseBlockItem();
-    std::unique_ptr<Stmt> parseStmt();
-    std::unique_ptr<IfStmt> parseIfStmt();         // if语句
-    std::unique_ptr<WhileStmt> parseWhileStmt();   // while循环
-    std::unique_ptr<ReturnStmt> parseReturnStmt(); // return语句
-    std::unique_ptr<AssignStmt> parseAssignStmt();
-    std::unique_ptr<IOStmt> parsePrintfStmt();
-    std::unique_ptr<IOStmt> parseGetintStmt();
-
-    // 表达式
-    std::unique_ptr<Exp> parseExp();
-    std::unique_ptr<LOrExp> parseLogicalOrExp();
-    std::unique_ptr<Exp> parseLogicalAndExp();
-    std::unique_ptr<Exp> parseEqExp();
-    std::unique_ptr<Exp> parseRelExp();
-    std::unique_ptr<AddExp> parseAddExp();
-    std::unique_ptr<MulExp> parseMulExp();
-    std::unique_ptr<Exp> parseUnaryExp();
-    std::unique_ptr<PrimaryExp> parsePrimaryExp();
-    std::unique_ptr<LVal> parseLVal();
-    std::unique_ptr<Number> parseNumber();
+    Block *parseBlock();
+    BlockItem *parseBlockItem();
+    Stmt *parseStmt();
+    IfStmt *parseIfStmt();         // if语句
+    WhileStmt *parseWhileStmt();   // while循环
+    ReturnStmt *parseReturnStmt(); // return语句
+    AssignStmt *parseAssignStmt();
+    IOStmt *parsePrintfStmt();
+    IOStmt *parseGetintStmt();
+
+    // 表达式：二元运算统一由 parseBinaryExp 按优先级解析，
+    // 只有一个操作数的 LOrExp ~ MulExp、UnaryExp、PrimaryExp 层不建节点
+    static constexpr int kLOrPrecedence = 1; // Cond 从 LOrExp 开始
+    static constexpr int kAddPrecedence = 5; // Exp / ConstExp 从 AddExp 开始
+    Exp *parseExp();
+    Exp *parseCond();
+    Exp *parseBinaryExp(int minPrecedence);
+    Exp *parseUnaryExp();
+    Exp *parsePrimaryExp();
+    LVal *parseLVal();
+    Number *parseNumber();
 
     // 初始化值
-    std::unique_ptr<ConstInitVal> parseConstInitVal();
-    std::unique_ptr<InitVal> parseInitVal();
+    ConstInitVal *parseConstInitVal();
+    InitVal *parseInitVal();
 
-    std::unique_ptr<FuncType> parseFuncType();
-    std::unique_ptr<BType> parseBType();
-    std::unique_ptr<Exp> parseConstExp();
-    std::unique_ptr<Stmt> parseExpStmt();
-    std::unique_ptr<CallExp> parseCallExp();
+    FuncType *parseFuncType();
+    BType *parseBType();
+    Exp *parseConstExp();
+    Stmt *parseExpStmt();
+    CallExp *parseCallExp();
 
     bool isAtEnd();
-    Token previous();
+    const Token &previous();
 
     bool isAssignStmt();
 };
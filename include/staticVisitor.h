@@ -0,0 +1,82 @@
+#ifndef STATICVISITOR_H
+#define STATICVISITOR_H
+
+#include "astSysy.h"
+#include <type_traits>
+
+namespace AST
+{
+    // 编译期分派的访问者（CRTP），用来替代虚函数接口 Visitor
+    // visitNode 按指针的静态类型在编译期选择 Derived::visit(T &)：
+    //   - 具体节点类型（如 Block *、LVal *）直接调用，可以内联，没有间接跳转；
+    //   - 静态类型为 Node/Decl/Exp/Stmt 时按 getKind() 查表，经一次间接调用进入对应的 visit。
+    // 虚函数接口每个节点要经过 accept 与 visit 两次间接调用。查表而不用按种类的 switch：
+    // switch 把所有节点的分派集中到同一条间接跳转上，实测比两次虚调用还慢；每个调用点各自的间接调用更容易预测。
+    // Derived 需为全部具体节点类型提供 visit(T &)（可为空实现），缺少时编译报错而不是运行时出错。
+    template <typename Derived>
+    class StaticVisitor
+    {
+    public:
+        template <typename T>
+        void visitNode(T &node)
+        {
+            static_assert(std::is_base_of<Node, T>::value, "visitNode 只接受语法树节点");
+            if constexpr (isAbstract<T>())
+            {
+                kTable[node.getKind()](derived(), node);
+            }
+            else
+            {
+                derived().visit(node);
+            }
+        }
+
+        template <typename T>
+        void visitNode(T *node)
+        {
+            visitNode(*node);
+        }
+
+    private:
+        using Entry = void (*)(Derived &, Node &);
+
+        template <typename T>
+        static void call(Derived &self, Node &node)
+        {
+            // 断言构建中核对表项顺序与 Node::Kind 一致
+            self.visit(*llvm::cast<T>(&node));
+        }
+
+        static void abstractKind(Derived &, Node &)
+        {
+            llvm_unreachable("抽象节点种类");
+        }
+
+        // 按 Node::Kind 的顺序排列
+        static constexpr Entry kTable[] = {
+            abstractKind,          abstractKind,       abstractKind,        call<CompUnit>,     call<ConstDef>,
+            call<ConstDecl>,       call<VarDef>,       call<VarDecl>,       call<FuncParam>,    call<FuncDef>,
+            call<MainFuncDef>,     call<BlockItem>,    call<ExpStmt>,       call<AssignStmt>,   call<IfStmt>,
+            call<WhileStmt>,       call<ReturnStmt>,   call<IOStmt>,        call<LVal>,         call<PrimaryExp>,
+            call<UnaryExp>,        call<AddExp>,       call<MulExp>,        call<LOrExp>,       call<LAndExp>,
+            call<EqExp>,           call<RelExp>,       call<CallExp>,       call<Number>,       call<BType>,
+            call<FuncType>,        call<InitVal>,      call<ConstInitVal>,  call<Block>,
+        };
+        static_assert(sizeof(kTable) / sizeof(kTable[0]) == Node::ND_Block + 1, "kTable 需覆盖全部 Node::Kind");
+
+        Derived &derived()
+        {
+            return static_cast<Derived &>(*this);
+        }
+
+        // 没有自己的 Kind、需要按运行时种类分派的基类
+        template <typename T>
+        static constexpr bool isAbstract()
+        {
+            return std::is_same<T, Node>::value || std::is_same<T, Decl>::value || std::is_same<T, Exp>::value ||
+                   std::is_same<T, Stmt>::value;
+        }
+    };
+}
+
+#endif // STATICVISITOR_H
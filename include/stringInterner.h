@@ -0,0 +1,52 @@
+#ifndef STRINGINTERNER_H
+#define STRINGINTERNER_H
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// 标识符驻留后的编号，同一次编译中相同拼写的标识符编号相同
+using SymbolId = uint32_t;
+constexpr SymbolId kNoSymbol = 0; // 非标识符 token / 未设置名字的节点
+
+// 字符串驻留表
+// 由一次编译持有（见 main），词法分析时把标识符映射为 32 位编号，
+// 之后 AST、符号表与代码生成都以编号作为键，不再反复对名字做哈希与比较。
+// 拼写保存在只增不减的分块存储中，spelling() 返回的视图在驻留表存活期间一直有效。
+class StringInterner
+{
+public:
+    StringInterner();
+    StringInterner(const StringInterner &) = delete;
+    StringInterner &operator=(const StringInterner &) = delete;
+
+    // 返回 text 的编号，首次出现时分配新编号
+    SymbolId intern(std::string_view text);
+    // 只查找不插入，不存在时返回 kNoSymbol
+    SymbolId find(std::string_view text) const;
+    std::string_view spelling(SymbolId id) const;
+    // 已分配的编号数（含保留的 kNoSymbol），编号都小于该值，可直接作为数组下标
+    size_t size() const;
+
+private:
+    static constexpr size_t kChunkSize = 16 * 1024;
+
+    struct Slot
+    {
+        uint32_t hash;
+        SymbolId id; // kNoSymbol 表示空槽
+    };
+
+    std::vector<Slot> slots_;                  // 开放定址哈希表，容量为 2 的幂
+    std::vector<std::string_view> spellings_;  // 按编号索引
+    std::vector<std::unique_ptr<char[]>> chunks_;
+    size_t chunkUsed_;
+
+    static uint32_t hash(std::string_view text);
+    size_t probe(std::string_view text, uint32_t hash) const;
+    std::string_view store(std::string_view text);
+    void grow();
+};
+
+#endif // STRINGINTERNER_H
@@ -5,10 +5,14 @@
 #include <unordered_map>
 #include <string>
 #include <memory>
+#include <tuple>
 #include "lexer.h"
 #include "llvm/IR/Value.h"
+#include "llvm/Support/Allocator.h"
 #include "ErrorManager.h"
 
+struct FunctionPrototype;
+
 // 符号类型分类
 enum SymbolType
 {
@@ -23,11 +27,18 @@ enum SymbolType
 class Symbol
 {
 public:
-    std::string name_;
+    std::string_view name_; // 拼写，仅用于诊断信息
+    SymbolId id_ = kNoSymbol;
     SymbolType symbolType_;
     TokenType dataType_;
     int lineDefined_;
 
+    // 代码生成填写：变量、常量与形参为其存储地址（全局变量、alloca 或数组形参的指针值），函数为 llvm::Function；
+    // 地址的类型由语义分析的标注（数组为 ArraySymbol::dimensions_）确定，代码生成不再查询 LLVM 类型
+    llvm::Value *storage_ = nullptr;
+
+    bool isArray_ = false; // 数组、常量数组与数组形参的符号为 ArraySymbol
+
     Symbol() = default;
 
     virtual ~Symbol() = default;
@@ -40,8 +51,6 @@ public:
     bool isConst_;
     int initValue_;
 
-    llvm::Value *allocaInst_; // 变量对应的内存地址
-
     VariableSymbol() = default;
 };
 
@@ -50,12 +59,10 @@ class ArraySymbol : public Symbol
 {
 public:
     bool isConst_;
-    std::vector<int> dimensions_; // 数组的维度
+    std::vector<int> dimensions_; // 数组的维度；数组形参的首维未知，记为 0
     std::vector<int> initValues_; // 数组初始化值
 
-    llvm::Value *allocaInst_; // 数组对应的内存地址
-
-    ArraySymbol() = default;
+    ArraySymbol() { isArray_ = true; }
 };
 
 // 函数符号
@@ -64,20 +71,56 @@ class FunctionSymbol : public Symbol
 public:
     std::vector<TokenType> paramTypes_; // 参数类型列表
     bool hasReturn_;                    // 是否包含返回值
+    // 多文件编译时其他编译单元定义的函数的原型，代码生成据此声明；本单元定义的函数为空
+    const FunctionPrototype *prototype_ = nullptr;
+    // 本单元中第几个函数定义（从 0 起），语义分析据此使之后定义的函数对之前的函数体不可见；
+    // 内置函数与其他单元的函数为 0
+    size_t definitionOrder_ = 0;
 
     FunctionSymbol() = default;
 };
 
 // 符号表类（支持嵌套作用域）
+// 所有作用域共用一张按标识符驻留编号直接索引的表，每个名字指向其当前可见的绑定，绑定再链向被它遮蔽的外层绑定：
+// 查找只需一次下标访问；绑定按加入顺序压栈，栈同时是撤销日志，退出作用域时只弹出并撤销本作用域加入的绑定。
+// 符号在符号表的池中分配，归符号表所有，退出作用域后仍然有效：语义分析把解析结果标注在语法树上，代码生成沿标注访问符号。
+// 并行检查函数体时每个线程使用一张以全局符号表为外层的符号表，只登记局部符号，查找不到时再查外层（只读）
 class SymbolTable
 {
-    using Scope = std::unordered_map<std::string, std::unique_ptr<Symbol>>;
-    std::vector<Scope> scopes_;
+    static constexpr uint32_t kNoBinding = UINT32_MAX;
+
+    struct Binding
+    {
+        Symbol *symbol_;
+        uint32_t shadowed_; // 被本绑定遮蔽的同名绑定在 bindings_ 中的下标，没有时为 kNoBinding
+    };
+
+    std::vector<uint32_t> heads_;   // 按 SymbolId 索引：该名字当前可见的绑定
+    std::vector<Binding> bindings_; // 全部可见或被遮蔽的绑定，外层作用域在前
+    std::vector<uint32_t> scopes_;  // 各作用域第一个绑定在 bindings_ 中的下标
+    // 符号池：各类符号分别连续分配，随符号表一起析构
+    std::tuple<llvm::SpecificBumpPtrAllocator<VariableSymbol>,
+               llvm::SpecificBumpPtrAllocator<ArraySymbol>,
+               llvm::SpecificBumpPtrAllocator<FunctionSymbol>>
+        pools_;
+    StringInterner &interner_;
+    const SymbolTable *outer_ = nullptr;
 
     void addBuiltinFunctions();
 
 public:
-    SymbolTable();
+    explicit SymbolTable(StringInterner &interner);
+    // 以 outer 为外层的符号表：不含内置函数，outer 须存活至本表不再使用，且期间不再修改
+    SymbolTable(StringInterner &interner, const SymbolTable &outer);
+    SymbolTable(const SymbolTable &) = delete;
+    SymbolTable &operator=(const SymbolTable &) = delete;
+
+    // 在池中创建符号（VariableSymbol、ArraySymbol 或 FunctionSymbol），填写后由 addSymbol 加入当前作用域
+    template <typename T>
+    T *create()
+    {
+        return new (std::get<llvm::SpecificBumpPtrAllocator<T>>(pools_).Allocate()) T();
+    }
 
     // 进入新作用域
     void enterScope();
@@ -85,14 +128,14 @@ public:
     // 退出当前作用域
     void exitScope();
 
-    // 添加符号
-    bool addSymbol(std::unique_ptr<Symbol> symbol);
+    // 添加由 create 创建的符号，返回该符号；当前作用域已有同名符号时返回空
+    Symbol *addSymbol(Symbol *symbol);
 
     // 查找符号从内到外
-    Symbol *lookup(const std::string &name);
+    Symbol *lookup(SymbolId id) const;
 
     // 在当前作用域内
-    Symbol *lookupInCurrentScope(const std::string &name);
+    Symbol *lookupInCurrentScope(SymbolId id) const;
 };
 
 #endif
\ No newline at end of file
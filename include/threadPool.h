@@ -0,0 +1,38 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 固定大小的线程池
+// 任务按提交顺序出队执行，submit 返回的 future 用于等待完成并转发任务中抛出的异常。
+// 析构时先执行完队列中剩余的任务再回收线程。
+class ThreadPool
+{
+public:
+    // threads 为 0 时取硬件并发数（至少 1）
+    explicit ThreadPool(size_t threads = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    size_t size() const;
+    std::future<void> submit(std::function<void()> task);
+
+private:
+    std::vector<std::thread> workers_;
+    std::deque<std::packaged_task<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    bool stopping_;
+
+    void run();
+};
+
+#endif // THREADPOOL_H
@@ -0,0 +1,39 @@
+#ifndef TOKENCACHE_H
+#define TOKENCACHE_H
+
+#include "lexer.h"
+#include <cstdint>
+#include <string>
+
+// token 序列的二进制缓存
+// 同一份源码反复编译（只改后端参数）时，直接读回上次的词法分析结果，跳过 tokenize()。
+// 缓存文件位于缓存目录下，以源码的 xxHash64 命名；文件格式（小端，按列存放）：
+//   头部    magic "CCLT" | version u32 | 源码哈希 u64 | 源码长度 u64 | token 数 u32 | 错误信息数 u32
+//   kind    u8  × token 数
+//   offset  u32 × token 数
+//   length  u32 × token 数（错误 token 为错误信息下标）
+//   错误信息 (长度 u32 + 字节) × 错误信息数
+// 标识符编号不写入文件，读回时按出现顺序重新驻留，与重新扫描得到的编号一致。
+class TokenCache
+{
+public:
+    // 格式或词法规则变化时递增，旧版本的缓存文件会被视为未命中
+    static constexpr uint32_t kVersion = 1;
+
+    explicit TokenCache(std::string directory);
+
+    std::string pathFor(std::string_view source) const;
+    // 命中时把 token 序列装入 lexer（之后 getTokens() 可直接使用），未命中或文件损坏时返回 false
+    bool load(Lexer &lexer) const;
+    // 保存 lexer 已物化的 token 序列，先写临时文件再改名，避免并发编译读到半个文件
+    bool store(const Lexer &lexer) const;
+
+    // 校验模式：返回两份 token 序列第一个不同的下标，完全相同时返回 kSame
+    static constexpr size_t kSame = static_cast<size_t>(-1);
+    static size_t firstDifference(const TokenBuffer &lhs, const TokenBuffer &rhs);
+
+private:
+    std::string directory_;
+};
+
+#endif // TOKENCACHE_H
@@ -0,0 +1,79 @@
+#ifndef TOKENSTREAM_H
+#define TOKENSTREAM_H
+
+#include "lexer.h"
+#include <vector>
+
+// 拉取式 token 流
+// Parser 通过它按需向 Lexer 索取 token，边扫描边解析；
+// 前瞻窗口保存在环形缓冲区中，容量只取决于最长的一次前瞻（通常不超过一条语句），
+// 与输入规模无关。也可以回放 Lexer::tokenize() 产生的完整 token 序列。
+class TokenStream
+{
+public:
+    // 流式模式：直接从 lexer 拉取
+    explicit TokenStream(Lexer &lexer);
+    // 回放模式：读取已经物化的 token 序列（用于 printTokens 等需要完整序列的场景）
+    explicit TokenStream(const TokenBuffer &tokens);
+    // 只回放 [begin, end) 区间，之后返回 END_OF_FILE；用于并行解析各个函数定义
+    TokenStream(const TokenBuffer &tokens, size_t begin, size_t end);
+
+    // 查看当前位置之后第 ahead 个 token，不消费
+    // 返回的引用指向环形缓冲区，在下一次 peek/advance 之前有效
+    const Token &peek(size_t ahead = 0)
+    {
+        if (count_ <= ahead)
+        {
+            fill(ahead + 1);
+        }
+        return ring_[(head_ + ahead) & mask_];
+    }
+    // 消费当前 token 并返回它，引用在下一次 advance 之前有效
+    const Token &advance()
+    {
+        if (count_ == 0)
+        {
+            fill(1);
+        }
+        const Token &token = ring_[head_];
+        head_ = (head_ + 1) & mask_;
+        --count_;
+        return token;
+    }
+    // 回放模式下当前 token 在 TokenBuffer 中的下标
+    size_t position() const
+    {
+        return replayPosition_ - count_;
+    }
+    // 回放模式下跳到下标 index 处继续读取，丢弃已缓冲的前瞻
+    void seek(size_t index);
+
+    // 最近一次被消费的 token（仍留在环形缓冲区中 head_ 之前的槽位）
+    const Token &previous() const
+    {
+        return ring_[(head_ - 1) & mask_];
+    }
+
+private:
+    static constexpr size_t kInitialCapacity = 8; // 必须为 2 的幂
+
+    Lexer *lexer_;                      // 流式模式的数据来源
+    const TokenBuffer *tokens_;         // 回放模式的数据来源
+    size_t replayPosition_;             // 回放模式下一个待读取的下标
+    size_t replayEnd_;                  // 回放模式的结束下标（不含）
+
+    // 环形缓冲区，容量为 2 的幂；token 直接在槽位中构造，之后只以引用访问。
+    // 始终空出一个槽位，使 head_ 之前刚被消费的 token 不会被覆盖
+    std::vector<Token> ring_;
+    size_t mask_;             // ring_.size() - 1
+    size_t head_;             // 当前 token 在 ring_ 中的位置
+    size_t count_;            // 缓冲区中尚未消费的 token 数
+    Token endOfFile_;         // 输入结束后重复返回的 END_OF_FILE
+    bool exhausted_;
+
+    void fetch(Token &slot);
+    void fill(size_t count);
+    void grow();
+};
+
+#endif // TOKENSTREAM_H
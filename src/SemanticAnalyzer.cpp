@@ -1,23 +1,181 @@
 #include "SemanticAnalyzer.h"
+#include <algorithm>
 #include <iostream>
 
+namespace
+{
+    // 类型标注：int 右值
+    void markIntValue(Exp &node)
+    {
+        node.type_ = ExpType::Int;
+        node.isLValue_ = false;
+    }
+
+    // 类型标注：只有一个操作数的表达式层沿用操作数的标注，否则为 int 右值
+    void markLayer(Exp &node, llvm::ArrayRef<std::variant<Exp *, TokenType>> elements)
+    {
+        Exp *operand = elements.size() == 1 && std::holds_alternative<Exp *>(elements[0]) ? std::get<Exp *>(elements[0]) : nullptr;
+        if (operand)
+        {
+            node.type_ = operand->type_;
+            node.isLValue_ = operand->isLValue_;
+        }
+        else
+        {
+            markIntValue(node);
+        }
+    }
+
+    // 实参表达式只有一个操作数、不含运算时其中的 LVal，否则为空
+    const LVal *argumentLVal(Exp *exp)
+    {
+        while (exp)
+        {
+            if (auto *primary = llvm::dyn_cast<PrimaryExp>(exp))
+            {
+                if (std::holds_alternative<LVal *>(primary->operand_))
+                    return std::get<LVal *>(primary->operand_);
+                exp = std::holds_alternative<Exp *>(primary->operand_) ? std::get<Exp *>(primary->operand_) : nullptr;
+            }
+            else if (auto *unary = llvm::dyn_cast<UnaryExp>(exp))
+            {
+                exp = unary->op == UnaryExp::Op::Init ? unary->operand_ : nullptr;
+            }
+            else if (auto *lval = llvm::dyn_cast<LVal>(exp))
+            {
+                return lval;
+            }
+            else
+            {
+                llvm::ArrayRef<std::variant<Exp *, TokenType>> elements;
+                if (auto *add = llvm::dyn_cast<AddExp>(exp))
+                    elements = add->elements_;
+                else if (auto *mul = llvm::dyn_cast<MulExp>(exp))
+                    elements = mul->elements_;
+                else if (auto *rel = llvm::dyn_cast<RelExp>(exp))
+                    elements = rel->elements_;
+                else if (auto *eq = llvm::dyn_cast<EqExp>(exp))
+                    elements = eq->elements_;
+                else if (auto *land = llvm::dyn_cast<LAndExp>(exp))
+                    elements = land->elements_;
+                else if (auto *lor = llvm::dyn_cast<LOrExp>(exp))
+                    elements = lor->elements_;
+                exp = elements.size() == 1 && std::holds_alternative<Exp *>(elements[0]) ? std::get<Exp *>(elements[0]) : nullptr;
+            }
+        }
+        return nullptr;
+    }
+}
+
+SemanticAnalyzer::SemanticAnalyzer(SemanticAnalyzer &global, ErrorManager &errors)
+    : symbolTable(global.interner, global.symbolTable), errorManager(errors), interner(global.interner)
+{
+}
+
 // 遍历编译单元
 void SemanticAnalyzer::visit(CompUnit &node)
 {
-    // 处理全局声明
+    analyze(node, nullptr);
+}
+
+void SemanticAnalyzer::analyze(CompUnit &node, ThreadPool *pool)
+{
+    // 第一阶段：处理全局声明，登记全部函数签名
     for (auto &decl : node.decls_)
     {
-        decl->accept(*this);
+        visitNode(decl);
+    }
+    std::vector<ErrorManager> signatureErrors(node.funcDefs_.size());
+    for (size_t i = 0; i < node.funcDefs_.size(); ++i)
+    {
+        declareFunction(*node.funcDefs_[i], i, signatureErrors[i]);
+    }
+
+    // 第二阶段：处理函数体，主函数排在最后；按线程数分成连续的块，每块由一个函数体分析器依次检查
+    // 此后全局符号表只读，函数体分析器只登记局部符号，只写本块函数体内的语法树节点
+    size_t count = node.funcDefs_.size() + (node.mainfuncDef_ ? 1 : 0);
+    size_t chunks = std::min(count, pool ? pool->size() : size_t(1));
+    std::vector<ErrorManager> chunkErrors(chunks); // 各块的错误，函数体分析器只在本函数内写入
+    std::vector<std::future<void>> done;
+    for (size_t k = 0; k < chunks; ++k)
+    {
+        size_t first = count * k / chunks;
+        size_t last = count * (k + 1) / chunks;
+        bodyAnalyzers.push_back(std::unique_ptr<SemanticAnalyzer>(new SemanticAnalyzer(*this, chunkErrors[k])));
+        SemanticAnalyzer *body = bodyAnalyzers.back().get();
+        auto task = [body, &node, first, last, &signatureErrors]
+        { body->checkBodies(node, first, last, signatureErrors); };
+        if (pool)
+        {
+            done.push_back(pool->submit(task));
+        }
+        else
+        {
+            task();
+        }
+    }
+    // 等全部块结束后再转发异常，避免仍在运行的任务引用已销毁的局部变量
+    for (auto &future : done)
+    {
+        future.wait();
     }
-    // 处理函数定义
-    for (auto &funcDef : node.funcDefs_)
+    for (auto &future : done)
     {
-        funcDef->accept(*this);
+        future.get();
     }
-    // 处理主函数
-    if (node.mainfuncDef_)
+    for (auto &errors : chunkErrors)
+    {
+        errorManager.merge(errors);
+    }
+}
+
+void SemanticAnalyzer::checkBodies(CompUnit &node, size_t first, size_t last, std::vector<ErrorManager> &signatureErrors)
+{
+    for (size_t i = first; i < last; ++i)
     {
-        node.mainfuncDef_->accept(*this);
+        currentFunction = i;
+        if (i < node.funcDefs_.size())
+        {
+            errorManager.merge(signatureErrors[i]);
+            visitNode(node.funcDefs_[i]);
+        }
+        else
+        {
+            visitNode(node.mainfuncDef_);
+        }
+    }
+}
+
+Symbol *SemanticAnalyzer::resolve(SymbolId id) const
+{
+    Symbol *symbol = symbolTable.lookup(id);
+    if (symbol && symbol->symbolType_ == FUNCTION &&
+        static_cast<FunctionSymbol *>(symbol)->definitionOrder_ > currentFunction)
+    {
+        return nullptr;
+    }
+    return symbol;
+}
+
+void SemanticAnalyzer::declareFunctions(llvm::ArrayRef<FunctionPrototype> prototypes)
+{
+    for (const FunctionPrototype &prototype : prototypes)
+    {
+        // 同名函数在多个单元中定义时只登记一次，由链接阶段报告重复定义
+        SymbolId id = interner.intern(prototype.name_);
+        if (symbolTable.lookupInCurrentScope(id) != nullptr)
+        {
+            continue;
+        }
+        auto symbol = symbolTable.create<FunctionSymbol>();
+        symbol->name_ = prototype.name_;
+        symbol->id_ = id;
+        symbol->symbolType_ = FUNCTION;
+        symbol->dataType_ = prototype.returnsInt_ ? TokenType::KEYWORD_INT : TokenType::KEYWORD_VOID;
+        symbol->lineDefined_ = 0;
+        symbol->paramTypes_.assign(prototype.params_.size(), TokenType::KEYWORD_INT);
+        symbol->prototype_ = &prototype;
+        symbolTable.addSymbol(symbol);
     }
 }
 
@@ -37,10 +195,10 @@ void SemanticAnalyzer::visit(ConstDecl &node)
 
     for (auto &constDef : node.constDefs_)
     {
-        if (symbolTable.lookupInCurrentScope(constDef->name_) != nullptr)
+        if (symbolTable.lookupInCurrentScope(constDef->nameId_) != nullptr)
         {
             errorManager.addError(ErrorLevel::ERROR, 'b', 0,
-                                  "重复定义常量：" + constDef->name_,
+                                  {"重复定义常量：{0}", constDef->name_},
                                   ErrorType::SemanticError);
         }
         else
@@ -48,8 +206,9 @@ void SemanticAnalyzer::visit(ConstDecl &node)
             // 如果存在数组维度，说明该常量是数组
             if (!constDef->dimensions_.empty())
             {
-                auto arraySymbol = std::make_unique<ArraySymbol>();
+                auto arraySymbol = symbolTable.create<ArraySymbol>();
                 arraySymbol->name_ = constDef->name_;
+                arraySymbol->id_ = constDef->nameId_;
                 arraySymbol->symbolType_ = CONSTANT;
                 arraySymbol->dataType_ = TokenType::KEYWORD_INT;
                 arraySymbol->lineDefined_ = 0;
@@ -58,11 +217,11 @@ void SemanticAnalyzer::visit(ConstDecl &node)
                 // 计算数组维度，维度必须是常量表达式
                 for (auto &dimExp : constDef->dimensions_)
                 {
-                    int dimSize = evaluator.Eval(dimExp.get());
+                    int dimSize = evaluator.Eval(dimExp);
                     if (dimSize <= 0)
                     {
                         errorManager.addError(ErrorLevel::ERROR, 'c', 0,
-                                              "常量数组维度必须大于0：" + constDef->name_,
+                                              {"常量数组维度必须大于0：{0}", constDef->name_},
                                               ErrorType::SemanticError);
                     }
                     arraySymbol->dimensions_.push_back(dimSize);
@@ -73,9 +232,9 @@ void SemanticAnalyzer::visit(ConstDecl &node)
                 {
                     auto &initValues = constDef->initVal_;
                     // 判断是否符合数组初始化的要求
-                    if (std::holds_alternative<std::vector<std::unique_ptr<ConstInitVal>>>(initValues->value_))
+                    if (std::holds_alternative<llvm::ArrayRef<ConstInitVal *>>(initValues->value_))
                     {
-                        auto &initList = std::get<std::vector<std::unique_ptr<ConstInitVal>>>(initValues->value_);
+                        auto &initList = std::get<llvm::ArrayRef<ConstInitVal *>>(initValues->value_);
                         int totalElements = arraySymbol->dimensions_.size();
                         // for (size_t i = 0; i < arraySymbol->dimensions_.size(); ++i)
                         // {
@@ -85,7 +244,7 @@ void SemanticAnalyzer::visit(ConstDecl &node)
                         if (initList.size() != totalElements)
                         {
                             errorManager.addError(ErrorLevel::ERROR, 'd', 0,
-                                                  "常量数组初始化元素数量与维度不匹配：" + constDef->name_,
+                                                  {"常量数组初始化元素数量与维度不匹配：{0}", constDef->name_},
                                                   ErrorType::SemanticError);
                         }
 
@@ -104,23 +263,25 @@ void SemanticAnalyzer::visit(ConstDecl &node)
                     else
                     {
                         errorManager.addError(ErrorLevel::ERROR, 'e', 0,
-                                              "非数组初始化不能应用于常量数组：" + constDef->name_,
+                                              {"非数组初始化不能应用于常量数组：{0}", constDef->name_},
                                               ErrorType::SemanticError);
                     }
                 }
 
                 // 添加常量数组符号到符号表
-                if (!symbolTable.addSymbol(std::move(arraySymbol)))
+                constDef->symbol_ = symbolTable.addSymbol(arraySymbol);
+                if (!constDef->symbol_)
                 {
                     errorManager.addError(ErrorLevel::ERROR, 'n', 0,
-                                          "添加常量数组符号失败：" + constDef->name_,
+                                          {"添加常量数组符号失败：{0}", constDef->name_},
                                           ErrorType::SemanticError);
                 }
             }
             else // 处理普通常量
             {
-                auto symbol = std::make_unique<VariableSymbol>();
+                auto symbol = symbolTable.create<VariableSymbol>();
                 symbol->name_ = constDef->name_;
+                symbol->id_ = constDef->nameId_;
                 symbol->symbolType_ = CONSTANT;
                 symbol->dataType_ = TokenType::KEYWORD_INT;
                 symbol->lineDefined_ = 0;
@@ -129,18 +290,19 @@ void SemanticAnalyzer::visit(ConstDecl &node)
                 // 常量必须有初始化值，且必须能在编译时求值
                 try
                 {
-                    symbol->initValue_ = evaluator.Eval(constDef->initVal_.get());
+                    symbol->initValue_ = evaluator.Eval(constDef->initVal_);
                 }
                 catch (std::runtime_error &e)
                 {
                     errorManager.addError(ErrorLevel::ERROR, 'f', 0,
-                                          "常量求值失败：" + constDef->name_ + "，" + e.what(),
+                                          {"常量求值失败：{0}，{1}", constDef->name_, e.what()},
                                           ErrorType::SemanticError);
                 }
-                if (!symbolTable.addSymbol(std::move(symbol)))
+                constDef->symbol_ = symbolTable.addSymbol(symbol);
+                if (!constDef->symbol_)
                 {
                     errorManager.addError(ErrorLevel::ERROR, 'n', 0,
-                                          "添加常量符号失败：" + constDef->name_,
+                                          {"添加常量符号失败：{0}", constDef->name_},
                                           ErrorType::SemanticError);
                 }
             }
@@ -155,16 +317,17 @@ void SemanticAnalyzer::visit(VarDecl &node)
 
     for (auto &varDef : node.varDefs_)
     {
-        if (symbolTable.lookupInCurrentScope(varDef->name_) != nullptr)
+        if (symbolTable.lookupInCurrentScope(varDef->nameId_) != nullptr)
         {
             errorManager.addError(ErrorLevel::ERROR, 'b', 0,
-                                  "重复定义变量：" + varDef->name_,
+                                  {"重复定义变量：{0}", varDef->name_},
                                   ErrorType::SemanticError);
         }
         else
         {
-            auto symbol = std::make_unique<VariableSymbol>();
+            auto symbol = symbolTable.create<VariableSymbol>();
             symbol->name_ = varDef->name_;
+            symbol->id_ = varDef->nameId_;
             symbol->symbolType_ = VARIABLE;
             symbol->dataType_ = TokenType::KEYWORD_INT;
             symbol->lineDefined_ = 0;
@@ -174,8 +337,9 @@ void SemanticAnalyzer::visit(VarDecl &node)
             if (!varDef->constExps_.empty()) // 判断是否是数组
             {
                 // 数组符号
-                auto arraySymbol = std::make_unique<ArraySymbol>();
+                auto arraySymbol = symbolTable.create<ArraySymbol>();
                 arraySymbol->name_ = varDef->name_;
+                arraySymbol->id_ = varDef->nameId_;
                 arraySymbol->symbolType_ = ARRAY;
                 arraySymbol->dataType_ = TokenType::KEYWORD_INT;
                 arraySymbol->lineDefined_ = 0;
@@ -184,11 +348,11 @@ void SemanticAnalyzer::visit(VarDecl &node)
                 // 计算数组维度，维度必须是常量表达式
                 for (auto &dimExp : varDef->constExps_)
                 {
-                    int dimSize = evaluator.Eval(dimExp.get());
+                    int dimSize = evaluator.Eval(dimExp);
                     if (dimSize <= 0)
                     {
                         errorManager.addError(ErrorLevel::ERROR, 'c', 0,
-                                              "数组维度必须大于0：" + varDef->name_,
+                                              {"数组维度必须大于0：{0}", varDef->name_},
                                               ErrorType::SemanticError);
                     }
                     arraySymbol->dimensions_.push_back(dimSize);
@@ -199,9 +363,9 @@ void SemanticAnalyzer::visit(VarDecl &node)
                 {
                     auto &initValues = varDef->initVal_;
                     // 判断是否符合数组初始化的要求
-                    if (std::holds_alternative<std::vector<std::unique_ptr<InitVal>>>(initValues->value_))
+                    if (std::holds_alternative<llvm::ArrayRef<InitVal *>>(initValues->value_))
                     {
-                        auto &initList = std::get<std::vector<std::unique_ptr<InitVal>>>(initValues->value_);
+                        auto &initList = std::get<llvm::ArrayRef<InitVal *>>(initValues->value_);
                         int totalElements = arraySymbol->dimensions_.size();
                         // for (size_t i = 0; i < arraySymbol->dimensions_.size(); ++i)
                         // {
@@ -211,7 +375,7 @@ void SemanticAnalyzer::visit(VarDecl &node)
                         if (initList.size() != totalElements)
                         {
                             errorManager.addError(ErrorLevel::ERROR, 'd', 0,
-                                                  "数组初始化元素数量与维度不匹配：" + varDef->name_,
+                                                  {"数组初始化元素数量与维度不匹配：{0}", varDef->name_},
                                                   ErrorType::SemanticError);
                         }
 
@@ -230,16 +394,17 @@ void SemanticAnalyzer::visit(VarDecl &node)
                     else
                     {
                         errorManager.addError(ErrorLevel::ERROR, 'e', 0,
-                                              "非数组初始化不能应用于数组：" + varDef->name_,
+                                              {"非数组初始化不能应用于数组：{0}", varDef->name_},
                                               ErrorType::SemanticError);
                     }
                 }
 
                 // 添加数组符号到符号表
-                if (!symbolTable.addSymbol(std::move(arraySymbol)))
+                varDef->symbol_ = symbolTable.addSymbol(arraySymbol);
+                if (!varDef->symbol_)
                 {
                     errorManager.addError(ErrorLevel::ERROR, 'n', 0,
-                                          "添加数组符号失败：" + varDef->name_,
+                                          {"添加数组符号失败：{0}", varDef->name_},
                                           ErrorType::SemanticError);
                 }
             }
@@ -247,12 +412,13 @@ void SemanticAnalyzer::visit(VarDecl &node)
             {
                 if (varDef->hasInit)
                 {
-                    symbol->initValue_ = evaluator.Eval(varDef->initVal_.get());
+                    symbol->initValue_ = evaluator.Eval(varDef->initVal_);
                 }
-                if (!symbolTable.addSymbol(std::move(symbol)))
+                varDef->symbol_ = symbolTable.addSymbol(symbol);
+                if (!varDef->symbol_)
                 {
                     errorManager.addError(ErrorLevel::ERROR, 'n', 0,
-                                          "添加变量符号失败：" + varDef->name_,
+                                          {"添加变量符号失败：{0}", varDef->name_},
                                           ErrorType::SemanticError);
                 }
             }
@@ -270,16 +436,16 @@ void SemanticAnalyzer::visit(BType &node)
 void SemanticAnalyzer::visit(InitVal &node)
 {
     // 如果是表达式，直接检查；如果是数组初始化列表，递归处理每个子 InitVal
-    if (std::holds_alternative<std::unique_ptr<Exp>>(node.value_))
+    if (std::holds_alternative<Exp *>(node.value_))
     {
-        std::get<std::unique_ptr<Exp>>(node.value_)->accept(*this);
+        visitNode(std::get<Exp *>(node.value_));
     }
     else
     {
-        auto &list = std::get<std::vector<std::unique_ptr<InitVal>>>(node.value_);
+        auto &list = std::get<llvm::ArrayRef<InitVal *>>(node.value_);
         for (auto &elem : list)
         {
-            elem->accept(*this);
+            visitNode(elem);
         }
     }
 }
@@ -287,57 +453,63 @@ void SemanticAnalyzer::visit(InitVal &node)
 // 处理常量初始化值（同 InitVal 处理方式类似，但要求其表达式能在编译期求值）
 void SemanticAnalyzer::visit(ConstInitVal &node)
 {
-    if (std::holds_alternative<std::unique_ptr<Exp>>(node.value_))
+    if (std::holds_alternative<Exp *>(node.value_))
     {
-        std::get<std::unique_ptr<Exp>>(node.value_)->accept(*this);
+        visitNode(std::get<Exp *>(node.value_));
     }
     else
     {
-        auto &list = std::get<std::vector<std::unique_ptr<ConstInitVal>>>(node.value_);
+        auto &list = std::get<llvm::ArrayRef<ConstInitVal *>>(node.value_);
         for (auto &elem : list)
         {
-            elem->accept(*this);
+            visitNode(elem);
         }
     }
 }
 
 // --- 函数与形参 ---
-// 处理函数定义
-void SemanticAnalyzer::visit(FuncDef &node)
+// 登记函数签名
+void SemanticAnalyzer::declareFunction(FuncDef &node, size_t order, ErrorManager &errors)
 {
     // 在当前作用域中检查函数是否已定义
-    if (symbolTable.lookupInCurrentScope(node.name_) != nullptr)
+    if (symbolTable.lookupInCurrentScope(node.nameId_) != nullptr)
     {
-        errorManager.addError(ErrorLevel::ERROR, 'b', 0, "重复定义函数：" + node.name_, ErrorType::SemanticError);
+        errors.addError(ErrorLevel::ERROR, 'b', 0, {"重复定义函数：{0}", node.name_}, ErrorType::SemanticError);
     }
     else
     {
-        auto symbol = std::make_unique<FunctionSymbol>();
+        auto symbol = symbolTable.create<FunctionSymbol>();
         symbol->name_ = node.name_;
+        symbol->id_ = node.nameId_;
         symbol->symbolType_ = FUNCTION;
         // 根据函数返回类型来设置 dataType_，此处简单处理为 int 或 void
         symbol->dataType_ = (node.returnType_->typeName_ == "int") ? TokenType::KEYWORD_INT : TokenType::KEYWORD_VOID;
         symbol->lineDefined_ = 0;
+        symbol->definitionOrder_ = order;
         // 收集参数类型（这里只以 int 为例）
-        for (auto &param : node.params_)
+        for (size_t i = 0; i < node.params_.size(); ++i)
         {
-            param->accept(*this); // 处理形参时也可以加入符号表
             symbol->paramTypes_.push_back(TokenType::KEYWORD_INT);
         }
-        if (!symbolTable.addSymbol(std::move(symbol)))
+        node.symbol_ = symbolTable.addSymbol(symbol);
+        if (!node.symbol_)
         {
-            errorManager.addError(ErrorLevel::ERROR, 'n', 0, "添加函数符号失败：" + node.name_, ErrorType::SemanticError);
+            errors.addError(ErrorLevel::ERROR, 'n', 0, {"添加函数符号失败：{0}", node.name_}, ErrorType::SemanticError);
         }
     }
-    // 进入函数新作用域，添加形参符号
+}
+
+// 处理函数定义（签名已由 declareFunction 登记）
+void SemanticAnalyzer::visit(FuncDef &node)
+{
+    // 进入函数新作用域，添加形参符号；各函数的形参互不冲突，函数体中的引用解析到本函数的形参
     symbolTable.enterScope();
     for (auto &param : node.params_)
     {
-        // 这里可以将每个形参添加到符号表中，类似 VarDecl 的处理
-        // …（略）
+        visitNode(param);
     }
     // 处理函数体
-    node.body_->accept(*this);
+    visitNode(node.body_);
     symbolTable.exitScope();
 }
 
@@ -345,7 +517,7 @@ void SemanticAnalyzer::visit(FuncDef &node)
 void SemanticAnalyzer::visit(MainFuncDef &node)
 {
     // symbolTable.enterScope();
-    node.body_->accept(*this);
+    visitNode(node.body_);
     // symbolTable.exitScope();
 }
 
@@ -353,21 +525,48 @@ void SemanticAnalyzer::visit(MainFuncDef &node)
 void SemanticAnalyzer::visit(FuncParam &node)
 {
     // 例如，检查形参名是否重复（在函数内部作用域中由 FuncDef 添加）
-    if (symbolTable.lookupInCurrentScope(node.name_) != nullptr)
+    if (symbolTable.lookupInCurrentScope(node.nameId_) != nullptr)
     {
-        errorManager.addError(ErrorLevel::ERROR, 'b', 0, "重复定义函数参数：" + node.name_, ErrorType::SemanticError);
+        errorManager.addError(ErrorLevel::ERROR, 'b', 0, {"重复定义函数参数：{0}", node.name_}, ErrorType::SemanticError);
     }
     else
     {
-        auto symbol = std::make_unique<VariableSymbol>();
+        Symbol *symbol = nullptr;
+        if (node.isArray_)
+        {
+            // 数组形参：首维未知记为 0，其余各维为常量表达式，与函数原型一致，求值失败时记为 0
+            auto arraySymbol = symbolTable.create<ArraySymbol>();
+            arraySymbol->isConst_ = false;
+            arraySymbol->dimensions_.push_back(0);
+            for (size_t i = 1; i < node.dimSizes_.size(); ++i)
+            {
+                int dimSize = 0;
+                try
+                {
+                    dimSize = evalConstant.Eval(node.dimSizes_[i]);
+                }
+                catch (std::runtime_error &)
+                {
+                }
+                arraySymbol->dimensions_.push_back(dimSize);
+            }
+            symbol = arraySymbol;
+        }
+        else
+        {
+            auto variableSymbol = symbolTable.create<VariableSymbol>();
+            variableSymbol->isConst_ = false;
+            symbol = variableSymbol;
+        }
         symbol->name_ = node.name_;
+        symbol->id_ = node.nameId_;
         symbol->symbolType_ = PARAM;
         symbol->dataType_ = TokenType::KEYWORD_INT;
         symbol->lineDefined_ = 0;
-        symbol->isConst_ = false;
-        if (!symbolTable.addSymbol(std::move(symbol)))
+        node.symbol_ = symbolTable.addSymbol(symbol);
+        if (!node.symbol_)
         {
-            errorManager.addError(ErrorLevel::ERROR, 'n', 0, "添加函数参数符号失败：" + node.name_, ErrorType::SemanticError);
+            errorManager.addError(ErrorLevel::ERROR, 'n', 0, {"添加函数参数符号失败：{0}", node.name_}, ErrorType::SemanticError);
         }
     }
 }
@@ -378,7 +577,7 @@ void SemanticAnalyzer::visit(ExpStmt &node)
 {
     if (node.exp_)
     {
-        node.exp_->accept(*this);
+        visitNode(node.exp_);
     }
 }
 
@@ -388,7 +587,7 @@ void SemanticAnalyzer::visit(Block &node)
     symbolTable.enterScope();
     for (auto &item : node.items_)
     {
-        item->accept(*this);
+        visitNode(item);
     }
     symbolTable.exitScope();
 }
@@ -396,43 +595,43 @@ void SemanticAnalyzer::visit(Block &node)
 // 块项（声明或语句）
 void SemanticAnalyzer::visit(BlockItem &node)
 {
-    node.item_->accept(*this);
+    visitNode(node.item_);
 }
 
 // 赋值语句
 void SemanticAnalyzer::visit(AssignStmt &node)
 {
     // 检查左值是否定义以及是否为可修改的变量
-    node.lval_->accept(*this);
-    Symbol *symbol = symbolTable.lookup(node.lval_->name_);
+    visitNode(node.lval_);
+    Symbol *symbol = node.lval_->symbol_;
     if (symbol == nullptr)
     {
-        errorManager.addError(ErrorLevel::ERROR, 'b', 0, "赋值语句中未定义的变量：" + node.lval_->name_, ErrorType::SemanticError);
+        errorManager.addError(ErrorLevel::ERROR, 'b', 0, {"赋值语句中未定义的变量：{0}", node.lval_->name_}, ErrorType::SemanticError);
     }
     else if (symbol->symbolType_ == CONSTANT)
     {
-        errorManager.addError(ErrorLevel::ERROR, 'b', 0, "不能修改常量：" + node.lval_->name_, ErrorType::SemanticError);
+        errorManager.addError(ErrorLevel::ERROR, 'b', 0, {"不能修改常量：{0}", node.lval_->name_}, ErrorType::SemanticError);
     }
     // 检查右侧表达式
-    node.exp_->accept(*this);
+    visitNode(node.exp_);
 }
 
 // If 语句
 void SemanticAnalyzer::visit(IfStmt &node)
 {
-    node.cond_->accept(*this);
-    node.thenBranch_->accept(*this);
+    visitNode(node.cond_);
+    visitNode(node.thenBranch_);
     if (node.elseBranch_)
     {
-        node.elseBranch_->accept(*this);
+        visitNode(node.elseBranch_);
     }
 }
 
 // while 语句
 void SemanticAnalyzer::visit(WhileStmt &node)
 {
-    node.cond_->accept(*this);
-    node.body_->accept(*this);
+    visitNode(node.cond_);
+    visitNode(node.body_);
 }
 
 // return 语句
@@ -440,7 +639,7 @@ void SemanticAnalyzer::visit(ReturnStmt &node)
 {
     if (node.exp_)
     {
-        node.exp_->accept(*this);
+        visitNode(node.exp_);
     }
     // 这里还可以检查返回值类型是否与函数声明匹配
 }
@@ -450,22 +649,22 @@ void SemanticAnalyzer::visit(IOStmt &node)
 {
     if (node.kind == IOStmt::IOKind::Getint)
     {
-        node.target_->accept(*this);
-        Symbol *symbol = symbolTable.lookup(node.target_->name_);
+        visitNode(node.target_);
+        Symbol *symbol = node.target_->symbol_;
         if (symbol == nullptr)
         {
-            errorManager.addError(ErrorLevel::ERROR, 'b', 0, "getint中未定义的变量：" + node.target_->name_, ErrorType::SemanticError);
+            errorManager.addError(ErrorLevel::ERROR, 'b', 0, {"getint中未定义的变量：{0}", node.target_->name_}, ErrorType::SemanticError);
         }
         if (symbol && symbol->symbolType_ == CONSTANT)
         {
-            errorManager.addError(ErrorLevel::ERROR, 'b', 0, "不能使用getint修改常量：" + node.target_->name_, ErrorType::SemanticError);
+            errorManager.addError(ErrorLevel::ERROR, 'b', 0, {"不能使用getint修改常量：{0}", node.target_->name_}, ErrorType::SemanticError);
         }
     }
     else
     { // Printf
         for (auto &arg : node.args_)
         {
-            arg->accept(*this);
+            visitNode(arg);
         }
         // 还可以检查格式字符串与参数个数是否匹配
     }
@@ -476,29 +675,57 @@ void SemanticAnalyzer::visit(IOStmt &node)
 void SemanticAnalyzer::visit(Number &node)
 {
     // 数值直接通过，不用做检查
+    markIntValue(node);
 }
 
 // 左值
 void SemanticAnalyzer::visit(LVal &node)
 {
-    Symbol *symbol = symbolTable.lookup(node.name_);
+    Symbol *symbol = resolve(node.nameId_);
+    node.symbol_ = symbol;
     if (symbol == nullptr)
     {
         errorManager.addError(ErrorLevel::ERROR, 'g', 0,
-                              "使用了未定义的变量：" + node.name_,
+                              {"使用了未定义的变量：{0}", node.name_},
                               ErrorType::SemanticError);
     }
     else
     {
+        // 类型标注：下标取满时为 int 元素（左值）；否则为数组的一部分，数组形参不带下标时为指针
+        if (symbol->isArray_)
+        {
+            size_t rank = static_cast<ArraySymbol *>(symbol)->dimensions_.size();
+            size_t indexed = node.indices_.size();
+            if (indexed >= rank)
+            {
+                node.type_ = ExpType::Int;
+                node.isLValue_ = true;
+            }
+            else if (indexed == 0 && symbol->symbolType_ == PARAM)
+            {
+                node.type_ = ExpType(ExpType::Pointer, rank);
+            }
+            else
+            {
+                node.type_ = ExpType(ExpType::Array, rank - indexed);
+            }
+        }
+        else if (symbol->symbolType_ != FUNCTION)
+        {
+            node.type_ = ExpType::Int;
+            node.isLValue_ = true;
+        }
+
         // 如果符号为数组，则检查下标数量
         if (symbol->symbolType_ == ARRAY)
         {
-            // 假设 ArraySymbol 在符号表中，需向下转型
-            auto arraySymbol = dynamic_cast<ArraySymbol *>(symbol);
-            if (node.indices_.size() != arraySymbol->dimensions_.size())
+            // symbolType_ 为 ARRAY 的符号只由 ArraySymbol 创建
+            auto arraySymbol = static_cast<ArraySymbol *>(symbol);
+            if (node.indices_.size() > arraySymbol->dimensions_.size() ||
+                (node.indices_.size() < arraySymbol->dimensions_.size() && &node != arrayArgument))
             {
                 errorManager.addError(ErrorLevel::ERROR, 'h', 0,
-                                      "数组下标个数与声明不匹配：" + node.name_,
+                                      {"数组下标个数与声明不匹配：{0}", node.name_},
                                       ErrorType::SemanticError);
             }
             else
@@ -510,38 +737,27 @@ void SemanticAnalyzer::visit(LVal &node)
                     int indexValue = 0;
                     try
                     {
-                        indexValue = evaluator.Eval(node.indices_[i].get());
+                        indexValue = evaluator.Eval(node.indices_[i]);
                     }
                     catch (std::runtime_error &e)
                     {
                         errorManager.addError(ErrorLevel::ERROR, 'i', 0,
-                                              "数组下标不能求值为常量：" + node.name_ + ", " + e.what(),
+                                              {"数组下标不能求值为常量：{0}, {1}", node.name_, e.what()},
                                               ErrorType::SemanticError);
                     }
                     if (indexValue < 0 || indexValue >= arraySymbol->dimensions_[i])
                     {
                         errorManager.addError(ErrorLevel::ERROR, 'j', 0,
-                                              "数组下标越界：" + node.name_,
+                                              {"数组下标越界：{0}", node.name_},
                                               ErrorType::SemanticError);
                     }
                 }
             }
         }
-        else
-        {
-            // 对于标量变量，检查是否为常量
-            if (symbol->symbolType_ == CONSTANT)
-            {
-                return;
-                errorManager.addError(ErrorLevel::ERROR, 'k', 0,
-                                      "不能修改常量：" + node.name_,
-                                      ErrorType::SemanticError);
-            }
-        }
-        // 对于标量变量的访问，仅需检查变量是否存在即可
+        // 下标表达式同样需要检查与标注（常量数组的下标也不例外）
         for (auto &index : node.indices_)
         {
-            index->accept(*this);
+            visitNode(index);
         }
     }
 }
@@ -549,23 +765,30 @@ void SemanticAnalyzer::visit(LVal &node)
 // 基本表达式
 void SemanticAnalyzer::visit(PrimaryExp &node)
 {
-    if (std::holds_alternative<std::unique_ptr<Exp>>(node.operand_))
+    if (std::holds_alternative<Exp *>(node.operand_))
     {
-        auto &child = std::get<std::unique_ptr<Exp>>(node.operand_);
+        auto &child = std::get<Exp *>(node.operand_);
         if (child)
-            child->accept(*this);
+            visitNode(child);
     }
-    else if (std::holds_alternative<std::unique_ptr<LVal>>(node.operand_))
+    else if (std::holds_alternative<LVal *>(node.operand_))
     {
-        auto &child = std::get<std::unique_ptr<LVal>>(node.operand_);
+        auto &child = std::get<LVal *>(node.operand_);
         if (child)
-            child->accept(*this);
+            visitNode(child);
     }
-    else if (std::holds_alternative<std::unique_ptr<Number>>(node.operand_))
+    else if (std::holds_alternative<Number *>(node.operand_))
     {
-        auto &child = std::get<std::unique_ptr<Number>>(node.operand_);
+        auto &child = std::get<Number *>(node.operand_);
         if (child)
-            child->accept(*this);
+            visitNode(child);
+    }
+    // 沿用操作数的类型标注
+    Exp *operand = std::visit([](auto *child) -> Exp * { return child; }, node.operand_);
+    if (operand)
+    {
+        node.type_ = operand->type_;
+        node.isLValue_ = operand->isLValue_;
     }
 }
 
@@ -573,7 +796,17 @@ void SemanticAnalyzer::visit(PrimaryExp &node)
 void SemanticAnalyzer::visit(UnaryExp &node)
 {
     // 1. 根据 variant 的实际类型，分发到对应的子节点
-    node.operand_->accept(*this);
+    visitNode(node.operand_);
+    // 没有运算符时沿用操作数的类型标注
+    if (node.op == UnaryExp::Op::Init && node.operand_)
+    {
+        node.type_ = node.operand_->type_;
+        node.isLValue_ = node.operand_->isLValue_;
+    }
+    else
+    {
+        markIntValue(node);
+    }
 }
 
 // 加法表达式（同理适用于其他二元表达式）
@@ -581,97 +814,109 @@ void SemanticAnalyzer::visit(AddExp &node)
 {
     for (auto &elem : node.elements_)
     {
-        if (std::holds_alternative<std::unique_ptr<Exp>>(elem))
+        if (std::holds_alternative<Exp *>(elem))
         {
-            auto &child = std::get<std::unique_ptr<Exp>>(elem);
+            auto &child = std::get<Exp *>(elem);
             if (child)
-                child->accept(*this);
+                visitNode(child);
         }
         // 运算符的部分一般只作为标记，无需遍历
     }
+    markLayer(node, node.elements_);
 }
 
 void SemanticAnalyzer::visit(MulExp &node)
 {
     for (auto &elem : node.elements_)
     {
-        if (std::holds_alternative<std::unique_ptr<Exp>>(elem))
+        if (std::holds_alternative<Exp *>(elem))
         {
-            auto &child = std::get<std::unique_ptr<Exp>>(elem);
+            auto &child = std::get<Exp *>(elem);
             if (child)
-                child->accept(*this);
+                visitNode(child);
         }
     }
+    markLayer(node, node.elements_);
 }
 
 void SemanticAnalyzer::visit(LOrExp &node)
 {
     for (auto &elem : node.elements_)
     {
-        if (std::holds_alternative<std::unique_ptr<Exp>>(elem))
+        if (std::holds_alternative<Exp *>(elem))
         {
-            auto &child = std::get<std::unique_ptr<Exp>>(elem);
+            auto &child = std::get<Exp *>(elem);
             if (child)
-                child->accept(*this);
+                visitNode(child);
         }
     }
+    // 代码生成总是把结果归一化为 0/1
+    markIntValue(node);
 }
 
 void SemanticAnalyzer::visit(LAndExp &node)
 {
     for (auto &elem : node.elements_)
     {
-        if (std::holds_alternative<std::unique_ptr<Exp>>(elem))
+        if (std::holds_alternative<Exp *>(elem))
         {
-            auto &child = std::get<std::unique_ptr<Exp>>(elem);
+            auto &child = std::get<Exp *>(elem);
             if (child)
-                child->accept(*this);
+                visitNode(child);
         }
     }
+    // 代码生成总是把结果归一化为 0/1
+    markIntValue(node);
 }
 
 void SemanticAnalyzer::visit(EqExp &node)
 {
     for (auto &elem : node.elements_)
     {
-        if (std::holds_alternative<std::unique_ptr<Exp>>(elem))
+        if (std::holds_alternative<Exp *>(elem))
         {
-            auto &child = std::get<std::unique_ptr<Exp>>(elem);
+            auto &child = std::get<Exp *>(elem);
             if (child)
-                child->accept(*this);
+                visitNode(child);
         }
     }
+    markLayer(node, node.elements_);
 }
 
 void SemanticAnalyzer::visit(RelExp &node)
 {
     for (auto &elem : node.elements_)
     {
-        if (std::holds_alternative<std::unique_ptr<Exp>>(elem))
+        if (std::holds_alternative<Exp *>(elem))
         {
-            auto &child = std::get<std::unique_ptr<Exp>>(elem);
+            auto &child = std::get<Exp *>(elem);
             if (child)
-                child->accept(*this);
+                visitNode(child);
         }
     }
+    markLayer(node, node.elements_);
 }
 
 // 函数调用表达式
 void SemanticAnalyzer::visit(CallExp &node)
 {
-    Symbol *symbol = symbolTable.lookup(node.funcName);
+    Symbol *symbol = resolve(node.funcId_);
+    node.symbol_ = symbol;
     if (symbol == nullptr)
     {
-        errorManager.addError(ErrorLevel::ERROR, 'b', 0, "调用未定义的函数：" + node.funcName, ErrorType::SemanticError);
+        errorManager.addError(ErrorLevel::ERROR, 'b', 0, {"调用未定义的函数：{0}", node.funcName}, ErrorType::SemanticError);
     }
     else if (symbol->symbolType_ != FUNCTION)
     {
-        errorManager.addError(ErrorLevel::ERROR, 'b', 0, "标识符不是函数：" + node.funcName, ErrorType::SemanticError);
+        errorManager.addError(ErrorLevel::ERROR, 'b', 0, {"标识符不是函数：{0}", node.funcName}, ErrorType::SemanticError);
     }
     for (auto &arg : node.args_)
     {
-        arg->accept(*this);
+        arrayArgument = argumentLVal(arg);
+        visitNode(arg);
     }
+    arrayArgument = nullptr;
+    markIntValue(node);
 }
 
 void SemanticAnalyzer::visit(FuncType &)
@@ -683,15 +928,15 @@ void SemanticAnalyzer::visit(FuncType &)
 int SemanticAnalyzer::evaluateConstExp(ConstInitVal *initVal)
 {
     // 如果是单个表达式，则尝试递归求值
-    if (std::holds_alternative<std::unique_ptr<Exp>>(initVal->value_))
+    if (std::holds_alternative<Exp *>(initVal->value_))
     {
         // 例如：如果该表达式仅为数字字面量，则返回其值
-        auto &expPtr = std::get<std::unique_ptr<Exp>>(initVal->value_);
+        auto &expPtr = std::get<Exp *>(initVal->value_);
         if (expPtr)
         {
             // 此处仅作演示，假定 Exp 最终能返回 Number 的值
             // 你可以实现一个专门的常量求值器
-            return evaluateExp(expPtr.get());
+            return evaluateExp(expPtr);
         }
     }
     // 数组初始化或其他情况暂返回0
@@ -704,20 +949,19 @@ int SemanticAnalyzer::evaluateExp(Node *node)
     return evalConstant.Eval(node);
 }
 
-bool SemanticAnalyzer::checkAndEvaluateInitList(const std::vector<std::unique_ptr<InitVal>> &initList,
+bool SemanticAnalyzer::checkAndEvaluateInitList(const llvm::ArrayRef<InitVal *> &initList,
                                                 const std::vector<int> &dimensions,
                                                 size_t currentDim,
                                                 EvalConstant &evaluator,
                                                 std::vector<int> &evaluatedValues,
                                                 ErrorManager &errorManager,
-                                                const std::string &varName)
+                                                std::string_view varName)
 {
     // 当前层次应有 dimensions[currentDim] 个元素
     if (initList.size() != dimensions[currentDim])
     {
         errorManager.addError(ErrorLevel::ERROR, 'k', 0,
-                              "数组初始化列表第" + std::to_string(currentDim + 1) +
-                                  "维元素数量与声明不匹配：" + varName,
+                              {"数组初始化列表第{1}维元素数量与声明不匹配：{0}", varName, std::to_string(currentDim + 1)},
                               ErrorType::SemanticError);
         return false;
     }
@@ -728,13 +972,13 @@ bool SemanticAnalyzer::checkAndEvaluateInitList(const std::vector<std::unique_pt
         {
             try
             {
-                int value = evaluator.Eval(elem.get());
+                int value = evaluator.Eval(elem);
                 evaluatedValues.push_back(value);
             }
             catch (std::runtime_error &e)
             {
                 errorManager.addError(ErrorLevel::ERROR, 'l', 0,
-                                      "数组初始化元素求值失败：" + varName + ", " + e.what(),
+                                      {"数组初始化元素求值失败：{0}, {1}", varName, e.what()},
                                       ErrorType::SemanticError);
                 return false;
             }
@@ -746,9 +990,9 @@ bool SemanticAnalyzer::checkAndEvaluateInitList(const std::vector<std::unique_pt
         for (auto &elem : initList)
         {
             // 判断是否为列表
-            if (std::holds_alternative<std::vector<std::unique_ptr<InitVal>>>(elem->value_))
+            if (std::holds_alternative<llvm::ArrayRef<InitVal *>>(elem->value_))
             {
-                auto &subList = std::get<std::vector<std::unique_ptr<InitVal>>>(elem->value_);
+                auto &subList = std::get<llvm::ArrayRef<InitVal *>>(elem->value_);
                 if (!checkAndEvaluateInitList(subList, dimensions, currentDim + 1,
                                               evaluator, evaluatedValues, errorManager, varName))
                 {
@@ -758,7 +1002,7 @@ bool SemanticAnalyzer::checkAndEvaluateInitList(const std::vector<std::unique_pt
             else
             {
                 errorManager.addError(ErrorLevel::ERROR, 'm', 0,
-                                      "数组初始化列表嵌套错误：" + varName,
+                                      {"数组初始化列表嵌套错误：{0}", varName},
                                       ErrorType::SemanticError);
                 return false;
             }
@@ -767,20 +1011,19 @@ bool SemanticAnalyzer::checkAndEvaluateInitList(const std::vector<std::unique_pt
     return true;
 }
 
-bool SemanticAnalyzer::checkAndEvaluateConstInitList(const std::vector<std::unique_ptr<ConstInitVal>> &initList,
+bool SemanticAnalyzer::checkAndEvaluateConstInitList(const llvm::ArrayRef<ConstInitVal *> &initList,
                                                      const std::vector<int> &dimensions,
                                                      size_t currentDim,
                                                      EvalConstant &evaluator,
                                                      std::vector<int> &evaluatedValues,
                                                      ErrorManager &errorManager,
-                                                     const std::string &varName)
+                                                     std::string_view varName)
 {
     // 当前层次应有 dimensions[currentDim] 个元素
     if (initList.size() != dimensions[currentDim])
     {
         errorManager.addError(ErrorLevel::ERROR, 'k', 0,
-                              "常量数组初始化列表第" + std::to_string(currentDim + 1) +
-                                  "维元素数量与声明不匹配：" + varName,
+                              {"常量数组初始化列表第{1}维元素数量与声明不匹配：{0}", varName, std::to_string(currentDim + 1)},
                               ErrorType::SemanticError);
         return false;
     }
@@ -791,13 +1034,13 @@ bool SemanticAnalyzer::checkAndEvaluateConstInitList(const std::vector<std::uniq
         {
             try
             {
-                int value = evaluator.Eval(elem.get());
+                int value = evaluator.Eval(elem);
                 evaluatedValues.push_back(value);
             }
             catch (std::runtime_error &e)
             {
                 errorManager.addError(ErrorLevel::ERROR, 'l', 0,
-                                      "常量数组初始化元素求值失败：" + varName + ", " + e.what(),
+                                      {"常量数组初始化元素求值失败：{0}, {1}", varName, e.what()},
                                       ErrorType::SemanticError);
                 return false;
             }
@@ -809,9 +1052,9 @@ bool SemanticAnalyzer::checkAndEvaluateConstInitList(const std::vector<std::uniq
         for (auto &elem : initList)
         {
             // 判断是否为列表
-            if (std::holds_alternative<std::vector<std::unique_ptr<ConstInitVal>>>(elem->value_))
+            if (std::holds_alternative<llvm::ArrayRef<ConstInitVal *>>(elem->value_))
             {
-                auto &subList = std::get<std::vector<std::unique_ptr<ConstInitVal>>>(elem->value_);
+                auto &subList = std::get<llvm::ArrayRef<ConstInitVal *>>(elem->value_);
                 if (!checkAndEvaluateConstInitList(subList, dimensions, currentDim + 1,
                                                    evaluator, evaluatedValues, errorManager, varName))
                 {
@@ -821,7 +1064,7 @@ bool SemanticAnalyzer::checkAndEvaluateConstInitList(const std::vector<std::uniq
             else
             {
                 errorManager.addError(ErrorLevel::ERROR, 'm', 0,
-                                      "常量数组初始化列表嵌套错误：" + varName,
+                                      {"常量数组初始化列表嵌套错误：{0}", varName},
                                       ErrorType::SemanticError);
                 return false;
             }
@@ -0,0 +1,128 @@
+#include "astCache.h"
+#include "cacheFile.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <cstring>
+
+namespace
+{
+    constexpr char kMagic[4] = {'C', 'C', 'L', 'A'};
+
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint64_t sourceHash;
+        uint64_t sourceSize;
+        uint32_t nodeCount;
+        uint32_t symbolCount;
+        uint32_t stringCount;
+        uint32_t reserved;
+    };
+
+    // value_ 为驻留编号的节点
+    bool isNamed(AST::Node::Kind kind)
+    {
+        switch (kind)
+        {
+        case AST::Node::ND_ConstDef:
+        case AST::Node::ND_VarDef:
+        case AST::Node::ND_FuncParam:
+        case AST::Node::ND_FuncDef:
+        case AST::Node::ND_LVal:
+        case AST::Node::ND_CallExp:
+            return true;
+        default:
+            return false;
+        }
+    }
+}
+
+AstCache::AstCache(std::string directory) : directory_(std::move(directory)) {}
+
+std::string AstCache::pathFor(std::string_view source) const
+{
+    return cachefile::pathFor(directory_, source, ".ast");
+}
+
+AST::CompUnit *AstCache::load(std::string_view source, AST::AstArena &arena, StringInterner &interner) const
+{
+    llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> file =
+        llvm::MemoryBuffer::getFile(pathFor(source), /*IsText=*/false, /*RequiresNullTerminator=*/false);
+    if (!file)
+    {
+        return nullptr;
+    }
+
+    cachefile::Reader reader((*file)->getBuffer());
+    Header header;
+    reader.read(&header, sizeof(header));
+    if (reader.failed() || std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+        header.sourceSize != source.size() || header.sourceHash != cachefile::hash(source))
+    {
+        return nullptr;
+    }
+
+    AST::FlatAst ast;
+    reader.readArray(ast.nodes_, header.nodeCount);
+    // 编号 0 为 kNoSymbol，文件中的第 i 个拼写对应旧编号 i + 1
+    std::vector<std::string_view> spellings;
+    for (uint32_t i = 0; i < header.symbolCount && !reader.failed(); ++i)
+    {
+        spellings.push_back(reader.readString());
+    }
+    for (uint32_t i = 0; i < header.stringCount && !reader.failed(); ++i)
+    {
+        ast.strings_.push_back(reader.readString());
+    }
+    if (!reader.complete())
+    {
+        return nullptr;
+    }
+
+    // 全新的驻留表按相同顺序驻留后编号不变，与重新扫描得到的编号一致
+    std::vector<SymbolId> remap(spellings.size() + 1, kNoSymbol);
+    for (size_t i = 0; i < spellings.size(); ++i)
+    {
+        remap[i + 1] = interner.intern(spellings[i]);
+    }
+    for (AST::FlatNode &node : ast.nodes_)
+    {
+        if (isNamed(node.kind()))
+        {
+            SymbolId id = static_cast<SymbolId>(node.value_);
+            if (id >= remap.size())
+            {
+                return nullptr;
+            }
+            node.value_ = static_cast<int32_t>(remap[id]);
+        }
+    }
+    // 格式串在重建时复制到 arena，之后不再引用缓存文件
+    return ast.materialize(arena, interner);
+}
+
+bool AstCache::store(std::string_view source, AST::CompUnit &program, const StringInterner &interner) const
+{
+    AST::FlatAst ast = AST::FlatAst::build(program);
+    return cachefile::writeAtomically(directory_, pathFor(source), [&](llvm::raw_ostream &os) {
+        Header header;
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.sourceHash = cachefile::hash(source);
+        header.sourceSize = source.size();
+        header.nodeCount = ast.size();
+        header.symbolCount = static_cast<uint32_t>(interner.size() - 1);
+        header.stringCount = static_cast<uint32_t>(ast.strings_.size());
+        header.reserved = 0;
+        cachefile::writeValue(os, header);
+        cachefile::writeArray<AST::FlatNode>(os, ast.nodes_);
+        for (SymbolId id = 1; id < interner.size(); ++id)
+        {
+            cachefile::writeString(os, interner.spelling(id));
+        }
+        for (std::string_view text : ast.strings_)
+        {
+            cachefile::writeString(os, text);
+        }
+    });
+}
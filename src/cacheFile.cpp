@@ -0,0 +1,57 @@
+#include "cacheFile.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/xxhash.h"
+
+namespace cachefile
+{
+    std::string pathFor(std::string_view directory, std::string_view source, std::string_view extension)
+    {
+        llvm::SmallString<128> path(directory);
+        llvm::sys::path::append(path, llvm::utohexstr(hash(source), /*LowerCase=*/true, 16) + std::string(extension));
+        return std::string(path);
+    }
+
+    uint64_t hash(std::string_view source)
+    {
+        return llvm::xxHash64(source);
+    }
+
+    bool writeAtomically(const std::string &directory, const std::string &path,
+                         llvm::function_ref<void(llvm::raw_ostream &)> write)
+    {
+        if (llvm::sys::fs::create_directories(directory))
+        {
+            return false;
+        }
+
+        std::string temporary = path + ".tmp" + std::to_string(llvm::sys::Process::getProcessId());
+        {
+            std::error_code error;
+            llvm::raw_fd_ostream os(temporary, error);
+            if (error)
+            {
+                return false;
+            }
+            write(os);
+            os.close();
+            if (os.has_error())
+            {
+                os.clear_error();
+                llvm::sys::fs::remove(temporary);
+                return false;
+            }
+        }
+        return !llvm::sys::fs::rename(temporary, path);
+    }
+
+    void writeString(llvm::raw_ostream &os, std::string_view text)
+    {
+        uint32_t length = static_cast<uint32_t>(text.size());
+        writeValue(os, length);
+        os.write(text.data(), text.size());
+    }
+}
@@ -0,0 +1,271 @@
+#include "charScanner.h"
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CCL_SCANNER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace CharScanner
+{
+    namespace
+    {
+        // 与 "C" locale 下的 isspace 相同：' '、'\t'、'\n'、'\v'、'\f'、'\r'
+        inline bool isSpaceByte(unsigned char c)
+        {
+            return c == ' ' || static_cast<unsigned char>(c - '\t') <= '\r' - '\t';
+        }
+
+        // ---------------- 标量实现，同时负责向量实现剩余不足一块的尾部 ----------------
+
+        size_t skipWhitespaceScalar(std::string_view text, size_t pos)
+        {
+            while (pos < text.size() && isSpaceByte(text[pos]))
+            {
+                ++pos;
+            }
+            return pos;
+        }
+
+        size_t findLineEndScalar(std::string_view text, size_t pos)
+        {
+            while (pos < text.size() && text[pos] != '\n')
+            {
+                ++pos;
+            }
+            return pos;
+        }
+
+        size_t findCommentEndScalar(std::string_view text, size_t pos)
+        {
+            for (; pos < text.size(); ++pos)
+            {
+                if (text[pos] == '*' && pos + 1 < text.size() && text[pos + 1] == '/')
+                {
+                    return pos;
+                }
+            }
+            return text.size();
+        }
+
+        // ---------------- 按块扫描的通用流程，Block 提供一块字节的各类位掩码 ----------------
+
+        template <typename Block>
+        size_t skipWhitespaceBlocks(std::string_view text, size_t pos)
+        {
+            const char *data = text.data();
+            while (pos + Block::kWidth <= text.size())
+            {
+                uint32_t stop = ~Block::whitespaceMask(data + pos) & Block::kFullMask;
+                if (stop)
+                {
+                    return pos + __builtin_ctz(stop);
+                }
+                pos += Block::kWidth;
+            }
+            return skipWhitespaceScalar(text, pos);
+        }
+
+        template <typename Block>
+        size_t findLineEndBlocks(std::string_view text, size_t pos)
+        {
+            const char *data = text.data();
+            while (pos + Block::kWidth <= text.size())
+            {
+                uint32_t newlines = Block::byteMask(data + pos, '\n');
+                if (newlines)
+                {
+                    return pos + __builtin_ctz(newlines);
+                }
+                pos += Block::kWidth;
+            }
+            return findLineEndScalar(text, pos);
+        }
+
+        template <typename Block>
+        size_t findCommentEndBlocks(std::string_view text, size_t pos)
+        {
+            const char *data = text.data();
+            // '/' 的掩码错开一个字节读取，因此块之后还需有一个可读字节
+            while (pos + Block::kWidth < text.size())
+            {
+                uint32_t ends = Block::byteMask(data + pos, '*') & Block::byteMask(data + pos + 1, '/');
+                if (ends)
+                {
+                    return pos + __builtin_ctz(ends);
+                }
+                pos += Block::kWidth;
+            }
+            return findCommentEndScalar(text, pos);
+        }
+
+#ifdef CCL_SCANNER_X86
+        struct Sse2Block
+        {
+            static constexpr size_t kWidth = 16;
+            static constexpr uint32_t kFullMask = 0xFFFFu;
+
+            __attribute__((target("sse2"))) static uint32_t byteMask(const char *p, char c)
+            {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+                return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(c))));
+            }
+
+            __attribute__((target("sse2"))) static uint32_t whitespaceMask(const char *p)
+            {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+                __m128i space = _mm_cmpeq_epi8(block, _mm_set1_epi8(' '));
+                // '\t'..'\r'：减去 '\t' 后无符号不大于 4
+                __m128i offset = _mm_sub_epi8(block, _mm_set1_epi8('\t'));
+                __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8('\r' - '\t')), offset);
+                return static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(space, control)));
+            }
+        };
+
+        struct Avx2Block
+        {
+            static constexpr size_t kWidth = 32;
+            static constexpr uint32_t kFullMask = 0xFFFFFFFFu;
+
+            __attribute__((target("avx2"))) static uint32_t byteMask(const char *p, char c)
+            {
+                __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+                return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(c))));
+            }
+
+            __attribute__((target("avx2"))) static uint32_t whitespaceMask(const char *p)
+            {
+                __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+                __m256i space = _mm256_cmpeq_epi8(block, _mm256_set1_epi8(' '));
+                __m256i offset = _mm256_sub_epi8(block, _mm256_set1_epi8('\t'));
+                __m256i control = _mm256_cmpeq_epi8(_mm256_min_epu8(offset, _mm256_set1_epi8('\r' - '\t')), offset);
+                return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(space, control)));
+            }
+        };
+
+        // 入口函数带上目标指令集并展开全部调用，使掩码函数内联进扫描循环
+#define CCL_SCANNER_ENTRY(isa) __attribute__((target(isa), flatten))
+
+        CCL_SCANNER_ENTRY("sse2") size_t skipWhitespaceSse2(std::string_view text, size_t pos)
+        {
+            return skipWhitespaceBlocks<Sse2Block>(text, pos);
+        }
+        CCL_SCANNER_ENTRY("sse2") size_t findLineEndSse2(std::string_view text, size_t pos)
+        {
+            return findLineEndBlocks<Sse2Block>(text, pos);
+        }
+        CCL_SCANNER_ENTRY("sse2") size_t findCommentEndSse2(std::string_view text, size_t pos)
+        {
+            return findCommentEndBlocks<Sse2Block>(text, pos);
+        }
+
+        CCL_SCANNER_ENTRY("avx2") size_t skipWhitespaceAvx2(std::string_view text, size_t pos)
+        {
+            return skipWhitespaceBlocks<Avx2Block>(text, pos);
+        }
+        CCL_SCANNER_ENTRY("avx2") size_t findLineEndAvx2(std::string_view text, size_t pos)
+        {
+            return findLineEndBlocks<Avx2Block>(text, pos);
+        }
+        CCL_SCANNER_ENTRY("avx2") size_t findCommentEndAvx2(std::string_view text, size_t pos)
+        {
+            return findCommentEndBlocks<Avx2Block>(text, pos);
+        }
+
+#undef CCL_SCANNER_ENTRY
+#endif // CCL_SCANNER_X86
+
+        // ---------------- 运行时分派 ----------------
+
+        struct Dispatch
+        {
+            Isa isa;
+            size_t (*skipWhitespace)(std::string_view, size_t);
+            size_t (*findLineEnd)(std::string_view, size_t);
+            size_t (*findCommentEnd)(std::string_view, size_t);
+        };
+
+        bool isSupported(Isa isa)
+        {
+            switch (isa)
+            {
+            case Isa::Scalar:
+                return true;
+#ifdef CCL_SCANNER_X86
+            case Isa::Sse2:
+                return __builtin_cpu_supports("sse2");
+            case Isa::Avx2:
+                return __builtin_cpu_supports("avx2");
+#endif
+            default:
+                return false;
+            }
+        }
+
+        Dispatch makeDispatch(Isa isa)
+        {
+            switch (isa)
+            {
+#ifdef CCL_SCANNER_X86
+            case Isa::Avx2:
+                return {Isa::Avx2, skipWhitespaceAvx2, findLineEndAvx2, findCommentEndAvx2};
+            case Isa::Sse2:
+                return {Isa::Sse2, skipWhitespaceSse2, findLineEndSse2, findCommentEndSse2};
+#endif
+            default:
+                return {Isa::Scalar, skipWhitespaceScalar, findLineEndScalar, findCommentEndScalar};
+            }
+        }
+
+        Dispatch &dispatch()
+        {
+            static Dispatch current = makeDispatch(isSupported(Isa::Avx2)   ? Isa::Avx2
+                                                   : isSupported(Isa::Sse2) ? Isa::Sse2
+                                                                            : Isa::Scalar);
+            return current;
+        }
+    }
+
+    size_t skipWhitespace(std::string_view text, size_t pos)
+    {
+        return dispatch().skipWhitespace(text, pos);
+    }
+
+    size_t findLineEnd(std::string_view text, size_t pos)
+    {
+        return dispatch().findLineEnd(text, pos);
+    }
+
+    size_t findCommentEnd(std::string_view text, size_t pos)
+    {
+        return dispatch().findCommentEnd(text, pos);
+    }
+
+    Isa activeIsa()
+    {
+        return dispatch().isa;
+    }
+
+    bool useIsa(Isa isa)
+    {
+        if (!isSupported(isa))
+        {
+            return false;
+        }
+        dispatch() = makeDispatch(isa);
+        return true;
+    }
+
+    const char *isaName(Isa isa)
+    {
+        switch (isa)
+        {
+        case Isa::Avx2:
+            return "avx2";
+        case Isa::Sse2:
+            return "sse2";
+        default:
+            return "scalar";
+        }
+    }
+}
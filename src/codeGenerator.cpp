@@ -1,5 +1,6 @@
 #include "codeGenerator.h"
 #include "codeGenerator.h"
+#include <algorithm>
 #include "llvm/Support/Host.h"
 #include "llvm/MC/MCTargetOptions.h"
 #include "llvm/Target/TargetOptions.h"
@@ -7,22 +8,17 @@
 
 using namespace llvm;
 
-CodeGenerator::CodeGenerator() : builder_(context_), module_(std::make_unique<Module>("SysY_module", context_))
+CodeGenerator::CodeGenerator()
+    : builder_(context_), module_(std::make_unique<Module>("SysY_module", context_))
 {
     createGetintFunction(module_.get(), context_);
-    PushScope();
 }
 
-CodeGenerator::~CodeGenerator()
-{
-    // 清空所有局部作用域
-    while (!localVarMap.empty())
-        PopScope();
-}
+CodeGenerator::~CodeGenerator() = default;
 
 void CodeGenerator::generateCode(CompUnit &compUnit)
 {
-    compUnit.accept(*this);
+    visitNode(compUnit);
     // 模块验证
     std::string errStr;
     raw_string_ostream errStream(errStr);
@@ -42,28 +38,28 @@ void CodeGenerator::visit(CompUnit &node)
     // 处理全局声明
     for (auto &decl : node.decls_)
     {
-        decl->accept(*this);
+        visitNode(decl);
     }
 
     // 处理函数定义
     for (auto &func : node.funcDefs_)
     {
-        func->accept(*this);
+        visitNode(func);
     }
 
     // 处理主函数
     if (node.mainfuncDef_)
     {
-        node.mainfuncDef_->accept(*this);
+        visitNode(node.mainfuncDef_);
     }
 }
 
 void CodeGenerator::visit(VarDecl &node)
 {
-    node.bType_->accept(*this);
+    visitNode(node.bType_);
     for (auto &def : node.varDefs_)
     {
-        def->accept(*this);
+        visitNode(def);
     }
 }
 
@@ -76,12 +72,12 @@ void CodeGenerator::visit(ConstDef &node)
         llvm::Constant *initVal = llvm::ConstantInt::get(builder_.getInt32Ty(), 0);
         if (node.hasInit)
         {
-            initVal = llvm::ConstantInt::get(builder_.getInt32Ty(), evalConstant.Eval(node.initVal_.get()));
+            initVal = llvm::ConstantInt::get(builder_.getInt32Ty(), evalConstant.Eval(node.initVal_));
         }
         // 创建全局常量变量，标记为constant，存放在module_中
         llvm::GlobalVariable *gVar = new llvm::GlobalVariable(*module_, builder_.getInt32Ty(), true, llvm::GlobalValue::ExternalLinkage, initVal, node.name_);
         // 添加到全局符号
-        AddGlobalVarToMap(gVar, builder_.getInt32Ty(), node.name_);
+        bindStorage(node.symbol_, gVar);
         return;
     }
     else
@@ -90,7 +86,7 @@ void CodeGenerator::visit(ConstDef &node)
         std::vector<uint64_t> dims;
         for (auto &dimExp : node.dimensions_)
         {
-            int d = evalConstant.Eval(dimExp.get());
+            int d = evalConstant.Eval(dimExp);
             dims.push_back(d);
         }
         // 支持一维或二维
@@ -104,19 +100,19 @@ void CodeGenerator::visit(ConstDef &node)
         std::vector<Constant *> flat;
         std::function<void(ConstInitVal *)> flatten = [&](ConstInitVal *cv)
         {
-            if (auto pe = std::get_if<std::unique_ptr<Exp>>(&cv->value_))
+            if (auto pe = std::get_if<Exp *>(&cv->value_))
             {
-                int v = evalConstant.Eval(pe->get());
+                int v = evalConstant.Eval(*pe);
                 flat.push_back(ConstantInt::get(builder_.getInt32Ty(), v));
             }
             else
             {
-                auto &vec = std::get<std::vector<std::unique_ptr<ConstInitVal>>>(cv->value_);
+                auto &vec = std::get<llvm::ArrayRef<ConstInitVal *>>(cv->value_);
                 for (auto &child : vec)
-                    flatten(child.get());
+                    flatten(child);
             }
         };
-        flatten(node.initVal_.get());
+        flatten(node.initVal_);
 
         // 构造ConstantArray嵌套结构
         // 一维：[N x i32]
@@ -140,7 +136,7 @@ void CodeGenerator::visit(ConstDef &node)
             initConst = ConstantArray::get(arrTy, elems);
             // 创建全局变量
             GlobalVariable *gVar = new GlobalVariable(*module_, arrTy, true, GlobalValue::ExternalLinkage, initConst, node.name_);
-            AddGlobalVarToMap(gVar, arrTy, node.name_);
+            bindStorage(node.symbol_, gVar);
         }
         else
         {
@@ -167,7 +163,7 @@ void CodeGenerator::visit(ConstDef &node)
             }
             initConst = ConstantArray::get(outerTy, rows);
             GlobalVariable *gVar = new GlobalVariable(*module_, outerTy, true, GlobalValue::ExternalLinkage, initConst, node.name_);
-            AddGlobalVarToMap(gVar, outerTy, node.name_);
+            bindStorage(node.symbol_, gVar);
         }
     }
 }
@@ -177,7 +173,7 @@ void CodeGenerator::visit(ConstDecl &node)
     // 只支持int类型，无需遍历type获取信息
     for (auto &constDef : node.constDefs_)
     {
-        constDef->accept(*this);
+        visitNode(constDef);
     }
 }
 
@@ -189,7 +185,7 @@ void CodeGenerator::visit(VarDef &node)
         llvm::Constant *initVal = llvm::ConstantInt::get(builder_.getInt32Ty(), 0);
         if (node.hasInit)
         {
-            initVal = llvm::ConstantInt::get(builder_.getInt32Ty(), evalConstant.Eval(node.initVal_.get()));
+            initVal = llvm::ConstantInt::get(builder_.getInt32Ty(), evalConstant.Eval(node.initVal_));
         }
 
         // 如果是在当前函数作用域内定义的局部变量，则用 Alloca
@@ -197,13 +193,13 @@ void CodeGenerator::visit(VarDef &node)
         {
             AllocaInst *allocaInst = builder_.CreateAlloca(builder_.getInt32Ty(), nullptr, node.name_);
             builder_.CreateStore(initVal, allocaInst);
-            AddLocalVarToMap(allocaInst, builder_.getInt32Ty(), node.name_);
+            bindStorage(node.symbol_, allocaInst);
         }
         else
         {
             // 如果是全局变量，创建全局变量
             llvm::GlobalVariable *gVar = new llvm::GlobalVariable(*module_, builder_.getInt32Ty(), false, llvm::GlobalValue::ExternalLinkage, initVal, node.name_);
-            AddGlobalVarToMap(gVar, builder_.getInt32Ty(), node.name_);
+            bindStorage(node.symbol_, gVar);
         }
     }
     else
@@ -212,7 +208,7 @@ void CodeGenerator::visit(VarDef &node)
         std::vector<uint64_t> dims;
         for (auto &exp : node.constExps_)
         {
-            dims.push_back(evalConstant.Eval(exp.get()));
+            dims.push_back(evalConstant.Eval(exp));
         }
         if (dims.size() > 2)
         {
@@ -224,20 +220,20 @@ void CodeGenerator::visit(VarDef &node)
         std::vector<Constant *> flat;
         std::function<void(InitVal *)> flatten = [&](InitVal *iv)
         {
-            if (auto pe = std::get_if<std::unique_ptr<Exp>>(&iv->value_))
+            if (auto pe = std::get_if<Exp *>(&iv->value_))
             {
-                int v = evalConstant.Eval(pe->get());
+                int v = evalConstant.Eval(*pe);
                 flat.push_back(ConstantInt::get(builder_.getInt32Ty(), v));
             }
             else
             {
-                auto &vec = std::get<std::vector<std::unique_ptr<InitVal>>>(iv->value_);
+                auto &vec = std::get<llvm::ArrayRef<InitVal *>>(iv->value_);
                 for (auto &child : vec)
-                    flatten(child.get());
+                    flatten(child);
             }
         };
         if (node.hasInit)
-            flatten(node.initVal_.get());
+            flatten(node.initVal_);
 
         // 4) 构造 LLVM 数组类型
         Type *i32 = builder_.getInt32Ty();
@@ -257,7 +253,7 @@ void CodeGenerator::visit(VarDef &node)
         if (currentFunc_)
         {
             basePtr = builder_.CreateAlloca(arrayTy, nullptr, node.name_);
-            AddLocalVarToMap(basePtr, arrayTy, node.name_);
+            bindStorage(node.symbol_, basePtr);
             //  索引列表：[0, i] 或 [0, i, j]
             Constant *zero = ConstantInt::get(i32, 0);
             if (dims.size() == 1) // 一维数组
@@ -269,7 +265,7 @@ void CodeGenerator::visit(VarDef &node)
                     Value *elemPtr = builder_.CreateGEP(
                         arrayTy, basePtr,
                         {zero, idx1},
-                        node.name_ + ".idx");
+                        std::string(node.name_) + ".idx");
                     Constant *c = (i < flat.size() ? flat[i]
                                                    : ConstantInt::get(i32, 0));
                     builder_.CreateStore(c, elemPtr);
@@ -284,7 +280,7 @@ void CodeGenerator::visit(VarDef &node)
                     {
                         Constant *idx1 = ConstantInt::get(i32, i);
                         Constant *idx2 = ConstantInt::get(i32, j);
-                        Value *elemPtr = builder_.CreateGEP(arrayTy, basePtr, {zero, idx1, idx2}, node.name_ + ".idx");
+                        Value *elemPtr = builder_.CreateGEP(arrayTy, basePtr, {zero, idx1, idx2}, std::string(node.name_) + ".idx");
                         uint64_t flatIdx = i * N + j;
                         Constant *c = (flatIdx < flat.size() ? flat[flatIdx] : ConstantInt::get(i32, 0));
                         builder_.CreateStore(c, elemPtr);
@@ -312,7 +308,7 @@ void CodeGenerator::visit(VarDef &node)
             // 创建全局变量并初始化
             llvm::GlobalVariable *gVar = new llvm::GlobalVariable(*module_, OuterArrayTy, true, llvm::GlobalValue::InternalLinkage, GlobalArrayInit, node.name_);
             basePtr = gVar;
-            AddGlobalVarToMap(gVar, arrayTy, node.name_);
+            bindStorage(node.symbol_, gVar);
         }
     }
 }
@@ -335,25 +331,16 @@ void CodeGenerator::visit(FuncDef &node)
         if (param->isArray_)
         {
             // 处理多维数组参数
-            std::vector<uint64_t> innerDims;
+            std::vector<int> innerDims;
 
             // 跳过第一维（允许空缺），收集后续维度（必须为常量）
             for (size_t i = 1; i < param->dimSizes_.size(); ++i)
             {
                 auto &dim = param->dimSizes_[i];
-                innerDims.push_back(evalConstant.Eval(dim.get()));
+                innerDims.push_back(evalConstant.Eval(dim));
             }
 
-            // 从内到外构建嵌套数组类型
-            Type *currentType = builder_.getInt32Ty();
-            for (auto it = innerDims.rbegin(); it != innerDims.rend(); ++it)
-            {
-                currentType = ArrayType::get(currentType, *it);
-            }
-            // 内层数组类型
-            // 参数类型为指向最内层数组的指针
-            paramType = PointerType::get(currentType, 0);
-            pointerTypeToArray_.insert(std::make_pair(paramType, currentType));
+            paramType = arrayParamType(innerDims);
         }
         else
         {
@@ -366,20 +353,19 @@ void CodeGenerator::visit(FuncDef &node)
 
     // 在模块中创建函数
     llvm::Function *func = llvm::Function::Create(funcTy, llvm::Function::ExternalLinkage, node.name_, module_.get());
+    bindStorage(node.symbol_, func);
     currentFunc_ = func;
 
     // 在入口块开头插入 alloca
     llvm::BasicBlock *entryBB = llvm::BasicBlock::Create(context_, "entry", func);
     builder_.SetInsertPoint(entryBB);
 
-    PushScope(); // 新作用域
-
     unsigned idx = 0;
     for (auto &arg : func->args())
     {
         // 获取参数元数据
         auto &param = node.params_[idx]; // FuncParam 节点
-        std::string pname = param->name_;
+        std::string pname(param->name_);
 
         Type *paramTy = arg.getType(); // 从 LLVM 函数参数获取类型
 
@@ -387,28 +373,24 @@ void CodeGenerator::visit(FuncDef &node)
             paramTy, nullptr, pname + ".addr");
         // 将调用时传入的参数存入 alloc
         builder_.CreateStore(&arg, alloc);
-        // 记录到符号映射
-        // 假设 paramType 是一个 Type* 类型
-        // AddLocalVarToMap(alloc, paramTy, pname);
+        // 记录到形参的符号
         // 插入 load 指令
         if (paramTy->isPointerTy())
         {
             llvm::Value *loadedPtr = builder_.CreateLoad(paramTy, alloc, pname + ".load");
-            // // 更新符号表中该变量的指针值为加载后的指针
-            // auto var = GetVarByName(pname);
-            // var.first = loadedPtr;
-            AddLocalVarToMap(loadedPtr, paramTy, pname);
+            // 数组形参以加载后的指针作为存储
+            bindStorage(param->symbol_, loadedPtr);
         }
         else
         {
             // 如果是标量参数，直接存入符号表
-            AddLocalVarToMap(alloc, paramTy, pname);
+            bindStorage(param->symbol_, alloc);
         }
 
         idx++;
     }
 
-    node.body_->accept(*this);
+    visitNode(node.body_);
 
     // 函数末尾没有return，补充默认return
     if (!entryBB->getTerminator())
@@ -425,11 +407,62 @@ void CodeGenerator::visit(FuncDef &node)
 
     // 验证
     llvm::verifyFunction(*func);
-
-    PopScope();
     // currentType_ = nullptr;
 }
 
+llvm::Type *CodeGenerator::arrayType(llvm::ArrayRef<int> dims)
+{
+    // 从内到外构建嵌套数组类型
+    Type *currentType = builder_.getInt32Ty();
+    for (auto it = dims.rbegin(); it != dims.rend(); ++it)
+    {
+        currentType = ArrayType::get(currentType, *it);
+    }
+    return currentType;
+}
+
+llvm::Type *CodeGenerator::arrayParamType(llvm::ArrayRef<int> innerDims)
+{
+    // 参数类型为指向内层数组（一维数组为 int）的指针
+    return PointerType::get(arrayType(innerDims), 0);
+}
+
+llvm::Function *CodeGenerator::calleeOf(CallExp &node)
+{
+    Symbol *symbol = node.symbol_;
+    if (!symbol || symbol->symbolType_ != FUNCTION)
+    {
+        return nullptr;
+    }
+    // 其他编译单元定义的函数在第一次调用时声明
+    auto *function = static_cast<FunctionSymbol *>(symbol);
+    if (!function->storage_ && function->prototype_)
+    {
+        bindStorage(function, declareFunction(*function->prototype_));
+    }
+    return llvm::dyn_cast_or_null<llvm::Function>(function->storage_);
+}
+
+llvm::Function *CodeGenerator::declareFunction(const FunctionPrototype &prototype)
+{
+    std::vector<llvm::Type *> paramTys;
+    for (const FunctionParamShape &param : prototype.params_)
+    {
+        if (param.isArray_)
+        {
+            paramTys.push_back(arrayParamType(param.innerDims_));
+        }
+        else
+        {
+            paramTys.push_back(builder_.getInt32Ty());
+        }
+    }
+    llvm::Type *retTy = prototype.returnsInt_ ? builder_.getInt32Ty() : builder_.getVoidTy();
+    llvm::FunctionType *funcTy = llvm::FunctionType::get(retTy, paramTys, false);
+    // 只有声明，定义由链接阶段从所在单元的模块中取得
+    return llvm::Function::Create(funcTy, llvm::Function::ExternalLinkage, prototype.name_, module_.get());
+}
+
 void CodeGenerator::visit(MainFuncDef &node)
 {
     // 创建main函数
@@ -444,7 +477,7 @@ void CodeGenerator::visit(MainFuncDef &node)
     currentFunc_ = mainFunc;
 
     // 处理main函数体
-    node.body_->accept(*this);
+    visitNode(node.body_);
 
     // 如果没有终结指令，则添加 `ret i32 0`
     if (!entryBB->getTerminator())
@@ -457,9 +490,6 @@ void CodeGenerator::visit(MainFuncDef &node)
     {
         errs() << "main 函数验证失败！\n";
     }
-
-    // 将 main 函数记录到全局符号映射（以便可能的递归或外部引用）
-    AddGlobalVarToMap(mainFunc, mainFunc->getType(), "main");
 }
 
 void CodeGenerator::visit(BType &node)
@@ -468,37 +498,37 @@ void CodeGenerator::visit(BType &node)
 
 void CodeGenerator::visit(InitVal &node)
 {
-    if (std::holds_alternative<std::unique_ptr<Exp>>(node.value_))
+    if (std::holds_alternative<Exp *>(node.value_))
     {
-        std::get<std::unique_ptr<Exp>>(node.value_)->accept(*this);
+        visitNode(std::get<Exp *>(node.value_));
     }
     else
     {
-        if (!std::get<std::vector<std::unique_ptr<InitVal>>>(node.value_).empty())
+        if (!std::get<llvm::ArrayRef<InitVal *>>(node.value_).empty())
         {
-            std::get<std::vector<std::unique_ptr<InitVal>>>(node.value_)[0]->accept(*this);
+            visitNode(std::get<llvm::ArrayRef<InitVal *>>(node.value_)[0]);
         }
     }
 }
 
 void CodeGenerator::visit(ConstInitVal &node)
 {
-    if (std::holds_alternative<std::unique_ptr<Exp>>(node.value_))
+    if (std::holds_alternative<Exp *>(node.value_))
     {
-        std::move(std::get<std::unique_ptr<Exp>>(node.value_))->accept(*this);
+        visitNode(std::move(std::get<Exp *>(node.value_)));
     }
     else
     {
-        if (!std::get<std::vector<std::unique_ptr<ConstInitVal>>>(node.value_).empty())
+        if (!std::get<llvm::ArrayRef<ConstInitVal *>>(node.value_).empty())
         {
-            std::get<std::vector<std::unique_ptr<ConstInitVal>>>(node.value_)[0]->accept(*this);
+            visitNode(std::get<llvm::ArrayRef<ConstInitVal *>>(node.value_)[0]);
         }
     }
 }
 
 void CodeGenerator::visit(BlockItem &node)
 {
-    node.item_->accept(*this);
+    visitNode(node.item_);
 }
 
 void CodeGenerator::visit(FuncType &node)
@@ -508,27 +538,24 @@ void CodeGenerator::visit(FuncType &node)
 // 控制流语句
 void CodeGenerator::visit(ExpStmt &node)
 {
-    node.exp_->accept(*this);
+    visitNode(node.exp_);
 }
 
 void CodeGenerator::visit(Block &node)
 {
-    PushScope();
     for (auto &item : node.items_)
     {
-        item->accept(*this);
+        visitNode(item);
     }
-    PopScope();
 }
 
 void CodeGenerator::visit(AssignStmt &node)
 {
     // 生成右侧表达式的值
-    node.exp_->accept(*this);
-    llvm::Value *rhs = currentValue_;
-    rhs = loadIfPointer(currentValue_);
+    visitNode(node.exp_);
+    llvm::Value *rhs = loadIfLValue(node.exp_, currentValue_);
     // 生成左值，得到变量地址
-    node.lval_->accept(*this);
+    visitNode(node.lval_);
     llvm::Value *lvalAddr = currentValue_;
     if (lvalAddr)
     {
@@ -540,7 +567,7 @@ void CodeGenerator::visit(AssignStmt &node)
 void CodeGenerator::visit(IfStmt &node)
 {
     // 处理条件表达式
-    node.cond_->accept(*this);
+    emitCondition(node.cond_);
     llvm::Value *condValue = currentValue_;
 
     // 转换条件值为布尔值
@@ -565,7 +592,7 @@ void CodeGenerator::visit(IfStmt &node)
 
     // 处理 then 分支
     builder_.SetInsertPoint(thenBB);
-    node.thenBranch_->accept(*this);
+    visitNode(node.thenBranch_);
 
     // 如果没有跳转到 else 部分，直接跳转到 mergeBB
     builder_.CreateBr(mergeBB);
@@ -577,7 +604,7 @@ void CodeGenerator::visit(IfStmt &node)
     if (elseBB)
     {
         builder_.SetInsertPoint(elseBB);
-        node.elseBranch_->accept(*this);
+        visitNode(node.elseBranch_);
         builder_.CreateBr(mergeBB);
         elseBB = builder_.GetInsertBlock();
     }
@@ -601,7 +628,7 @@ void CodeGenerator::visit(WhileStmt &node)
     builder_.SetInsertPoint(condBB);
 
     // 检查条件是否为真
-    node.cond_->accept(*this);
+    emitCondition(node.cond_);
     llvm::Value *condValue = currentValue_;
 
     // 转换条件值为布尔值
@@ -616,7 +643,7 @@ void CodeGenerator::visit(WhileStmt &node)
     builder_.SetInsertPoint(loopBB);
 
     // 处理循环体
-    node.body_->accept(*this);
+    visitNode(node.body_);
 
     builder_.CreateBr(condBB);
 
@@ -628,8 +655,8 @@ void CodeGenerator::visit(ReturnStmt &node)
 {
     if (node.exp_)
     {
-        node.exp_->accept(*this);
-        currentValue_ = loadIfPointer(currentValue_);
+        visitNode(node.exp_);
+        currentValue_ = loadIfLValue(node.exp_, currentValue_);
         builder_.CreateRet(currentValue_);
     }
     else
@@ -651,7 +678,7 @@ void CodeGenerator::visit(IOStmt &node)
         }
         llvm::Value *retVal = builder_.CreateCall(getintFunc, {}, "getintCall");
         // 将读入的值存入目标变量
-        node.target_->accept(*this);             // 生成变量指针
+        visitNode(node.target_);             // 生成变量指针
         llvm::Value *targetAddr = currentValue_; // 获取目标地址值
         builder_.CreateStore(retVal, static_cast<AllocaInst *>(targetAddr));
         currentValue_ = retVal;
@@ -672,21 +699,24 @@ void CodeGenerator::visit(IOStmt &node)
         printfArgs.push_back(formatStr);
         for (auto &arg : node.args_)
         {
-            arg->accept(*this);
-            currentValue_ = builder_.CreateLoad(llvm::Type::getInt32Ty(context_), currentValue_);
+            visitNode(arg);
+            if (arg->isLValue_)
+            {
+                currentValue_ = builder_.CreateLoad(llvm::Type::getInt32Ty(context_), currentValue_);
+            }
             printfArgs.push_back(currentValue_);
         }
         builder_.CreateCall(printfFunc, printfArgs, "printfCall");
     }
 }
 
-// 1.普通变量 2.一维数组 3.二维数组。 统一返回元素地址
+// 1.普通变量 2.数组元素 3.数组或其一部分（作为实参）。按语义分析标注的类型与符号的维度生成 GEP：
+// 得到 int 的地址（isLValue_），或退化后指向首元素的指针
 void CodeGenerator::visit(LVal &node)
 {
-    // 查找变量符号（支持局部和全局变量）
-    auto var = GetVarByName(node.name_);
-    Value *basePtr = var.first;
-    Type *baseTy = var.second;
+    // 语义分析解析到的符号，其存储由定义处的代码生成填写
+    Symbol *symbol = node.symbol_;
+    Value *basePtr = symbol ? symbol->storage_ : nullptr;
 
     if (!basePtr)
     {
@@ -694,128 +724,82 @@ void CodeGenerator::visit(LVal &node)
         return;
     }
 
-    // 1. 处理普通变量
-    if (baseTy->isIntegerTy())
+    // 1. 处理普通变量：直接返回变量地址
+    if (!symbol->isArray_)
     {
-        // 直接返回变量地址
         currentValue_ = basePtr;
         return;
     }
 
     // 2. 处理数组
-
     SmallVector<Value *, 4> indices;
     for (auto &idxExp : node.indices_)
     {
-        idxExp->accept(*this);
-        indices.push_back(loadIfPointer(currentValue_)); // 直接使用用户提供的索引值（如i和j）
+        visitNode(idxExp);
+        indices.push_back(loadIfLValue(idxExp, currentValue_)); // 直接使用用户提供的索引值（如i和j）
     }
 
-    // PointerType* 类型不可作为参数传入， 若值是函数参数中创建的数组，类型为PointerType* ，需要转换为原指向类型。
-    if (baseTy->isPointerTy())
+    // 数组的存储是整个数组的地址，每个下标前补 0 取下一层；数组形参的存储已是指向首元素（内层数组）的指针，
+    // 首个下标直接偏移该指针
+    llvm::ArrayRef<int> dims = static_cast<ArraySymbol *>(symbol)->dimensions_;
+    bool decayed = symbol->symbolType_ == PARAM;
+    size_t count = std::min(indices.size(), dims.size());
+    for (size_t i = 0; i < count; ++i)
     {
-        auto iter = pointerTypeToArray_.find(baseTy); // 查找键为 key 的元素
-        if (iter != pointerTypeToArray_.end())
+        std::string name = std::string(node.name_) + (dims.size() == 1 ? ".idx" : ".idx" + std::to_string(i));
+        if (decayed && i == 0)
         {
-            baseTy = iter->second; // 获取值
+            basePtr = builder_.CreateInBoundsGEP(arrayType(dims.drop_front()), basePtr, {indices[i]}, name);
         }
         else
         {
-            std::cout << "未找到指针类型对应的数组类型" << std::endl;
+            basePtr = builder_.CreateInBoundsGEP(arrayType(dims.drop_front(i)), basePtr, {builder_.getInt32(0), indices[i]}, name);
         }
     }
 
-    Type *innerType = nullptr;
-
-    // 获取类型信息
-    if (baseTy->isArrayTy())
+    // 3. 数组或其一部分只作为实参使用：退化为指向首元素的指针
+    if (node.type_.kind_ == ExpType::Array)
     {
-        innerType = baseTy->getArrayElementType(); // 从二维到一维
-    }
-    // innerType为IntergerTy则为一维数组，否则为二维数组
-
-    // 处理一维数组索引
-    if (baseTy->isArrayTy()&&innerType->isIntegerTy()&&indices.size()==1)
-    {
-        // 处理一维数组
-        if (indices.size() > 1)
-        {
-            std::cout << "一维数组索引错误: " << node.name_ << "\n";
-            return;
-        }
-        // 直接返回变量地址
-        basePtr = builder_.CreateInBoundsGEP(baseTy, basePtr, {builder_.getInt32(0), indices[0]}, node.name_ + ".idx");
-        currentValue_ = basePtr; // 最终得到元素地址
-        isAddr = true;
-    }
-
-    // 处理二维数组
-    if (innerType->isArrayTy()||indices.size()==2)
-    {
-        int istowdim = true;
-
-        for (size_t i = 0; i < indices.size(); ++i)
-        {
-            // 对二维数组，第一次索引取行，第二次取列
-            if (istowdim && i == 0)
-            {
-                basePtr = builder_.CreateInBoundsGEP(baseTy, basePtr, {builder_.getInt32(0), indices[i]}, node.name_ + ".idx" + std::to_string(i));
-            }
-             else //if(baseTy->isArrayTy())
-            {
-                // 对于二维数组，第二次索引取列
-                basePtr = builder_.CreateInBoundsGEP(baseTy, basePtr, {builder_.getInt32(0), indices[i]}, node.name_ + ".idx" + std::to_string(i));
-            }
-            // else
-            // {
-            //     basePtr = builder_.CreateInBoundsGEP(baseTy, basePtr, {indices[i]}, node.name_ + ".idx" + std::to_string(i));
-            // }
-
-            if (auto arrTy = dyn_cast<ArrayType>(baseTy))
-            {
-                baseTy = arrTy->getElementType(); // 从二维到一维，再到int
-            }
-        }
-        isAddr = true;
-        pointerTypeToArray_.insert(std::make_pair(basePtr->getType(), baseTy));
-        currentValue_ = basePtr; // 最终得到元素地址
+        basePtr = builder_.CreateInBoundsGEP(arrayType(dims.take_back(node.type_.rank_)), basePtr,
+                                             {builder_.getInt32(0), builder_.getInt32(0)}, std::string(node.name_) + ".decay");
     }
+    currentValue_ = basePtr; // 元素地址或指向首元素的指针
 }
 
 void CodeGenerator::visit(PrimaryExp &node)
 {
-    if (std::holds_alternative<std::unique_ptr<Exp>>(node.operand_))
+    if (std::holds_alternative<Exp *>(node.operand_))
     {
-        std::get<std::unique_ptr<Exp>>(node.operand_)->accept(*this);
+        visitNode(std::get<Exp *>(node.operand_));
     }
-    else if (std::holds_alternative<std::unique_ptr<LVal>>(node.operand_))
+    else if (std::holds_alternative<LVal *>(node.operand_))
     {
-        std::get<std::unique_ptr<LVal>>(node.operand_)->accept(*this);
+        visitNode(std::get<LVal *>(node.operand_));
     }
-    else if (std::holds_alternative<std::unique_ptr<Number>>(node.operand_))
+    else if (std::holds_alternative<Number *>(node.operand_))
     {
-        std::get<std::unique_ptr<Number>>(node.operand_)->accept(*this);
+        visitNode(std::get<Number *>(node.operand_));
     }
 }
 
 void CodeGenerator::visit(UnaryExp &node)
 {
-    node.operand_->accept(*this);
+    visitNode(node.operand_);
     // 处理一元运算符,需区分是否为地址，若Unary有操作符，则转换地址进行计算，否则返回地址，由mul或add处理
     // llvm::Value *operandVal = currentValue_;
     switch (node.op)
     {
     case UnaryExp::Op::Plus:
-        currentValue_ = loadIfPointer(currentValue_);
+        currentValue_ = loadIfLValue(node.operand_, currentValue_);
         // currentValue_ = operandVal;
         break;
     case UnaryExp::Op::Minus:
-        currentValue_ = loadIfPointer(currentValue_);
+        currentValue_ = loadIfLValue(node.operand_, currentValue_);
         currentValue_ = builder_.CreateNeg(currentValue_, "negtmp");
         break;
     case UnaryExp::Op::Not:
     {
-        currentValue_ = loadIfPointer(currentValue_);
+        currentValue_ = loadIfLValue(node.operand_, currentValue_);
         llvm::Value *zero = ConstantInt::get(Type::getInt32Ty(context_), 0);
         currentValue_ = builder_.CreateICmpEQ(currentValue_, zero, "nottmp");
         currentValue_ = builder_.CreateZExt(currentValue_, Type::getInt32Ty(context_), "booltmp");
@@ -830,21 +814,25 @@ void CodeGenerator::visit(AddExp &node)
 {
     bool first = true;
     llvm::Value *result = nullptr;
+    Exp *resultExp = nullptr; // result 仍是第一个操作数时为该操作数，之后 result 为运算结果（右值）
     bool doAdd = true; // 当前运算符，true 表示加，false 表示减
     for (auto &elem : node.elements_)
     {
-        if (std::holds_alternative<std::unique_ptr<Exp>>(elem))
+        if (std::holds_alternative<Exp *>(elem))
         {
-            std::get<std::unique_ptr<Exp>>(elem)->accept(*this);
+            Exp *operand = std::get<Exp *>(elem);
+            visitNode(operand);
             if (first)
             {
                 result = currentValue_;
+                resultExp = operand;
                 first = false;
             }
             else
             {
-                result = loadIfPointer(result);               // 处理地址
-                currentValue_ = loadIfPointer(currentValue_); // 处理地址
+                result = loadIfLValue(resultExp, result);              // 处理地址
+                currentValue_ = loadIfLValue(operand, currentValue_); // 处理地址
+                resultExp = nullptr;
                 if (doAdd)
                     result = builder_.CreateAdd(result, currentValue_, "addtmp");
                 else
@@ -867,20 +855,24 @@ void CodeGenerator::visit(MulExp &node)
 {
     bool first = true;
     llvm::Value *result = nullptr;
+    Exp *resultExp = nullptr; // 同 AddExp
     for (auto &elem : node.elements_)
     {
-        if (std::holds_alternative<std::unique_ptr<Exp>>(elem))
+        if (std::holds_alternative<Exp *>(elem))
         {
-            std::get<std::unique_ptr<Exp>>(elem)->accept(*this);
+            Exp *operand = std::get<Exp *>(elem);
+            visitNode(operand);
             if (first)
             {
                 result = currentValue_;
+                resultExp = operand;
                 first = false;
             }
             else
             {
-                result = loadIfPointer(result);               // 处理地址
-                currentValue_ = loadIfPointer(currentValue_); // 处理地址
+                result = loadIfLValue(resultExp, result);              // 处理地址
+                currentValue_ = loadIfLValue(operand, currentValue_); // 处理地址
+                resultExp = nullptr;
                 result = builder_.CreateMul(result, currentValue_, "multmp");
             }
         }
@@ -897,10 +889,8 @@ void CodeGenerator::visit(LOrExp &node)
     // 如果只有一个子表达式，直接计算
     if (node.elements_.size() == 1)
     {
-        std::get<std::unique_ptr<Exp>>(node.elements_[0])->accept(*this);
-        llvm::Value *zero = llvm::ConstantInt::get(builder_.getInt32Ty(), 0);
-        llvm::Value *cmp = builder_.CreateICmpNE(currentValue_, zero, "lor_single");
-        currentValue_ = builder_.CreateZExt(cmp, builder_.getInt32Ty(), "lor_single_ext");
+        emitLAndOperand(std::get<Exp *>(node.elements_[0]));
+        emitTruthValue("lor_single");
         return;
     }
 
@@ -913,7 +903,7 @@ void CodeGenerator::visit(LOrExp &node)
     BasicBlock *mergeBB = BasicBlock::Create(context_, "lor.merge", function);
 
     // 计算第一个子表达式
-    std::get<std::unique_ptr<Exp>>(node.elements_[0])->accept(*this);
+    emitLAndOperand(std::get<Exp *>(node.elements_[0]));
     llvm::Value *val = currentValue_;
 
     llvm::Value *zero = llvm::ConstantInt::get(builder_.getInt32Ty(), 0);
@@ -926,7 +916,7 @@ void CodeGenerator::visit(LOrExp &node)
     for (size_t i = 2; i < node.elements_.size(); i += 2)
     {
         // 计算当前子表达式
-        std::get<std::unique_ptr<Exp>>(node.elements_[i])->accept(*this);
+        emitLAndOperand(std::get<Exp *>(node.elements_[i]));
         val = currentValue_;
         cond = builder_.CreateICmpNE(val, zero, "lor.cond");
         // 如果为真，跳trueBB，否则继续到下一个子表达式或最终 falseBB
@@ -962,10 +952,10 @@ void CodeGenerator::visit(LAndExp &node)
 {
     if (node.elements_.size() == 1)
     {
-        std::get<std::unique_ptr<Exp>>(node.elements_[0])->accept(*this);
-        llvm::Value *zero = llvm::ConstantInt::get(builder_.getInt32Ty(), 0);
-        llvm::Value *cmp = builder_.CreateICmpNE(currentValue_, zero, "land_single");
-        currentValue_ = builder_.CreateZExt(cmp, builder_.getInt32Ty(), "land_single_ext");
+        Exp *operand = std::get<Exp *>(node.elements_[0]);
+        visitNode(operand);
+        currentValue_ = loadIfLValue(operand, currentValue_);
+        emitTruthValue("land_single");
         return;
     }
 
@@ -978,8 +968,9 @@ void CodeGenerator::visit(LAndExp &node)
     BasicBlock *mergeBB = BasicBlock::Create(context_, "land.merge", function);
 
     // 1. 计算第一个子表达式
-    std::get<std::unique_ptr<Exp>>(node.elements_[0])->accept(*this);
-    llvm::Value *val = currentValue_;
+    Exp *operand = std::get<Exp *>(node.elements_[0]);
+    visitNode(operand);
+    llvm::Value *val = loadIfLValue(operand, currentValue_);
     llvm::Value *zero = llvm::ConstantInt::get(builder_.getInt32Ty(), 0);
     llvm::Value *cond = builder_.CreateICmpNE(val, zero, "land.cond0");
     // 如果为真，继续到下一个；否则跳到 falseBB
@@ -990,8 +981,9 @@ void CodeGenerator::visit(LAndExp &node)
     for (size_t i = 2; i < node.elements_.size(); i += 2)
     {
         // 计算当前子表达式
-        std::get<std::unique_ptr<Exp>>(node.elements_[i])->accept(*this);
-        val = currentValue_;
+        operand = std::get<Exp *>(node.elements_[i]);
+        visitNode(operand);
+        val = loadIfLValue(operand, currentValue_);
         cond = builder_.CreateICmpNE(val, zero, "land.cond");
 
         // 如果为真，跳到下一个或 trueBB；否则跳到 falseBB
@@ -1019,9 +1011,41 @@ void CodeGenerator::visit(LAndExp &node)
     currentValue_ = phi;
 }
 
+// 把 currentValue_ 归一化为 i32 的 0/1
+void CodeGenerator::emitTruthValue(const std::string &name)
+{
+    llvm::Value *zero = llvm::ConstantInt::get(builder_.getInt32Ty(), 0);
+    llvm::Value *cmp = builder_.CreateICmpNE(currentValue_, zero, name);
+    currentValue_ = builder_.CreateZExt(cmp, builder_.getInt32Ty(), name + "_ext");
+}
+
+// LOrExp 的操作数：不是 LAndExp 时相当于只有一个操作数的 LAndExp
+void CodeGenerator::emitLAndOperand(Exp *exp)
+{
+    visitNode(exp);
+    if (!llvm::isa<LAndExp>(exp))
+    {
+        currentValue_ = loadIfLValue(exp, currentValue_);
+        emitTruthValue("land_single");
+    }
+}
+
+// If/While 的条件：不是 LOrExp 时相当于只有一个操作数的 LOrExp
+void CodeGenerator::emitCondition(Exp *exp)
+{
+    if (llvm::isa<LOrExp>(exp))
+    {
+        visitNode(exp);
+        return;
+    }
+    emitLAndOperand(exp);
+    emitTruthValue("lor_single");
+}
+
 void CodeGenerator::visit(EqExp &node)
 {
-    std::get<std::unique_ptr<Exp>>(node.elements_[0])->accept(*this);
+    Exp *resultExp = std::get<Exp *>(node.elements_[0]); // 同 AddExp
+    visitNode(resultExp);
     llvm::Value *result = currentValue_;
 
     TokenType op = TokenType::UNKNOW;
@@ -1035,8 +1059,11 @@ void CodeGenerator::visit(EqExp &node)
         else
         {
             // 子表达式
-            std::get<std::unique_ptr<Exp>>(node.elements_[i])->accept(*this);
-            llvm::Value *rhs = currentValue_;
+            Exp *operand = std::get<Exp *>(node.elements_[i]);
+            visitNode(operand);
+            result = loadIfLValue(resultExp, result);
+            llvm::Value *rhs = loadIfLValue(operand, currentValue_);
+            resultExp = nullptr;
 
             // 生成比较指令
             llvm::Value *cmp = nullptr;
@@ -1060,7 +1087,8 @@ void CodeGenerator::visit(EqExp &node)
 void CodeGenerator::visit(RelExp &node)
 {
     // 计算第一个子表达式
-    std::get<std::unique_ptr<Exp>>(node.elements_[0])->accept(*this);
+    Exp *resultExp = std::get<Exp *>(node.elements_[0]); // 同 AddExp
+    visitNode(resultExp);
     llvm::Value *result = currentValue_;
 
     // 遍历后续元素
@@ -1074,8 +1102,11 @@ void CodeGenerator::visit(RelExp &node)
         }
         else
         {
-            std::get<std::unique_ptr<Exp>>(node.elements_[i])->accept(*this);
-            llvm::Value *rhs = currentValue_;
+            Exp *operand = std::get<Exp *>(node.elements_[i]);
+            visitNode(operand);
+            result = loadIfLValue(resultExp, result);
+            llvm::Value *rhs = loadIfLValue(operand, currentValue_);
+            resultExp = nullptr;
 
             llvm::Value *cmp = nullptr;
             switch (relOp)
@@ -1107,38 +1138,18 @@ void CodeGenerator::visit(RelExp &node)
 
 void CodeGenerator::visit(CallExp &node)
 {
-    Function *callee = module_->getFunction(node.funcName);
+    Function *callee = calleeOf(node);
     if (!callee)
     {
         currentValue_ = nullptr;
         return;
     }
     std::vector<llvm::Value *> args;
-    for (size_t i = 0; i < node.args_.size(); ++i)
+    for (auto *arg : node.args_)
     {
-        node.args_[i]->accept(*this);
-        Value *argVal = currentValue_;
-        Type *paramTy = callee->getFunctionType()->getParamType(i);
-
-        // 处理二维数组参数：将二维数组转换为指向内层数组的指针
-        if (paramTy->isIntegerTy())
-        {
-            argVal = loadIfPointer(argVal); // 处理地址
-            // 如果参数类型是整数，直接使用
-        }
-        else
-        {
-            Type *arrTy = pointerTypeToArray_[argVal->getType()];
-            // TODO
-            if (arrTy && arrTy->isArrayTy())
-            {
-                // 二维数组类型为 [M x [N x i32]]，需要获取第一行的地址（即降维为 [N x i32]*）
-                Value *zero = ConstantInt::get(builder_.getInt32Ty(), 0);
-                argVal = builder_.CreateInBoundsGEP(arrTy, argVal, {zero}, "array.param"); // 获取第一行指针
-            }
-        }
-
-        args.push_back(argVal);
+        visitNode(arg);
+        // int 实参按标注加载；数组实参在 LVal 中已退化为指向首元素的指针，直接传递
+        args.push_back(loadIfLValue(arg, currentValue_));
     }
     currentValue_ = builder_.CreateCall(callee, args);
 }
@@ -1179,6 +1190,16 @@ Function *CodeGenerator::createGetintFunction(Module *module, LLVMContext &conte
 }
 
 void CodeGenerator::emitMIPSAssembly(const std::string &outputFilename)
+{
+    emitMIPSAssembly(*module_, outputFilename);
+}
+
+void CodeGenerator::emitIRToFile(const std::string &outputFilename)
+{
+    emitIRToFile(*module_, outputFilename);
+}
+
+void CodeGenerator::emitMIPSAssembly(llvm::Module &module, const std::string &outputFilename)
 {
     InitializeAllTargetInfos();
     InitializeAllTargets();
@@ -1187,7 +1208,7 @@ void CodeGenerator::emitMIPSAssembly(const std::string &outputFilename)
     InitializeAllAsmPrinters();
 
     std::string targetTriple = sys::getDefaultTargetTriple();
-    module_->setTargetTriple(targetTriple);
+    module.setTargetTriple(targetTriple);
 
     std::string error;
     const Target *target = TargetRegistry::lookupTarget(targetTriple, error);
@@ -1198,10 +1219,9 @@ void CodeGenerator::emitMIPSAssembly(const std::string &outputFilename)
     }
 
     TargetOptions opt;
-    auto RM = std::optional<llvm::Reloc::Model>();
-    TargetMachine *targetMachine = target->createTargetMachine(targetTriple, "generic", "", opt, RM);
+    TargetMachine *targetMachine = target->createTargetMachine(targetTriple, "generic", "", opt, {});
 
-    module_->setDataLayout(targetMachine->createDataLayout());
+    module.setDataLayout(targetMachine->createDataLayout());
 
     std::error_code EC;
     raw_fd_ostream dest(outputFilename, EC, sys::fs::OF_None);
@@ -1219,11 +1239,11 @@ void CodeGenerator::emitMIPSAssembly(const std::string &outputFilename)
         return;
     }
 
-    pass.run(*module_);
+    pass.run(module);
     dest.flush();
 }
 
-void CodeGenerator::emitIRToFile(const std::string &outputFilename)
+void CodeGenerator::emitIRToFile(llvm::Module &module, const std::string &outputFilename)
 {
 
     // 确保文件可以正确打开
@@ -1237,58 +1257,25 @@ void CodeGenerator::emitIRToFile(const std::string &outputFilename)
     }
 
     // 输出模块的 IR 到文件
-    module_->print(dest, nullptr);
+    module.print(dest, nullptr);
 
     llvm::outs() << "IR code has been written to: " << outputFilename << "\n";
 }
 
-void CodeGenerator::AddLocalVarToMap(llvm::Value *addr, llvm::Type *ty, llvm::StringRef name)
-{
-    localVarMap.back().insert({name, {addr, ty}});
-}
-
-void CodeGenerator::AddGlobalVarToMap(llvm::Value *addr, llvm::Type *ty, llvm::StringRef name)
-{
-    globalVarMap.insert({name, {addr, ty}});
-}
-
-std::pair<llvm::Value *, llvm::Type *> CodeGenerator::GetVarByName(llvm::StringRef name)
+void CodeGenerator::bindStorage(Symbol *symbol, llvm::Value *storage)
 {
-    for (auto it = localVarMap.rbegin(); it != localVarMap.rend(); ++it)
+    // 重复定义没有符号，生成的存储不会被引用
+    if (symbol)
     {
-        if (it->find(name) != it->end())
-        {
-            return (*it)[name];
-        }
+        symbol->storage_ = storage;
     }
-    assert(globalVarMap.find(name) != globalVarMap.end());
-    return globalVarMap[name];
 }
 
-void CodeGenerator::PushScope()
+llvm::Value *CodeGenerator::loadIfLValue(Exp *exp, llvm::Value *v)
 {
-    localVarMap.emplace_back();
-}
-
-void CodeGenerator::PopScope()
-{
-    localVarMap.pop_back();
-}
-
-void CodeGenerator::ClearVarScope()
-{
-    localVarMap.clear();
-}
-
-llvm::Value *CodeGenerator::loadIfPointer(llvm::Value *v)
-{
-    if (v && v->getType()->isPointerTy())
+    if (v && exp && exp->isLValue_)
     {
-        auto ptrTy = llvm::dyn_cast<llvm::PointerType>(v->getType());
-        if (ptrTy)
-        {
-            return builder_.CreateLoad(llvm::Type::getInt32Ty(context_), v, "loadtmp");
-        }
+        return builder_.CreateLoad(llvm::Type::getInt32Ty(context_), v, "loadtmp");
     }
     return v;
 }
\ No newline at end of file
@@ -5,49 +5,76 @@ using namespace AST;
 
 int EvalConstant::Eval(Node *node)
 {
-    // 根据动态类型分发到相应的处理函数
+    constant_ = true;
+    return EvalNode(node);
+}
+
+int EvalConstant::EvalNode(Node *node)
+{
+    // 已折叠的表达式直接返回标注的值
+    auto *exp = llvm::dyn_cast<Exp>(node);
+    if (exp && exp->folded_)
+    {
+        return exp->foldedValue_;
+    }
+    // 只有不含变量引用与函数调用的子树才标注；constant_ 在子树求值期间只会由真变假
+    bool enclosing = constant_;
+    constant_ = true;
+    int value = EvalUncached(node);
+    if (exp && constant_)
+    {
+        exp->foldedValue_ = value;
+        exp->folded_ = true;
+    }
+    constant_ = enclosing && constant_;
+    return value;
+}
+
+int EvalConstant::EvalUncached(Node *node)
+{
+    // 按节点种类分发到相应的处理函数；llvm::cast 经由各类的 classof 转换，不依赖 RTTI
     auto kind = node->getKind();
 
     switch (kind)
     {
     case Node::ND_Number:
-        return VisitNumberExp(dynamic_cast<Number *>(node));
+        return VisitNumberExp(llvm::cast<Number>(node));
 
     case Node::ND_AddExp:
-        return VisitAddExp(dynamic_cast<AddExp *>(node));
+        return VisitAddExp(llvm::cast<AddExp>(node));
 
     case Node::ND_MulExp:
-        return VisitMulExp(dynamic_cast<MulExp *>(node));
+        return VisitMulExp(llvm::cast<MulExp>(node));
 
     case Node::ND_UnaryExp:
-        return VisitUnaryExp(dynamic_cast<UnaryExp *>(node));
+        return VisitUnaryExp(llvm::cast<UnaryExp>(node));
 
     case Node::ND_LVal:
-        return VisitLValExp(dynamic_cast<LVal *>(node));
+        return VisitLValExp(llvm::cast<LVal>(node));
 
     case Node::ND_PrimaryExp:
-        return VisitPrimaryExp(dynamic_cast<PrimaryExp *>(node));
+        return VisitPrimaryExp(llvm::cast<PrimaryExp>(node));
 
     case Node::ND_LOrExp:
-        return VisitLOrExp(dynamic_cast<LOrExp *>(node));
+        return VisitLOrExp(llvm::cast<LOrExp>(node));
 
     case Node::ND_LAndExp:
-        return VisitLAndExp(dynamic_cast<LAndExp *>(node));
+        return VisitLAndExp(llvm::cast<LAndExp>(node));
 
     case Node::ND_EqExp:
-        return VisitEqExp(dynamic_cast<EqExp *>(node));
+        return VisitEqExp(llvm::cast<EqExp>(node));
 
     case Node::ND_RelExp:
-        return VisitRelExp(dynamic_cast<RelExp *>(node));
+        return VisitRelExp(llvm::cast<RelExp>(node));
 
     case Node::ND_CallExp:
-        return VisitCallExp(dynamic_cast<CallExp *>(node));
+        return VisitCallExp(llvm::cast<CallExp>(node));
 
     case Node::ND_InitVal:
-        return VisitInitVal(dynamic_cast<InitVal *>(node));
+        return VisitInitVal(llvm::cast<InitVal>(node));
 
     case Node::ND_ConstInitVal:
-        return VisitConstInitVal(dynamic_cast<ConstInitVal *>(node));
+        return VisitConstInitVal(llvm::cast<ConstInitVal>(node));
 
     default:
         throw std::runtime_error("Unsupported node type in constant evaluation.");
@@ -68,10 +95,10 @@ int EvalConstant::VisitAddExp(AddExp *exp)
     TokenType op = TokenType::UNKNOW;
     for (auto &elem : exp->elements_)
     {
-        if (std::holds_alternative<std::unique_ptr<Exp>>(elem))
+        if (std::holds_alternative<Exp *>(elem))
         {
-            auto &child = std::get<std::unique_ptr<Exp>>(elem);
-            int value = Eval(child.get());
+            auto &child = std::get<Exp *>(elem);
+            int value = EvalNode(child);
             if (first)
             {
                 result = value;
@@ -102,10 +129,10 @@ int EvalConstant::VisitMulExp(MulExp *exp)
     TokenType op = TokenType::UNKNOW;
     for (auto &elem : exp->elements_)
     {
-        if (std::holds_alternative<std::unique_ptr<Exp>>(elem))
+        if (std::holds_alternative<Exp *>(elem))
         {
-            auto &child = std::get<std::unique_ptr<Exp>>(elem);
-            int value = Eval(child.get());
+            auto &child = std::get<Exp *>(elem);
+            int value = EvalNode(child);
             if (first)
             {
                 result = value;
@@ -141,7 +168,7 @@ int EvalConstant::VisitMulExp(MulExp *exp)
 
 int EvalConstant::VisitUnaryExp(UnaryExp *exp)
 {
-    int operand = Eval(exp->operand_.get());
+    int operand = EvalNode(exp->operand_);
     switch (exp->op)
     {
     case UnaryExp::Op::Plus:
@@ -157,25 +184,25 @@ int EvalConstant::VisitUnaryExp(UnaryExp *exp)
 
 int EvalConstant::VisitLValExp(LVal *exp)
 {
-    // 对于常量表达式中的变量引用，如果变量是常量则应在语义分析阶段已将其值求出；
+    // 变量引用不是常量：求值为 0 以保持调用方的行为，但所在子树不标注折叠
+    constant_ = false;
     return 0;
-    throw std::runtime_error("LVal cannot be evaluated as a constant expression.");
 }
 
 int EvalConstant::VisitPrimaryExp(PrimaryExp *exp)
 {
-    // PrimaryExp 的 operand_ 是 std::variant<std::unique_ptr<Exp>, std::unique_ptr<LVal>, std::unique_ptr<Number>>
-    if (std::holds_alternative<std::unique_ptr<Exp>>(exp->operand_))
+    // PrimaryExp 的 operand_ 是 std::variant<Exp *, LVal *, Number *>
+    if (std::holds_alternative<Exp *>(exp->operand_))
     {
-        return Eval(std::get<std::unique_ptr<Exp>>(exp->operand_).get());
+        return EvalNode(std::get<Exp *>(exp->operand_));
     }
-    else if (std::holds_alternative<std::unique_ptr<LVal>>(exp->operand_))
+    else if (std::holds_alternative<LVal *>(exp->operand_))
     {
-        return Eval(std::get<std::unique_ptr<LVal>>(exp->operand_).get());
+        return EvalNode(std::get<LVal *>(exp->operand_));
     }
-    else if (std::holds_alternative<std::unique_ptr<Number>>(exp->operand_))
+    else if (std::holds_alternative<Number *>(exp->operand_))
     {
-        return Eval(std::get<std::unique_ptr<Number>>(exp->operand_).get());
+        return EvalNode(std::get<Number *>(exp->operand_));
     }
     throw std::runtime_error("Invalid PrimaryExp variant.");
 }
@@ -188,9 +215,9 @@ int EvalConstant::VisitLOrExp(LOrExp *exp)
     TokenType op = TokenType::UNKNOW;
     for (auto &elem : exp->elements_)
     {
-        if (std::holds_alternative<std::unique_ptr<Exp>>(elem))
+        if (std::holds_alternative<Exp *>(elem))
         {
-            int value = Eval(std::get<std::unique_ptr<Exp>>(elem).get());
+            int value = EvalNode(std::get<Exp *>(elem));
             if (first)
             {
                 result = (value != 0);
@@ -220,9 +247,9 @@ int EvalConstant::VisitLAndExp(LAndExp *exp)
     TokenType op = TokenType::UNKNOW;
     for (auto &elem : exp->elements_)
     {
-        if (std::holds_alternative<std::unique_ptr<Exp>>(elem))
+        if (std::holds_alternative<Exp *>(elem))
         {
-            int value = Eval(std::get<std::unique_ptr<Exp>>(elem).get());
+            int value = EvalNode(std::get<Exp *>(elem));
             if (first)
             {
                 result = (value != 0);
@@ -252,9 +279,9 @@ int EvalConstant::VisitEqExp(EqExp *exp)
     TokenType op = TokenType::UNKNOW;
     for (auto &elem : exp->elements_)
     {
-        if (std::holds_alternative<std::unique_ptr<Exp>>(elem))
+        if (std::holds_alternative<Exp *>(elem))
         {
-            int value = Eval(std::get<std::unique_ptr<Exp>>(elem).get());
+            int value = EvalNode(std::get<Exp *>(elem));
             if (first)
             {
                 result = value;
@@ -286,9 +313,9 @@ int EvalConstant::VisitRelExp(RelExp *exp)
     TokenType op = TokenType::UNKNOW;
     for (auto &elem : exp->elements_)
     {
-        if (std::holds_alternative<std::unique_ptr<Exp>>(elem))
+        if (std::holds_alternative<Exp *>(elem))
         {
-            int value = Eval(std::get<std::unique_ptr<Exp>>(elem).get());
+            int value = EvalNode(std::get<Exp *>(elem));
             if (first)
             {
                 result = value;
@@ -318,23 +345,142 @@ int EvalConstant::VisitRelExp(RelExp *exp)
 
 int EvalConstant::VisitCallExp(CallExp *exp)
 {
-    // 常量表达式中一般不允许函数调用
+    // 常量表达式中不允许函数调用，处理同 VisitLValExp
+    constant_ = false;
     return 0;
-    throw std::runtime_error("Function call not allowed in constant expression.");
 }
 
 int EvalConstant::VisitInitVal(InitVal *initVal)
 {
-    if (std::holds_alternative<std::unique_ptr<Exp>>(initVal->value_))
+    if (std::holds_alternative<Exp *>(initVal->value_))
     {
-        return Eval(std::get<std::unique_ptr<Exp>>(initVal->value_).get());
+        return EvalNode(std::get<Exp *>(initVal->value_));
     }
 }
 
 int EvalConstant::VisitConstInitVal(ConstInitVal *constInitVal)
 {
-    if (std::holds_alternative<std::unique_ptr<Exp>>(constInitVal->value_))
+    if (std::holds_alternative<Exp *>(constInitVal->value_))
+    {
+        return EvalNode(std::get<Exp *>(constInitVal->value_));
+    }
+}
+int EvalConstant::Eval(const FlatAst &ast, uint32_t index)
+{
+    const FlatNode &node = ast[index];
+    switch (node.kind())
     {
-        return Eval(std::get<std::unique_ptr<Exp>>(constInitVal->value_).get());
+    case Node::ND_Number:
+        return node.value_;
+
+    case Node::ND_AddExp:
+    case Node::ND_MulExp:
+    case Node::ND_LOrExp:
+    case Node::ND_LAndExp:
+    case Node::ND_EqExp:
+    case Node::ND_RelExp:
+        return EvalFlatLayer(ast, index);
+
+    case Node::ND_UnaryExp:
+    {
+        int operand = Eval(ast, index + 1);
+        switch (static_cast<UnaryExp::Op>(node.unaryOp_))
+        {
+        case UnaryExp::Op::Minus:
+            return -operand;
+        case UnaryExp::Op::Not:
+            return (operand == 0) ? 1 : 0;
+        default:
+            return operand;
+        }
     }
-}
\ No newline at end of file
+
+    case Node::ND_LVal:
+    case Node::ND_CallExp:
+        // 与 VisitLValExp / VisitCallExp 相同
+        return 0;
+
+    case Node::ND_PrimaryExp:
+        return Eval(ast, index + 1);
+
+    case Node::ND_InitVal:
+    case Node::ND_ConstInitVal:
+        if (node.flags_ & FlatAst::kList)
+            throw std::runtime_error("Initializer list cannot be evaluated as a constant.");
+        return Eval(ast, index + 1);
+
+    default:
+        throw std::runtime_error("Unsupported node type in constant evaluation.");
+    }
+}
+
+// 二元层：各操作数依次为子节点，运算符内联在操作数的 op_ 中（首个操作数为 UNKNOW）
+int EvalConstant::EvalFlatLayer(const FlatAst &ast, uint32_t index)
+{
+    Node::Kind kind = ast.kind(index);
+    bool logical = kind == Node::ND_LOrExp || kind == Node::ND_LAndExp;
+    bool first = true;
+    int result = 0;
+    for (uint32_t child : ast.children(index))
+    {
+        int value = Eval(ast, child);
+        if (logical)
+            value = (value != 0);
+        if (first)
+        {
+            result = value;
+            first = false;
+            continue;
+        }
+
+        switch (ast[child].op())
+        {
+        case TokenType::OPERATOR_PLUS:
+            result += value;
+            break;
+        case TokenType::OPERATOR_MINUS:
+            result -= value;
+            break;
+        case TokenType::OPERATOR_MULTIPLY:
+            result *= value;
+            break;
+        case TokenType::OPERATOR_DIVIDE:
+            if (value == 0)
+                throw std::runtime_error("Division by zero in constant expression.");
+            result /= value;
+            break;
+        case TokenType::OPERATOR_MODULO:
+            if (value == 0)
+                throw std::runtime_error("Modulo by zero in constant expression.");
+            result %= value;
+            break;
+        case TokenType::OPERATOR_LOGICAL_OR:
+            result = result || value;
+            break;
+        case TokenType::OPERATOR_LOGICAL_AND:
+            result = result && value;
+            break;
+        case TokenType::OPERATOR_EQUAL:
+            result = (result == value) ? 1 : 0;
+            break;
+        case TokenType::OPERATOR_NOT_EQUAL:
+            result = (result != value) ? 1 : 0;
+            break;
+        case TokenType::OPERATOR_LESS:
+            result = (result < value) ? 1 : 0;
+            break;
+        case TokenType::OPERATOR_GREATER:
+            result = (result > value) ? 1 : 0;
+            break;
+        case TokenType::OPERATOR_LESS_EQUAL:
+            result = (result <= value) ? 1 : 0;
+            break;
+        case TokenType::OPERATOR_GREATER_EQUAL:
+            result = (result >= value) ? 1 : 0;
+            break;
+        default:
+            throw std::runtime_error("Invalid operator in binary expression.");
+        }
+    }
+    return result;
+}
@@ -0,0 +1,768 @@
+#include "flatAst.h"
+#include "llvm/ADT/SmallVector.h"
+
+namespace AST
+{
+    // 按先序遍历指针树，逐个追加扁平节点；子节点访问完毕后回填 end_
+    class FlatAstBuilder : public Visitor
+    {
+    public:
+        FlatAstBuilder(FlatAst &ast, std::vector<Node *> *origins) : ast_(ast), origins_(origins) {}
+
+        void visit(CompUnit &node) override
+        {
+            uint32_t self = open(node);
+            for (auto *decl : node.decls_)
+                decl->accept(*this);
+            for (auto *func : node.funcDefs_)
+                func->accept(*this);
+            visitIf(node.mainfuncDef_);
+            close(self);
+        }
+
+        void visit(ConstDef &node) override
+        {
+            uint32_t self = open(node, node.nameId_);
+            if (node.hasInit)
+                ast_.nodes_[self].flags_ |= FlatAst::kHasInit;
+            for (auto *dim : node.dimensions_)
+                dim->accept(*this);
+            visitIf(node.initVal_);
+            close(self);
+        }
+
+        void visit(ConstDecl &node) override
+        {
+            uint32_t self = open(node);
+            visitIf(node.bType_);
+            for (auto *def : node.constDefs_)
+                def->accept(*this);
+            close(self);
+        }
+
+        void visit(VarDef &node) override
+        {
+            uint32_t self = open(node, node.nameId_);
+            if (node.hasInit)
+                ast_.nodes_[self].flags_ |= FlatAst::kHasInit;
+            for (auto *dim : node.constExps_)
+                dim->accept(*this);
+            visitIf(node.initVal_);
+            close(self);
+        }
+
+        void visit(VarDecl &node) override
+        {
+            uint32_t self = open(node);
+            visitIf(node.bType_);
+            for (auto *def : node.varDefs_)
+                def->accept(*this);
+            close(self);
+        }
+
+        void visit(BType &node) override
+        {
+            close(open(node));
+        }
+
+        void visit(InitVal &node) override
+        {
+            uint32_t self = open(node);
+            if (auto *exp = std::get_if<Exp *>(&node.value_))
+            {
+                (*exp)->accept(*this);
+            }
+            else
+            {
+                ast_.nodes_[self].flags_ |= FlatAst::kList;
+                for (auto *item : std::get<llvm::ArrayRef<InitVal *>>(node.value_))
+                    item->accept(*this);
+            }
+            close(self);
+        }
+
+        void visit(ConstInitVal &node) override
+        {
+            uint32_t self = open(node);
+            if (auto *exp = std::get_if<Exp *>(&node.value_))
+            {
+                (*exp)->accept(*this);
+            }
+            else
+            {
+                ast_.nodes_[self].flags_ |= FlatAst::kList;
+                for (auto *item : std::get<llvm::ArrayRef<ConstInitVal *>>(node.value_))
+                    item->accept(*this);
+            }
+            close(self);
+        }
+
+        void visit(ExpStmt &node) override
+        {
+            uint32_t self = open(node);
+            visitIf(node.exp_);
+            close(self);
+        }
+
+        void visit(Block &node) override
+        {
+            uint32_t self = open(node);
+            for (auto *item : node.items_)
+                item->accept(*this);
+            close(self);
+        }
+
+        void visit(BlockItem &node) override
+        {
+            uint32_t self = open(node);
+            visitIf(node.item_);
+            close(self);
+        }
+
+        void visit(AssignStmt &node) override
+        {
+            uint32_t self = open(node);
+            node.lval_->accept(*this);
+            node.exp_->accept(*this);
+            close(self);
+        }
+
+        void visit(IfStmt &node) override
+        {
+            uint32_t self = open(node);
+            node.cond_->accept(*this);
+            node.thenBranch_->accept(*this);
+            visitIf(node.elseBranch_);
+            close(self);
+        }
+
+        void visit(WhileStmt &node) override
+        {
+            uint32_t self = open(node);
+            node.cond_->accept(*this);
+            node.body_->accept(*this);
+            close(self);
+        }
+
+        void visit(ReturnStmt &node) override
+        {
+            uint32_t self = open(node);
+            visitIf(node.exp_);
+            close(self);
+        }
+
+        void visit(IOStmt &node) override
+        {
+            uint32_t self;
+            if (node.kind == IOStmt::IOKind::Getint)
+            {
+                self = open(node);
+                node.target_->accept(*this);
+            }
+            else
+            {
+                self = open(node, static_cast<int32_t>(ast_.strings_.size()));
+                ast_.nodes_[self].flags_ |= FlatAst::kPrintf;
+                ast_.strings_.push_back(node.formatString_);
+                for (auto *arg : node.args_)
+                    arg->accept(*this);
+            }
+            close(self);
+        }
+
+        void visit(Number &node) override
+        {
+            close(open(node, node.value_));
+        }
+
+        void visit(LVal &node) override
+        {
+            uint32_t self = open(node, node.nameId_);
+            for (auto *index : node.indices_)
+                index->accept(*this);
+            close(self);
+        }
+
+        void visit(PrimaryExp &node) override
+        {
+            uint32_t self = open(node);
+            std::visit([this](auto *operand) { operand->accept(*this); }, node.operand_);
+            close(self);
+        }
+
+        void visit(UnaryExp &node) override
+        {
+            uint32_t self = open(node);
+            ast_.nodes_[self].unaryOp_ = static_cast<uint8_t>(node.op);
+            node.operand_->accept(*this);
+            close(self);
+        }
+
+        void visit(AddExp &node) override
+        {
+            visitLayer(node, node.elements_);
+        }
+        void visit(MulExp &node) override
+        {
+            visitLayer(node, node.elements_);
+        }
+        void visit(LOrExp &node) override
+        {
+            visitLayer(node, node.elements_);
+        }
+        void visit(LAndExp &node) override
+        {
+            visitLayer(node, node.elements_);
+        }
+        void visit(EqExp &node) override
+        {
+            visitLayer(node, node.elements_);
+        }
+        void visit(RelExp &node) override
+        {
+            visitLayer(node, node.elements_);
+        }
+
+        void visit(CallExp &node) override
+        {
+            uint32_t self = open(node, node.funcId_);
+            for (auto *arg : node.args_)
+                arg->accept(*this);
+            close(self);
+        }
+
+        void visit(FuncParam &node) override
+        {
+            uint32_t self = open(node, node.nameId_);
+            if (node.isArray_)
+                ast_.nodes_[self].flags_ |= FlatAst::kArray;
+            for (auto *dim : node.dimSizes_)
+            {
+                if (dim)
+                    dim->accept(*this);
+                else
+                    ast_.nodes_[self].flags_ |= FlatAst::kEmptyFirstDim;
+            }
+            close(self);
+        }
+
+        void visit(FuncDef &node) override
+        {
+            uint32_t self = open(node, node.nameId_);
+            visitIf(node.returnType_);
+            for (auto *param : node.params_)
+                param->accept(*this);
+            visitIf(node.body_);
+            close(self);
+        }
+
+        void visit(MainFuncDef &node) override
+        {
+            uint32_t self = open(node);
+            visitIf(node.body_);
+            close(self);
+        }
+
+        void visit(FuncType &node) override
+        {
+            uint32_t self = open(node);
+            if (node.typeName_ == "void")
+                ast_.nodes_[self].flags_ |= FlatAst::kVoid;
+            close(self);
+        }
+
+    private:
+        FlatAst &ast_;
+        std::vector<Node *> *origins_;
+        // 二元层中下一个操作数前的运算符，由 open() 写入该操作数节点
+        TokenType pendingOp_ = TokenType::UNKNOW;
+
+        uint32_t open(Node &node, int32_t value = 0)
+        {
+            uint32_t index = ast_.size();
+            FlatNode flat{};
+            flat.kind_ = static_cast<uint8_t>(node.getKind());
+            flat.op_ = static_cast<uint8_t>(pendingOp_);
+            flat.value_ = value;
+            ast_.nodes_.push_back(flat);
+            if (origins_)
+                origins_->push_back(&node);
+            pendingOp_ = TokenType::UNKNOW;
+            return index;
+        }
+
+        void close(uint32_t index)
+        {
+            ast_.nodes_[index].end_ = ast_.size();
+        }
+
+        void visitIf(Node *node)
+        {
+            if (node)
+                node->accept(*this);
+        }
+
+        void visitLayer(Node &node, llvm::ArrayRef<std::variant<Exp *, TokenType>> elements)
+        {
+            uint32_t self = open(node);
+            for (auto &elem : elements)
+            {
+                if (auto *exp = std::get_if<Exp *>(&elem))
+                    (*exp)->accept(*this);
+                else
+                    pendingOp_ = std::get<TokenType>(elem);
+            }
+            close(self);
+        }
+    };
+
+    // FlatAstBuilder 的逆过程：按子节点布局递归重建各节点。
+    // 输入可能来自缓存文件，先校验子树区间互相嵌套，再在重建时核对每个位置上的节点种类，不符时置 failed_
+    class FlatAstMaterializer
+    {
+    public:
+        FlatAstMaterializer(const FlatAst &ast, AstArena &arena, const StringInterner &interner)
+            : ast_(ast), arena_(arena), interner_(interner)
+        {
+        }
+
+        CompUnit *run()
+        {
+            if (!wellNested())
+                return nullptr;
+            auto *root = static_cast<CompUnit *>(expect(FlatAst::kRoot, Node::ND_CompUnit));
+            return failed_ ? nullptr : root;
+        }
+
+    private:
+        const FlatAst &ast_;
+        AstArena &arena_;
+        const StringInterner &interner_;
+        bool failed_ = false;
+
+        // 每个节点的区间 [index, end_) 非空，且包含在父节点的区间内
+        bool wellNested() const
+        {
+            if (ast_.size() == 0 || ast_[FlatAst::kRoot].end_ != ast_.size())
+                return false;
+            llvm::SmallVector<uint32_t, 32> open;
+            for (uint32_t i = 0; i < ast_.size(); ++i)
+            {
+                while (!open.empty() && open.back() <= i)
+                    open.pop_back();
+                uint32_t end = ast_[i].end_;
+                if (end <= i || (!open.empty() && end > open.back()))
+                    return false;
+                open.push_back(end);
+            }
+            return true;
+        }
+
+        Node *fail()
+        {
+            failed_ = true;
+            return nullptr;
+        }
+
+        Node *expect(uint32_t index, Node::Kind kind)
+        {
+            return ast_.kind(index) == kind ? build(index) : fail();
+        }
+
+        Exp *exp(uint32_t index)
+        {
+            Node::Kind kind = ast_.kind(index);
+            return kind >= Node::ND_LVal && kind <= Node::ND_Number ? static_cast<Exp *>(build(index))
+                                                                     : static_cast<Exp *>(fail());
+        }
+
+        Stmt *stmt(uint32_t index)
+        {
+            Node::Kind kind = ast_.kind(index);
+            return (kind >= Node::ND_ExpStmt && kind <= Node::ND_IOStmt) || kind == Node::ND_Block
+                       ? static_cast<Stmt *>(build(index))
+                       : static_cast<Stmt *>(fail());
+        }
+
+        bool isDecl(uint32_t index) const
+        {
+            return ast_.kind(index) == Node::ND_ConstDecl || ast_.kind(index) == Node::ND_VarDecl;
+        }
+
+        // 带名字节点的 value_ 为驻留编号
+        std::string_view name(uint32_t index)
+        {
+            SymbolId id = static_cast<SymbolId>(ast_[index].value_);
+            if (id >= interner_.size())
+                fail();
+            return interner_.spelling(id);
+        }
+
+        // 收集 [first, end) 中种类相同的连续兄弟节点，返回第一个不属于该种类的兄弟
+        template <typename T>
+        uint32_t collect(uint32_t first, uint32_t end, Node::Kind kind, llvm::ArrayRef<T *> &out)
+        {
+            llvm::SmallVector<T *, 8> items;
+            for (; first != end && ast_.kind(first) == kind; first = ast_[first].end_)
+                items.push_back(static_cast<T *>(build(first)));
+            out = arena_.copy(items);
+            return first;
+        }
+
+        uint32_t collectExps(uint32_t first, uint32_t end, llvm::ArrayRef<Exp *> &out)
+        {
+            llvm::SmallVector<Exp *, 8> items;
+            for (; first != end && ast_.kind(first) >= Node::ND_LVal && ast_.kind(first) <= Node::ND_Number;
+                 first = ast_[first].end_)
+                items.push_back(exp(first));
+            out = arena_.copy(items);
+            return first;
+        }
+
+        // 初始化值：单个表达式，或 kList 下的子初始化值列表
+        template <typename T>
+        T *initVal(uint32_t index)
+        {
+            auto *node = arena_.make<T>();
+            const FlatNode &flat = ast_[index];
+            if (flat.flags_ & FlatAst::kList)
+            {
+                llvm::ArrayRef<T *> items;
+                if (collect(index + 1, flat.end_, ast_.kind(index), items) != flat.end_)
+                    fail();
+                node->value_ = items;
+            }
+            else if (index + 1 < flat.end_ && ast_[index + 1].end_ == flat.end_)
+            {
+                node->value_ = exp(index + 1);
+            }
+            else
+            {
+                fail();
+            }
+            return node;
+        }
+
+        template <typename T>
+        T *layer(uint32_t index)
+        {
+            auto *node = arena_.make<T>();
+            llvm::SmallVector<std::variant<Exp *, TokenType>, 8> elements;
+            for (uint32_t child : ast_.children(index))
+            {
+                if (!elements.empty())
+                {
+                    if (ast_[child].op_ > static_cast<uint8_t>(TokenType::ERROR))
+                        fail();
+                    elements.push_back(ast_[child].op());
+                }
+                elements.push_back(exp(child));
+            }
+            if (elements.empty())
+                fail();
+            node->elements_ = arena_.copy(elements);
+            return node;
+        }
+
+        // 至多一个子节点的节点：返回该子节点下标，没有子节点时返回 end_
+        uint32_t optionalChild(uint32_t index)
+        {
+            uint32_t first = index + 1;
+            uint32_t end = ast_[index].end_;
+            if (first != end && ast_[first].end_ != end)
+                fail();
+            return first;
+        }
+
+        Node *build(uint32_t index)
+        {
+            if (failed_)
+                return nullptr;
+            const FlatNode &flat = ast_[index];
+            uint32_t first = index + 1;
+            uint32_t end = flat.end_;
+
+            switch (flat.kind())
+            {
+            case Node::ND_CompUnit:
+            {
+                auto *node = arena_.make<CompUnit>();
+                llvm::SmallVector<Decl *, 8> decls;
+                for (; first != end && isDecl(first); first = ast_[first].end_)
+                    decls.push_back(static_cast<Decl *>(build(first)));
+                node->decls_ = arena_.copy(decls);
+                first = collect(first, end, Node::ND_FuncDef, node->funcDefs_);
+                if (first == end)
+                    return node; // 不含 main 的编译单元
+                if (ast_[first].end_ != end)
+                    return fail();
+                node->mainfuncDef_ = static_cast<MainFuncDef *>(expect(first, Node::ND_MainFuncDef));
+                return node;
+            }
+            case Node::ND_ConstDecl:
+            {
+                auto *node = arena_.make<ConstDecl>();
+                if (first != end && ast_.kind(first) == Node::ND_BType)
+                {
+                    node->bType_ = static_cast<BType *>(build(first));
+                    first = ast_[first].end_;
+                }
+                if (collect(first, end, Node::ND_ConstDef, node->constDefs_) != end)
+                    fail();
+                return node;
+            }
+            case Node::ND_VarDecl:
+            {
+                auto *node = arena_.make<VarDecl>();
+                if (first != end && ast_.kind(first) == Node::ND_BType)
+                {
+                    node->bType_ = static_cast<BType *>(build(first));
+                    first = ast_[first].end_;
+                }
+                if (collect(first, end, Node::ND_VarDef, node->varDefs_) != end)
+                    fail();
+                return node;
+            }
+            case Node::ND_ConstDef:
+            {
+                auto *node = arena_.make<ConstDef>();
+                node->nameId_ = static_cast<SymbolId>(flat.value_);
+                node->name_ = name(index);
+                node->hasInit = flat.flags_ & FlatAst::kHasInit;
+                // 解析器保证常量定义总带初始化值
+                first = collectExps(first, end, node->dimensions_);
+                if (first == end || ast_[first].end_ != end)
+                    return fail();
+                node->initVal_ = static_cast<ConstInitVal *>(expect(first, Node::ND_ConstInitVal));
+                return node;
+            }
+            case Node::ND_VarDef:
+            {
+                auto *node = arena_.make<VarDef>();
+                node->nameId_ = static_cast<SymbolId>(flat.value_);
+                node->name_ = name(index);
+                node->hasInit = flat.flags_ & FlatAst::kHasInit;
+                first = collectExps(first, end, node->constExps_);
+                if (node->hasInit != (first != end))
+                    return fail();
+                if (first != end)
+                {
+                    node->initVal_ = static_cast<InitVal *>(expect(first, Node::ND_InitVal));
+                    if (ast_[first].end_ != end)
+                        fail();
+                }
+                return node;
+            }
+            case Node::ND_BType:
+                return arena_.make<BType>();
+            case Node::ND_InitVal:
+                return initVal<InitVal>(index);
+            case Node::ND_ConstInitVal:
+                return initVal<ConstInitVal>(index);
+            case Node::ND_ExpStmt:
+            {
+                auto *node = arena_.make<ExpStmt>();
+                uint32_t child = optionalChild(index);
+                if (child != end)
+                    node->exp_ = exp(child);
+                return node;
+            }
+            case Node::ND_Block:
+            {
+                auto *node = arena_.make<Block>();
+                if (collect(first, end, Node::ND_BlockItem, node->items_) != end)
+                    fail();
+                return node;
+            }
+            case Node::ND_BlockItem:
+            {
+                auto *node = arena_.make<BlockItem>();
+                uint32_t child = optionalChild(index);
+                if (child != end)
+                    node->item_ = isDecl(child) ? build(child) : stmt(child);
+                return node;
+            }
+            case Node::ND_AssignStmt:
+            {
+                auto *node = arena_.make<AssignStmt>();
+                if (first == end || ast_[first].end_ == end || ast_[ast_[first].end_].end_ != end)
+                    return fail();
+                node->lval_ = static_cast<LVal *>(expect(first, Node::ND_LVal));
+                node->exp_ = exp(ast_[first].end_);
+                return node;
+            }
+            case Node::ND_IfStmt:
+            {
+                auto *node = arena_.make<IfStmt>();
+                if (first == end || ast_[first].end_ == end)
+                    return fail();
+                uint32_t then = ast_[first].end_;
+                node->cond_ = exp(first);
+                node->thenBranch_ = stmt(then);
+                if (ast_[then].end_ != end)
+                {
+                    node->elseBranch_ = stmt(ast_[then].end_);
+                    if (ast_[ast_[then].end_].end_ != end)
+                        fail();
+                }
+                return node;
+            }
+            case Node::ND_WhileStmt:
+            {
+                auto *node = arena_.make<WhileStmt>();
+                if (first == end || ast_[first].end_ == end || ast_[ast_[first].end_].end_ != end)
+                    return fail();
+                node->cond_ = exp(first);
+                node->body_ = stmt(ast_[first].end_);
+                return node;
+            }
+            case Node::ND_ReturnStmt:
+            {
+                auto *node = arena_.make<ReturnStmt>();
+                uint32_t child = optionalChild(index);
+                if (child != end)
+                    node->exp_ = exp(child);
+                return node;
+            }
+            case Node::ND_IOStmt:
+            {
+                auto *node = arena_.make<IOStmt>();
+                if (flat.flags_ & FlatAst::kPrintf)
+                {
+                    node->kind = IOStmt::IOKind::Printf;
+                    if (static_cast<uint32_t>(flat.value_) >= ast_.strings_.size())
+                        return fail();
+                    node->formatString_ = arena_.copy(ast_.string(index));
+                    if (collectExps(first, end, node->args_) != end)
+                        fail();
+                }
+                else
+                {
+                    node->kind = IOStmt::IOKind::Getint;
+                    if (first == end || ast_[first].end_ != end)
+                        return fail();
+                    node->target_ = static_cast<LVal *>(expect(first, Node::ND_LVal));
+                }
+                return node;
+            }
+            case Node::ND_Number:
+            {
+                auto *node = arena_.make<Number>();
+                node->value_ = flat.value_;
+                return first == end ? node : fail();
+            }
+            case Node::ND_LVal:
+            {
+                auto *node = arena_.make<LVal>();
+                node->nameId_ = static_cast<SymbolId>(flat.value_);
+                node->name_ = name(index);
+                if (collectExps(first, end, node->indices_) != end)
+                    fail();
+                return node;
+            }
+            case Node::ND_PrimaryExp:
+            {
+                auto *node = arena_.make<PrimaryExp>();
+                if (first == end || ast_[first].end_ != end)
+                    return fail();
+                node->operand_ = exp(first);
+                return node;
+            }
+            case Node::ND_UnaryExp:
+            {
+                auto *node = arena_.make<UnaryExp>();
+                if (flat.unaryOp_ > static_cast<uint8_t>(UnaryExp::Op::Init) || first == end || ast_[first].end_ != end)
+                    return fail();
+                node->op = static_cast<UnaryExp::Op>(flat.unaryOp_);
+                node->operand_ = exp(first);
+                return node;
+            }
+            case Node::ND_AddExp:
+                return layer<AddExp>(index);
+            case Node::ND_MulExp:
+                return layer<MulExp>(index);
+            case Node::ND_LOrExp:
+                return layer<LOrExp>(index);
+            case Node::ND_LAndExp:
+                return layer<LAndExp>(index);
+            case Node::ND_EqExp:
+                return layer<EqExp>(index);
+            case Node::ND_RelExp:
+                return layer<RelExp>(index);
+            case Node::ND_CallExp:
+            {
+                auto *node = arena_.make<CallExp>();
+                node->funcId_ = static_cast<SymbolId>(flat.value_);
+                node->funcName = name(index);
+                if (collectExps(first, end, node->args_) != end)
+                    fail();
+                return node;
+            }
+            case Node::ND_FuncParam:
+            {
+                auto *node = arena_.make<FuncParam>();
+                node->bType_ = arena_.make<BType>();
+                node->nameId_ = static_cast<SymbolId>(flat.value_);
+                node->name_ = name(index);
+                node->isArray_ = flat.flags_ & FlatAst::kArray;
+                llvm::ArrayRef<Exp *> dims;
+                if (collectExps(first, end, dims) != end)
+                    fail();
+                if (flat.flags_ & FlatAst::kEmptyFirstDim)
+                {
+                    llvm::SmallVector<Exp *, 4> withEmpty{nullptr};
+                    withEmpty.append(dims.begin(), dims.end());
+                    dims = arena_.copy(withEmpty);
+                }
+                node->dimSizes_ = dims;
+                return node;
+            }
+            case Node::ND_FuncDef:
+            {
+                auto *node = arena_.make<FuncDef>();
+                node->nameId_ = static_cast<SymbolId>(flat.value_);
+                node->name_ = name(index);
+                if (first == end)
+                    return fail();
+                node->returnType_ = static_cast<FuncType *>(expect(first, Node::ND_FuncType));
+                first = collect(ast_[first].end_, end, Node::ND_FuncParam, node->params_);
+                if (first == end || ast_[first].end_ != end)
+                    return fail();
+                node->body_ = static_cast<Block *>(expect(first, Node::ND_Block));
+                return node;
+            }
+            case Node::ND_MainFuncDef:
+            {
+                auto *node = arena_.make<MainFuncDef>();
+                if (first == end || ast_[first].end_ != end)
+                    return fail();
+                node->body_ = static_cast<Block *>(expect(first, Node::ND_Block));
+                return node;
+            }
+            case Node::ND_FuncType:
+            {
+                auto *node = arena_.make<FuncType>();
+                node->typeName_ = flat.flags_ & FlatAst::kVoid ? "void" : "int";
+                return first == end ? node : fail();
+            }
+            default:
+                return fail();
+            }
+        }
+    };
+
+    FlatAst FlatAst::build(CompUnit &root, std::vector<Node *> *origins)
+    {
+        FlatAst ast;
+        if (origins)
+            origins->clear();
+        FlatAstBuilder builder(ast, origins);
+        root.accept(builder);
+        return ast;
+    }
+
+    CompUnit *FlatAst::materialize(AstArena &arena, const StringInterner &interner) const
+    {
+        return FlatAstMaterializer(*this, arena, interner).run();
+    }
+}
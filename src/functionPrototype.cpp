@@ -0,0 +1,37 @@
+#include "functionPrototype.h"
+#include "evalConstant.h"
+
+std::vector<FunctionPrototype> collectPrototypes(AST::CompUnit &unit)
+{
+    EvalConstant evaluator;
+    std::vector<FunctionPrototype> prototypes;
+    prototypes.reserve(unit.funcDefs_.size());
+    for (FuncDef *funcDef : unit.funcDefs_)
+    {
+        FunctionPrototype prototype;
+        prototype.name_ = std::string(funcDef->name_);
+        prototype.returnsInt_ = funcDef->returnType_->typeName_ == "int";
+        for (FuncParam *param : funcDef->params_)
+        {
+            FunctionParamShape shape;
+            shape.isArray_ = param->isArray_;
+            // 与 CodeGenerator::visit(FuncDef &) 一致：跳过首维，其余各维必须为常量
+            for (size_t i = 1; i < param->dimSizes_.size(); ++i)
+            {
+                int dim = 0;
+                try
+                {
+                    dim = evaluator.Eval(param->dimSizes_[i]);
+                }
+                catch (std::runtime_error &)
+                {
+                    // 按 0 处理；定义所在单元的代码生成会再次求值同一维度
+                }
+                shape.innerDims_.push_back(dim);
+            }
+            prototype.params_.push_back(std::move(shape));
+        }
+        prototypes.push_back(std::move(prototype));
+    }
+    return prototypes;
+}
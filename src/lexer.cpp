@@ -1,9 +1,424 @@
 #include "lexer.h"
+#include "charScanner.h"
+#include "threadPool.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <iomanip>
+#include <limits>
 
-Token::Token() : tokenType_(TokenType::UNKNOW), value_(std::string("unknow")), line_(-1), colume_(-1) {}
+namespace
+{
+    // 关键字表：编译期据此生成完美哈希表
+    struct KeywordEntry
+    {
+        std::string_view spelling;
+        TokenType type;
+    };
+
+    constexpr KeywordEntry kKeywords[] = {
+        {"auto", TokenType::KEYWORD_AUTO},
+        {"break", TokenType::KEYWORD_BREAK},
+        {"case", TokenType::KEYWORD_CASE},
+        {"char", TokenType::KEYWORD_CHAR},
+        {"const", TokenType::KEYWORD_CONST},
+        {"continue", TokenType::KEYWORD_CONTINUE},
+        {"default", TokenType::KEYWORD_DEFAULT},
+        {"do", TokenType::KEYWORD_DO},
+        {"double", TokenType::KEYWORD_DOUBLE},
+        {"else", TokenType::KEYWORD_ELSE},
+        {"enum", TokenType::KEYWORD_ENUM},
+        {"extern", TokenType::KEYWORD_EXTERN},
+        {"float", TokenType::KEYWORD_FLOAT},
+        {"for", TokenType::KEYWORD_FOR},
+        {"goto", TokenType::KEYWORD_GOTO},
+        {"if", TokenType::KEYWORD_IF},
+        {"int", TokenType::KEYWORD_INT},
+        {"long", TokenType::KEYWORD_LONG},
+        {"register", TokenType::KEYWORD_REGISTER},
+        {"return", TokenType::KEYWORD_RETURN},
+        {"short", TokenType::KEYWORD_SHORT},
+        {"signed", TokenType::KEYWORD_SIGNED},
+        {"sizeof", TokenType::KEYWORD_SIZEOF},
+        {"static", TokenType::KEYWORD_STATIC},
+        {"struct", TokenType::KEYWORD_STRUCT},
+        {"switch", TokenType::KEYWORD_SWITCH},
+        {"typedef", TokenType::KEYWORD_TYPEDEF},
+        {"union", TokenType::KEYWORD_UNION},
+        {"unsigned", TokenType::KEYWORD_UNSIGNED},
+        {"void", TokenType::KEYWORD_VOID},
+        {"volatile", TokenType::KEYWORD_VOLATILE},
+        {"while", TokenType::KEYWORD_WHILE},
+
+        {"getint", TokenType::KEYWORD_GETINT},
+        {"printf", TokenType::KEYWORD_PRINTF},
+        {"main", TokenType::KEYWORD_MAIN}};
+
+    constexpr size_t kKeywordCount = sizeof(kKeywords) / sizeof(kKeywords[0]);
+    constexpr size_t kKeywordTableSize = 128; // 2 的幂
+
+    // 由首字符、第二个字符、末字符和长度组合出的哈希，系数保证对上表无冲突
+    constexpr size_t keywordHash(std::string_view word)
+    {
+        return (static_cast<unsigned char>(word[0]) +
+                static_cast<unsigned char>(word[1]) * 5u +
+                static_cast<unsigned char>(word[word.size() - 1]) * 12u +
+                word.size()) &
+               (kKeywordTableSize - 1);
+    }
+
+    // 槽位中保存关键字下标 + 1，0 表示空槽
+    constexpr std::array<uint8_t, kKeywordTableSize> buildKeywordTable()
+    {
+        std::array<uint8_t, kKeywordTableSize> table{};
+        for (size_t i = 0; i < kKeywordCount; ++i)
+        {
+            table[keywordHash(kKeywords[i].spelling)] = static_cast<uint8_t>(i + 1);
+        }
+        return table;
+    }
+
+    constexpr std::array<uint8_t, kKeywordTableSize> kKeywordTable = buildKeywordTable();
+
+    constexpr bool keywordTableIsPerfect()
+    {
+        for (size_t i = 0; i < kKeywordCount; ++i)
+        {
+            if (kKeywordTable[keywordHash(kKeywords[i].spelling)] != i + 1)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static_assert(keywordTableIsPerfect(), "keyword hash has collisions, adjust keywordHash coefficients");
+
+    // ---------------- 词法状态机 ----------------
+
+    // 字符类别：状态机只按类别转移，256 项表在编译期生成
+    enum CharClass : uint8_t
+    {
+        CC_OTHER,      // 无法开始任何 token 的字符（含 '%' '^' '~' '?' ':' '.' 与非 ASCII 字节）
+        CC_LETTER,     // 其余字母
+        CC_HEX_LETTER, // a-d A-D
+        CC_E,          // e E：十六进制数字 / 指数
+        CC_F,          // f F：十六进制数字 / 浮点后缀
+        CC_L,          // l L：浮点后缀
+        CC_N,          // n：字符串中唯一合法的转义
+        CC_X,          // x X：十六进制前缀
+        CC_UNDERSCORE, // _
+        CC_ZERO,       // 0
+        CC_DIGIT,      // 1-9
+        CC_DOT,        // .
+        CC_QUOTE,      // "
+        CC_BACKSLASH,  // '\'
+        CC_PLUS,
+        CC_MINUS,
+        CC_STAR,
+        CC_SLASH,
+        CC_EQUAL,
+        CC_LESS,
+        CC_GREATER,
+        CC_BANG,
+        CC_AMP,
+        CC_PIPE,
+        CC_PUNCT, // { } ( ) ; , [ ]
+        kCharClassCount
+    };
+
+    constexpr std::array<uint8_t, 256> buildCharClasses()
+    {
+        std::array<uint8_t, 256> classes{};
+        for (int c = 'a'; c <= 'z'; ++c)
+        {
+            classes[c] = CC_LETTER;
+            classes[c - 'a' + 'A'] = CC_LETTER;
+        }
+        for (char c : {'a', 'b', 'c', 'd', 'A', 'B', 'C', 'D'})
+        {
+            classes[static_cast<unsigned char>(c)] = CC_HEX_LETTER;
+        }
+        classes['e'] = classes['E'] = CC_E;
+        classes['f'] = classes['F'] = CC_F;
+        classes['l'] = classes['L'] = CC_L;
+        classes['x'] = classes['X'] = CC_X;
+        classes['n'] = CC_N;
+        classes['_'] = CC_UNDERSCORE;
+        classes['0'] = CC_ZERO;
+        for (int c = '1'; c <= '9'; ++c)
+        {
+            classes[c] = CC_DIGIT;
+        }
+        classes['.'] = CC_DOT;
+        classes['"'] = CC_QUOTE;
+        classes['\\'] = CC_BACKSLASH;
+        classes['+'] = CC_PLUS;
+        classes['-'] = CC_MINUS;
+        classes['*'] = CC_STAR;
+        classes['/'] = CC_SLASH;
+        classes['='] = CC_EQUAL;
+        classes['<'] = CC_LESS;
+        classes['>'] = CC_GREATER;
+        classes['!'] = CC_BANG;
+        classes['&'] = CC_AMP;
+        classes['|'] = CC_PIPE;
+        for (char c : {'{', '}', '(', ')', ';', ',', '[', ']'})
+        {
+            classes[static_cast<unsigned char>(c)] = CC_PUNCT;
+        }
+        return classes;
+    }
+
+    constexpr std::array<uint8_t, 256> kCharClasses = buildCharClasses();
+
+    // 状态：S_DEAD 表示没有转移，token 在当前位置结束，按所处状态的动作产出
+    enum State : uint8_t
+    {
+        S_DEAD,
+        S_START,
+        S_IDENT,
+        // 数字：只覆盖合法写法，一旦出现会报错的写法就交给 readNumber 重新读取以得到同样的错误信息
+        S_NUM_ZERO,
+        S_NUM_INT,
+        S_NUM_DOT,
+        S_NUM_FRAC,
+        S_NUM_EXP,
+        S_NUM_EXP_SIGN,
+        S_NUM_EXP_DIGITS,
+        S_NUM_SUFFIX,
+        S_NUM_HEX_PREFIX,
+        S_NUM_HEX,
+        S_NUM_SLOW,
+        // 字符串
+        S_STRING,
+        S_STRING_ESCAPE,
+        S_STRING_END,
+        // 单字符 token
+        S_PUNCT,
+        S_UNKNOWN,
+        // 运算符，最长匹配
+        S_PLUS,
+        S_INCREMENT,
+        S_PLUS_ASSIGN,
+        S_MINUS,
+        S_DECREMENT,
+        S_MINUS_ASSIGN,
+        S_STAR,
+        S_STAR_ASSIGN,
+        S_SLASH,
+        S_SLASH_ASSIGN,
+        S_ASSIGN,
+        S_EQUAL,
+        S_BANG,
+        S_NOT_EQUAL,
+        S_LESS,
+        S_LESS_EQUAL,
+        S_LEFT_SHIFT,
+        S_LEFT_SHIFT_ASSIGN,
+        S_GREATER,
+        S_GREATER_EQUAL,
+        S_RIGHT_SHIFT,
+        S_RIGHT_SHIFT_ASSIGN,
+        S_AMP,
+        S_LOGICAL_AND,
+        S_AMP_ASSIGN,
+        S_PIPE,
+        S_LOGICAL_OR,
+        S_PIPE_ASSIGN,
+        kStateCount
+    };
+
+    // token 结束时的处理方式
+    enum class Action : uint8_t
+    {
+        Emit,           // 直接产出 StateInfo::type
+        Keyword,        // 标识符，再区分关键字
+        Punctuation,    // 界符
+        String,         // 字符串常量，可能跨行
+        Number,         // 数字写法有误，回退到 readNumber
+        InvalidEscape,  // 非法转义，token 截止到 '\' 之前
+        UnclosedString, // 字符串直到文件结束都未闭合
+    };
+
+    struct StateInfo
+    {
+        Action action;
+        TokenType type;
+    };
+
+    using TransitionTable = std::array<std::array<uint8_t, kCharClassCount>, kStateCount>;
+
+    constexpr void setTransition(TransitionTable &table, State from, std::initializer_list<CharClass> classes, State to)
+    {
+        for (CharClass c : classes)
+        {
+            table[from][c] = to;
+        }
+    }
+
+    constexpr TransitionTable buildTransitions()
+    {
+        TransitionTable table{};
+        const std::initializer_list<CharClass> kLetters = {CC_LETTER, CC_HEX_LETTER, CC_E, CC_F, CC_L, CC_N, CC_X};
+        const std::initializer_list<CharClass> kDigits = {CC_ZERO, CC_DIGIT};
+        const std::initializer_list<CharClass> kHexDigits = {CC_ZERO, CC_DIGIT, CC_HEX_LETTER, CC_E, CC_F};
+        // 使数字出错的字母：不是 e/E（指数）与 f/F/l/L（后缀）的字母
+        const std::initializer_list<CharClass> kBadSuffix = {CC_LETTER, CC_HEX_LETTER, CC_N, CC_X};
+
+        // 起始状态：任何字符都有去处，无法识别的字符单独成为 UNKNOW
+        for (auto &to : table[S_START])
+        {
+            to = S_UNKNOWN;
+        }
+        setTransition(table, S_START, kLetters, S_IDENT);
+        setTransition(table, S_START, {CC_UNDERSCORE}, S_IDENT);
+        setTransition(table, S_START, {CC_ZERO}, S_NUM_ZERO);
+        setTransition(table, S_START, {CC_DIGIT}, S_NUM_INT);
+        setTransition(table, S_START, {CC_QUOTE}, S_STRING);
+        setTransition(table, S_START, {CC_PUNCT}, S_PUNCT);
+        setTransition(table, S_START, {CC_PLUS}, S_PLUS);
+        setTransition(table, S_START, {CC_MINUS}, S_MINUS);
+        setTransition(table, S_START, {CC_STAR}, S_STAR);
+        setTransition(table, S_START, {CC_SLASH}, S_SLASH);
+        setTransition(table, S_START, {CC_EQUAL}, S_ASSIGN);
+        setTransition(table, S_START, {CC_BANG}, S_BANG);
+        setTransition(table, S_START, {CC_LESS}, S_LESS);
+        setTransition(table, S_START, {CC_GREATER}, S_GREATER);
+        setTransition(table, S_START, {CC_AMP}, S_AMP);
+        setTransition(table, S_START, {CC_PIPE}, S_PIPE);
+
+        // 标识符 / 关键字
+        setTransition(table, S_IDENT, kLetters, S_IDENT);
+        setTransition(table, S_IDENT, kDigits, S_IDENT);
+        setTransition(table, S_IDENT, {CC_UNDERSCORE}, S_IDENT);
+
+        // 十进制：整数部分 [. 小数部分] [指数] [f/F/l/L 后缀]
+        for (State state : {S_NUM_ZERO, S_NUM_INT})
+        {
+            setTransition(table, state, kDigits, S_NUM_INT);
+            setTransition(table, state, {CC_DOT}, S_NUM_DOT);
+            setTransition(table, state, {CC_E}, S_NUM_EXP);
+            setTransition(table, state, {CC_F, CC_L}, S_NUM_SUFFIX);
+            setTransition(table, state, kBadSuffix, S_NUM_SLOW);
+        }
+        setTransition(table, S_NUM_ZERO, {CC_X}, S_NUM_HEX_PREFIX);
+        setTransition(table, S_NUM_DOT, kDigits, S_NUM_FRAC);
+        setTransition(table, S_NUM_FRAC, kDigits, S_NUM_FRAC);
+        setTransition(table, S_NUM_FRAC, {CC_DOT}, S_NUM_SLOW);
+        setTransition(table, S_NUM_FRAC, {CC_E}, S_NUM_EXP);
+        setTransition(table, S_NUM_FRAC, {CC_F, CC_L}, S_NUM_SUFFIX);
+        setTransition(table, S_NUM_FRAC, kBadSuffix, S_NUM_SLOW);
+        setTransition(table, S_NUM_EXP, {CC_PLUS, CC_MINUS}, S_NUM_EXP_SIGN);
+        setTransition(table, S_NUM_EXP, kDigits, S_NUM_EXP_DIGITS);
+        setTransition(table, S_NUM_EXP_SIGN, kDigits, S_NUM_EXP_DIGITS);
+        setTransition(table, S_NUM_EXP_DIGITS, kDigits, S_NUM_EXP_DIGITS);
+        setTransition(table, S_NUM_EXP_DIGITS, {CC_F, CC_L}, S_NUM_SUFFIX);
+        setTransition(table, S_NUM_EXP_DIGITS, {CC_E}, S_NUM_SLOW);
+        setTransition(table, S_NUM_EXP_DIGITS, kBadSuffix, S_NUM_SLOW);
+        setTransition(table, S_NUM_SUFFIX, {CC_F, CC_L}, S_NUM_SUFFIX);
+        setTransition(table, S_NUM_SUFFIX, {CC_E}, S_NUM_SLOW);
+        setTransition(table, S_NUM_SUFFIX, kBadSuffix, S_NUM_SLOW);
+        // 十六进制：0x 之后至少一位，不识别后缀
+        setTransition(table, S_NUM_HEX_PREFIX, kHexDigits, S_NUM_HEX);
+        setTransition(table, S_NUM_HEX, kHexDigits, S_NUM_HEX);
+
+        // 字符串：只允许 \n 转义
+        for (auto &to : table[S_STRING])
+        {
+            to = S_STRING;
+        }
+        setTransition(table, S_STRING, {CC_QUOTE}, S_STRING_END);
+        setTransition(table, S_STRING, {CC_BACKSLASH}, S_STRING_ESCAPE);
+        setTransition(table, S_STRING_ESCAPE, {CC_N}, S_STRING);
+
+        // 运算符
+        setTransition(table, S_PLUS, {CC_PLUS}, S_INCREMENT);
+        setTransition(table, S_PLUS, {CC_EQUAL}, S_PLUS_ASSIGN);
+        setTransition(table, S_MINUS, {CC_MINUS}, S_DECREMENT);
+        setTransition(table, S_MINUS, {CC_EQUAL}, S_MINUS_ASSIGN);
+        setTransition(table, S_STAR, {CC_EQUAL}, S_STAR_ASSIGN);
+        setTransition(table, S_SLASH, {CC_EQUAL}, S_SLASH_ASSIGN);
+        setTransition(table, S_ASSIGN, {CC_EQUAL}, S_EQUAL);
+        setTransition(table, S_BANG, {CC_EQUAL}, S_NOT_EQUAL);
+        setTransition(table, S_LESS, {CC_EQUAL}, S_LESS_EQUAL);
+        setTransition(table, S_LESS, {CC_LESS}, S_LEFT_SHIFT);
+        setTransition(table, S_LEFT_SHIFT, {CC_EQUAL}, S_LEFT_SHIFT_ASSIGN);
+        setTransition(table, S_GREATER, {CC_EQUAL}, S_GREATER_EQUAL);
+        setTransition(table, S_GREATER, {CC_GREATER}, S_RIGHT_SHIFT);
+        setTransition(table, S_RIGHT_SHIFT, {CC_EQUAL}, S_RIGHT_SHIFT_ASSIGN);
+        setTransition(table, S_AMP, {CC_AMP}, S_LOGICAL_AND);
+        setTransition(table, S_AMP, {CC_EQUAL}, S_AMP_ASSIGN);
+        setTransition(table, S_PIPE, {CC_PIPE}, S_LOGICAL_OR);
+        setTransition(table, S_PIPE, {CC_EQUAL}, S_PIPE_ASSIGN);
+        return table;
+    }
+
+    constexpr TransitionTable kTransitions = buildTransitions();
+
+    constexpr std::array<StateInfo, kStateCount> buildStateInfo()
+    {
+        std::array<StateInfo, kStateCount> info{};
+        for (auto &entry : info)
+        {
+            entry = {Action::Emit, TokenType::UNKNOW};
+        }
+        info[S_IDENT] = {Action::Keyword, TokenType::IDENTIFIER};
+
+        info[S_NUM_ZERO] = {Action::Emit, TokenType::CONSTANT_INTEGER};
+        info[S_NUM_INT] = {Action::Emit, TokenType::CONSTANT_INTEGER};
+        info[S_NUM_HEX] = {Action::Emit, TokenType::CONSTANT_INTEGER};
+        info[S_NUM_FRAC] = {Action::Emit, TokenType::CONSTANT_FLOAT};
+        info[S_NUM_EXP_DIGITS] = {Action::Emit, TokenType::CONSTANT_FLOAT};
+        info[S_NUM_SUFFIX] = {Action::Emit, TokenType::CONSTANT_FLOAT};
+        for (State state : {S_NUM_DOT, S_NUM_EXP, S_NUM_EXP_SIGN, S_NUM_HEX_PREFIX, S_NUM_SLOW})
+        {
+            info[state] = {Action::Number, TokenType::ERROR};
+        }
+
+        info[S_STRING] = {Action::UnclosedString, TokenType::ERROR};
+        info[S_STRING_ESCAPE] = {Action::InvalidEscape, TokenType::ERROR};
+        info[S_STRING_END] = {Action::String, TokenType::CONSTANT_STRING};
 
-Token::Token(TokenType tokentype, std::string value, int line, int colume) : tokenType_(tokentype), value_(value), line_(line), colume_(colume) {}
+        info[S_PUNCT] = {Action::Punctuation, TokenType::UNKNOW};
+
+        info[S_PLUS] = {Action::Emit, TokenType::OPERATOR_PLUS};
+        info[S_INCREMENT] = {Action::Emit, TokenType::OPERATOR_INCREMENT};
+        info[S_PLUS_ASSIGN] = {Action::Emit, TokenType::OPERATOR_AND_ASSIGN}; // 沿用原运算符表的映射
+        info[S_MINUS] = {Action::Emit, TokenType::OPERATOR_MINUS};
+        info[S_DECREMENT] = {Action::Emit, TokenType::OPERATOR_DECREMENT};
+        info[S_MINUS_ASSIGN] = {Action::Emit, TokenType::OPERATOR_MINUS_ASSIGN};
+        info[S_STAR] = {Action::Emit, TokenType::OPERATOR_MULTIPLY};
+        info[S_STAR_ASSIGN] = {Action::Emit, TokenType::OPERATOR_MULTIPLY_ASSIGN};
+        info[S_SLASH] = {Action::Emit, TokenType::OPERATOR_DIVIDE};
+        info[S_SLASH_ASSIGN] = {Action::Emit, TokenType::OPERATOR_DIVIDE_ASSIGN};
+        info[S_ASSIGN] = {Action::Emit, TokenType::OPERATOR_ASSIGN};
+        info[S_EQUAL] = {Action::Emit, TokenType::OPERATOR_EQUAL};
+        info[S_BANG] = {Action::Emit, TokenType::OPERATOR_LOGICAL_NOT};
+        info[S_NOT_EQUAL] = {Action::Emit, TokenType::OPERATOR_NOT_EQUAL};
+        info[S_LESS] = {Action::Emit, TokenType::OPERATOR_LESS};
+        info[S_LESS_EQUAL] = {Action::Emit, TokenType::OPERATOR_LESS_EQUAL};
+        info[S_LEFT_SHIFT] = {Action::Emit, TokenType::OPERATOR_LEFT_SHIFT};
+        info[S_LEFT_SHIFT_ASSIGN] = {Action::Emit, TokenType::OPERATOR_LEFT_SHIFT_ASSIGN};
+        info[S_GREATER] = {Action::Emit, TokenType::OPERATOR_GREATER};
+        info[S_GREATER_EQUAL] = {Action::Emit, TokenType::OPERATOR_GREATER_EQUAL};
+        info[S_RIGHT_SHIFT] = {Action::Emit, TokenType::OPERATOR_RIGHT_SHIFT};
+        info[S_RIGHT_SHIFT_ASSIGN] = {Action::Emit, TokenType::OPERATOR_RIGHT_SHIFT_ASSIGN};
+        info[S_AMP] = {Action::Emit, TokenType::OPERATOR_BITWISE_AND};
+        info[S_LOGICAL_AND] = {Action::Emit, TokenType::OPERATOR_LOGICAL_AND};
+        info[S_AMP_ASSIGN] = {Action::Emit, TokenType::OPERATOR_AND_ASSIGN};
+        info[S_PIPE] = {Action::Emit, TokenType::OPERATOR_BITWISE_OR};
+        info[S_LOGICAL_OR] = {Action::Emit, TokenType::OPERATOR_LOGICAL_OR};
+        info[S_PIPE_ASSIGN] = {Action::Emit, TokenType::OPERATOR_OR_ASSIGN};
+        return info;
+    }
+
+    constexpr std::array<StateInfo, kStateCount> kStateInfo = buildStateInfo();
+}
+
+Token::Token() : tokenType_(TokenType::UNKNOW), value_("unknow"), offset_(0) {}
+
+Token::Token(TokenType tokentype, std::string_view value, uint32_t offset) : tokenType_(tokentype), value_(value), offset_(offset) {}
 
 std::string Token::tokenTypeToString(TokenType tokenType)
 {
@@ -207,144 +622,370 @@ std::string Token::tokenTypeToString(TokenType tokenType)
     }
 }
 
-Lexer::Lexer(std::string sourceCode) : sourceCode_(sourceCode), currentPosition_(0), currentLine_(1), currentColumn_(1) {}
+LineTable::LineTable(std::string_view source) : source_(source) {}
 
-void Lexer::tokenize()
+SourceLocation LineTable::locate(uint32_t offset) const
 {
-    Token token;
-    while (token.tokenType_ != TokenType::END_OF_FILE)
+    if (lineStarts_.empty())
     {
-        token = getNextToken();
-        tokens_.push_back(token);
+        lineStarts_.push_back(0);
+        for (size_t pos = CharScanner::findLineEnd(source_, 0); pos < source_.size();
+             pos = CharScanner::findLineEnd(source_, pos + 1))
+        {
+            lineStarts_.push_back(static_cast<uint32_t>(pos + 1));
+        }
     }
+    // 最后一个不大于 offset 的行首即为所在行
+    auto it = std::upper_bound(lineStarts_.begin(), lineStarts_.end(), offset) - 1;
+    return SourceLocation{static_cast<int>(it - lineStarts_.begin()) + 1, static_cast<int>(offset - *it) + 1};
 }
 
-std::vector<Token> Lexer::getTokens()
+TokenBuffer::TokenBuffer(std::string_view source) : source_(source) {}
+
+void TokenBuffer::push(const Token &token)
 {
-    return tokens_;
+    kinds_.push_back(static_cast<uint8_t>(token.tokenType_));
+    offsets_.push_back(token.offset_);
+    if (token.tokenType_ == TokenType::ERROR)
+    {
+        lengths_.push_back(static_cast<uint32_t>(messages_.size()));
+        messages_.push_back(token.value_);
+    }
+    else
+    {
+        lengths_.push_back(static_cast<uint32_t>(token.value_.size()));
+    }
+    symbols_.push_back(token.symbol_);
 }
 
-void Lexer::printTokens()
+void TokenBuffer::append(const TokenBuffer &other, size_t from)
 {
-    for (const auto &token : tokens_)
+    size_t first = size();
+    kinds_.insert(kinds_.end(), other.kinds_.begin() + from, other.kinds_.end());
+    offsets_.insert(offsets_.end(), other.offsets_.begin() + from, other.offsets_.end());
+    lengths_.insert(lengths_.end(), other.lengths_.begin() + from, other.lengths_.end());
+    symbols_.insert(symbols_.end(), other.symbols_.begin() + from, other.symbols_.end());
+    // 错误信息下标平移到本序列的 messages_ 中
+    uint32_t base = static_cast<uint32_t>(messages_.size());
+    messages_.insert(messages_.end(), other.messages_.begin(), other.messages_.end());
+    for (size_t i = first; i < size(); ++i)
     {
-        std::cout << token;
+        if (kind(i) == TokenType::ERROR)
+        {
+            lengths_[i] += base;
+        }
     }
 }
 
-Token Lexer::getNextToken()
+void TokenBuffer::setSymbol(size_t index, SymbolId symbol)
 {
+    symbols_[index] = symbol;
+}
 
-    // 跳过空白字符
-    skipWhitespaceOrComments();
+void TokenBuffer::reserve(size_t count)
+{
+    kinds_.reserve(count);
+    offsets_.reserve(count);
+    lengths_.reserve(count);
+    symbols_.reserve(count);
+}
 
-    // 是否结尾
-    if (currentPosition_ >= sourceCode_.length())
+size_t TokenBuffer::size() const
+{
+    return kinds_.size();
+}
+
+TokenType TokenBuffer::kind(size_t index) const
+{
+    return static_cast<TokenType>(kinds_[index]);
+}
+
+uint32_t TokenBuffer::offset(size_t index) const
+{
+    return offsets_[index];
+}
+
+std::string_view TokenBuffer::text(size_t index) const
+{
+    if (kind(index) == TokenType::ERROR)
     {
-        return Token(TokenType::END_OF_FILE, std::string(), currentLine_, currentColumn_);
+        return messages_[lengths_[index]];
     }
+    return source_.substr(offsets_[index], lengths_[index]);
+}
+
+SymbolId TokenBuffer::symbol(size_t index) const
+{
+    return symbols_[index];
+}
+
+Token TokenBuffer::operator[](size_t index) const
+{
+    Token token(kind(index), text(index), offsets_[index]);
+    token.symbol_ = symbols_[index];
+    return token;
+}
 
-    char c = peek(); // 读取当前指向字符
+Lexer::Lexer(std::string_view sourceCode, StringInterner &interner)
+    : sourceCode_(sourceCode), interner_(interner), currentPosition_(0), lines_(sourceCode), tokens_(sourceCode) {}
 
-    // 起始状态
-    // 进入识别标识符/关键字状态
-    if (isalpha(c) || c == '_')
+void Lexer::tokenize()
+{
+    Token token;
+    while (token.tokenType_ != TokenType::END_OF_FILE)
     {
-        return readIdentifierOrKeyword();
+        token = getNextToken();
+        tokens_.push(token);
     }
-    else if (c == '"')
+}
+
+// 并行扫描
+// getNextToken 的结果只取决于扫描起点，因此两次扫描只要从同一位置开始，之后的 token 就完全相同。
+// 每块从块首（某行开头）起推测扫描，块首可能落在字符串或块注释内部，推测结果未必正确；
+// 拼接时按顺序维护真实的扫描起点 pos：它出现在某块记录的起点中时，该块此后的 token 可直接接上；
+// 否则从 pos 顺序补扫，直到与该块的推测结果汇合或越过该块。
+// 行列号由偏移换算，偏移一致即与 tokenize() 一致；标识符在拼接时按源码顺序驻留，编号也一致。
+void Lexer::tokenizeParallel(ThreadPool &pool, size_t minChunkSize)
+{
+    size_t length = sourceCode_.length();
+    size_t chunkCount = std::min(pool.size(), length / std::max<size_t>(minChunkSize, 1));
+    if (chunkCount < 2)
     {
-        return readString();
+        tokenize();
+        return;
     }
-    else if (isdigit(c))
+
+    // 块边界取在均分点之后的第一个行首
+    std::vector<size_t> bounds{0};
+    for (size_t i = 1; i < chunkCount; ++i)
     {
-        return readNumber();
+        size_t bound = CharScanner::findLineEnd(sourceCode_, std::max(length / chunkCount * i, bounds.back())) + 1;
+        if (bound < length)
+        {
+            bounds.push_back(bound);
+        }
     }
-    else if (isOperator(peek()))
+    bounds.push_back(std::numeric_limits<size_t>::max()); // 最后一块扫描到文件结束
+
+    // 各块使用独立的 Lexer 与驻留表，互不共享可变状态
+    struct Chunk
     {
-        return readOperator();
+        StringInterner interner;
+        Lexer lexer;
+        std::vector<uint32_t> resume;
+        explicit Chunk(std::string_view source) : lexer(source, interner) {}
+    };
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    std::vector<std::future<void>> pending;
+    for (size_t i = 0; i + 1 < bounds.size(); ++i)
+    {
+        chunks.push_back(std::make_unique<Chunk>(sourceCode_));
+        Chunk *chunk = chunks.back().get();
+        chunk->lexer.currentPosition_ = bounds[i];
+        size_t end = bounds[i + 1];
+        pending.push_back(pool.submit([chunk, end] { chunk->lexer.tokenizeUntil(end, chunk->resume); }));
+    }
+    size_t total = 0;
+    for (size_t i = 0; i < pending.size(); ++i)
+    {
+        pending[i].get();
+        total += chunks[i]->lexer.tokens_.size();
     }
+    tokens_.reserve(total);
 
-    else if (isSymbol(sourceCode_[currentPosition_]))
+    std::vector<uint32_t> scratch;
+    bool finished = false;
+    for (size_t i = 0; i < chunks.size() && !finished; ++i)
     {
-        return readSymbol();
+        Chunk &chunk = *chunks[i];
+        const TokenBuffer &tokens = chunk.lexer.tokens_;
+        // 推测失败时顺序补扫，直到汇合或越过本块
+        auto it = std::lower_bound(chunk.resume.begin(), chunk.resume.end(), currentPosition_);
+        while (it == chunk.resume.end() || *it != currentPosition_)
+        {
+            if (currentPosition_ >= bounds[i + 1])
+            {
+                break;
+            }
+            tokenizeUntil(currentPosition_ + 1, scratch);
+            if (tokens_.kind(tokens_.size() - 1) == TokenType::END_OF_FILE)
+            {
+                finished = true;
+                break;
+            }
+            it = std::lower_bound(it, chunk.resume.end(), currentPosition_);
+        }
+        if (finished || it == chunk.resume.end() || *it != currentPosition_)
+        {
+            continue;
+        }
+
+        // 汇合：接上本块其余的 token，标识符按出现顺序改用本次编译的驻留表编号
+        size_t first = tokens_.size();
+        tokens_.append(tokens, it - chunk.resume.begin());
+        std::vector<SymbolId> symbolMap(chunk.interner.size(), kNoSymbol);
+        for (size_t index = first; index < tokens_.size(); ++index)
+        {
+            SymbolId local = tokens_.symbol(index);
+            if (local != kNoSymbol)
+            {
+                if (symbolMap[local] == kNoSymbol)
+                {
+                    symbolMap[local] = interner_.intern(chunk.interner.spelling(local));
+                }
+                tokens_.setSymbol(index, symbolMap[local]);
+            }
+        }
+        currentPosition_ = chunk.lexer.currentPosition_;
+        finished = tokens.size() > 0 && tokens.kind(tokens.size() - 1) == TokenType::END_OF_FILE;
+        // 错误 token 可能引用块内动态生成的错误信息，转移到本 Lexer 名下（splice 不移动元素）
+        messages_.splice(messages_.end(), chunk.lexer.messages_);
     }
-    else
+    // 最后一块总会扫描到文件结束，这里只是兜底
+    if (!finished)
     {
-        Token error(TokenType::UNKNOW, std::string(1, c), currentLine_, currentColumn_);
-        advance();
-        return error;
+        tokenizeUntil(std::numeric_limits<size_t>::max(), scratch);
     }
 }
 
-// 默认读取当前指向字符
-char Lexer::peek(size_t ahead) const
+void Lexer::tokenizeUntil(size_t end, std::vector<uint32_t> &resume)
 {
-    size_t pos = currentPosition_ + ahead;
-    return pos < sourceCode_.length() ? sourceCode_[pos] : '\0';
+    while (currentPosition_ < end)
+    {
+        uint32_t start = static_cast<uint32_t>(currentPosition_);
+        Token token = getNextToken();
+        tokens_.push(token);
+        // 未闭合的块注释会在 EOF 之前额外压入一个错误 token，两者共用同一起点
+        resume.resize(tokens_.size(), start);
+        if (token.tokenType_ == TokenType::END_OF_FILE)
+        {
+            break;
+        }
+    }
 }
 
-// 读取当前pos指向位置字符，并后移一位
-char Lexer::advance()
+const TokenBuffer &Lexer::getTokens() const
 {
-    if (currentPosition_ >= sourceCode_.length())
-        return '\0';
+    return tokens_;
+}
 
-    char c = sourceCode_[currentPosition_++];
-    if (c == '\n')
-    {
-        currentLine_++;
-        currentColumn_ = 1;
-    }
-    else
+SourceLocation Lexer::location(uint32_t offset) const
+{
+    return lines_.locate(offset);
+}
+
+void Lexer::printTokens()
+{
+    std::cout << std::left;
+    for (size_t i = 0; i < tokens_.size(); ++i)
     {
-        currentColumn_++;
+        SourceLocation loc = location(tokens_.offset(i));
+        std::cout << std::setw(30) << Token::tokenTypeToString(tokens_.kind(i)) << std::setw(10) << tokens_.text(i)
+                  << std::setw(10) << loc.line << std::setw(10) << loc.column << std::endl;
     }
-    return c;
 }
 
-Token Lexer::readIdentifierOrKeyword()
+Token Lexer::getNextToken()
 {
-    int startLine = currentLine_;
-    int startColumn = currentColumn_;
 
-    std::string identifier;
-    while (std::isalnum(peek()) || peek() == '_')
+    // 跳过空白字符
+    skipWhitespaceOrComments();
+
+    // 是否结尾
+    if (currentPosition_ >= sourceCode_.length())
+    {
+        return Token(TokenType::END_OF_FILE, std::string_view(), static_cast<uint32_t>(currentPosition_));
+    }
+
+    // 按字符类别查表转移，直到没有可用转移或输入结束
+    size_t start = currentPosition_;
+    size_t pos = start;
+    size_t length = sourceCode_.length();
+    uint8_t state = S_START;
+    while (pos < length)
     {
-        identifier += advance();
+        uint8_t next = kTransitions[state][kCharClasses[static_cast<unsigned char>(sourceCode_[pos])]];
+        if (next == S_DEAD)
+        {
+            break;
+        }
+        state = next;
+        ++pos;
     }
 
-    if (keywords_.find(identifier) != keywords_.end())
+    const StateInfo &info = kStateInfo[state];
+    std::string_view text = sourceCode_.substr(start, pos - start);
+    uint32_t offset = static_cast<uint32_t>(start);
+    switch (info.action)
     {
-        return Token(keywords_[identifier], identifier, startLine, startColumn);
+    case Action::Keyword:
+        currentPosition_ = pos;
+        {
+            Token token(classifyKeyword(text), text, offset);
+            if (token.tokenType_ == TokenType::IDENTIFIER)
+            {
+                token.symbol_ = interner_.intern(text);
+            }
+            return token;
+        }
+    case Action::Punctuation:
+        currentPosition_ = pos;
+        return Token(classifyPunctuation(text[0]), text, offset);
+    case Action::String:
+        currentPosition_ = pos;
+        return Token(TokenType::CONSTANT_STRING, text, offset);
+    case Action::InvalidEscape:
+        currentPosition_ = pos - 1;
+        return Token(TokenType::ERROR, "Invalid escape sequence", offset);
+    case Action::UnclosedString:
+        currentPosition_ = pos;
+        return Token(TokenType::ERROR, "Unclosed string", offset);
+    case Action::Number:
+        return readNumber();
+    default:
+        currentPosition_ = pos;
+        return Token(info.type, text, offset);
     }
-    return Token(TokenType::IDENTIFIER, identifier, startLine, startColumn);
+}
+
+// 默认读取当前指向字符
+char Lexer::peek(size_t ahead) const
+{
+    size_t pos = currentPosition_ + ahead;
+    return pos < sourceCode_.length() ? sourceCode_[pos] : '\0';
+}
+
+// 读取当前pos指向位置字符，并后移一位
+char Lexer::advance()
+{
+    if (currentPosition_ >= sourceCode_.length())
+        return '\0';
+
+    return sourceCode_[currentPosition_++];
 }
 
 Token Lexer::readNumber()
 {
-    int startLine = currentLine_;
-    int startColumn = currentColumn_;
-    std::string num;
+    size_t start = currentPosition_;
+    uint32_t offset = static_cast<uint32_t>(start);
     bool isFloat = false;
     bool isHex = false;
     bool isScientific = false;
     bool error = false;
     std::string errorMsg;
-    TokenType type;
 
     // 数字类型检测
     if (peek() == '0' && (peek(1) == 'x' || peek(1) == 'X'))
     {
         // 十六进制处理
-        num += advance();
-        num += advance();
+        advance();
+        advance();
         isHex = true;
 
         bool hasDigits = false;
         while (isxdigit(peek()))
         {
-            num += advance();
+            advance();
             hasDigits = true;
         }
 
@@ -367,7 +1008,7 @@ Token Lexer::readNumber()
                     errorMsg = "Multiple decimal points in number";
                 }
                 isFloat = true;
-                num += advance();
+                advance();
 
                 // 小数点后必须有数字
                 if (!std::isdigit(peek()))
@@ -378,7 +1019,7 @@ Token Lexer::readNumber()
             }
             else
             {
-                num += advance();
+                advance();
             }
         }
 
@@ -388,19 +1029,19 @@ Token Lexer::readNumber()
             isScientific = true;
             isFloat = true;
             ;
-            num += advance(); // e/E
+            advance(); // e/E
 
             // 处理符号
             if (peek() == '+' || peek() == '-')
             {
-                num += advance();
+                advance();
             }
 
             // 指数部分必须有数字
             bool hasExponentDigits = false;
             while (std::isdigit(peek()))
             {
-                num += advance();
+                advance();
                 hasExponentDigits = true;
             }
 
@@ -418,7 +1059,6 @@ Token Lexer::readNumber()
         while (std::isalpha(peek()))
         {
             char c = advance();
-            num += c;
             if (c == 'f' || c == 'F' || c == 'l' || c == 'L')
             {
                 isFloat = true;
@@ -437,166 +1077,111 @@ Token Lexer::readNumber()
         // 读取到非法字符时继续前进知道数字结束
         while (std::isalnum(peek()) || peek() == '.')
         {
-            num += advance();
+            advance();
         }
-        return Token(TokenType::ERROR, errorMsg, startLine, startColumn);
+        messages_.push_back(errorMsg);
+        return Token(TokenType::ERROR, messages_.back(), offset);
     }
 
+    std::string_view num = sourceCode_.substr(start, currentPosition_ - start);
+
     // 验证数字格式
     if (isHex && isFloat)
     {
-        return Token(TokenType::ERROR, "Hexadecimal cannot have decimal point,startLine,startColumn", startLine, startColumn);
+        return Token(TokenType::ERROR, "Hexadecimal cannot have decimal point,startLine,startColumn", offset);
     }
-    if (num.find('.') != std::string::npos && !isFloat)
+    if (num.find('.') != std::string_view::npos && !isFloat)
     {
-        return Token(TokenType::ERROR, "Invalid number format", startLine, startColumn);
-    }
-
-    return Token{isFloat ? TokenType::CONSTANT_FLOAT : TokenType::CONSTANT_INTEGER, num, startLine, startColumn};
-}
-
-Token Lexer::readString()
-{
-    int startLine = currentLine_;
-    int startColumn = currentColumn_;
-
-    std::string value;
-    value += peek();
-    advance();
-    while (peek() != '"' && currentPosition_ <= sourceCode_.length())
-    {
-        if (peek() == '\\')
-        { // 处理转义
-            // advance();
-            //  只允许\n转义
-            if (peek(1) != 'n')
-            {
-                return Token(TokenType::ERROR, "Invalid escape sequence", startLine, startColumn);
-            }
-            value += '\\';
-            advance(); // 跳过
-        }
-        value += peek();
-        advance();
-    }
-
-    if (currentPosition_ >= sourceCode_.length())
-        return Token(TokenType::ERROR, "Unclosed string", startLine, startColumn);
-    value += peek();
-    advance(); // 跳过闭合的"
-    return Token(TokenType::CONSTANT_STRING, value, startLine, startColumn);
-}
-
-Token Lexer::readOperator()
-{
-    int startLine = currentLine_;
-    int startColumn = currentColumn_;
-
-    std::string operatorString;
-    std::string first(1, peek());
-
-    // 处理三字运算符
-    std::string third(first);
-    third += peek(1);
-    third += peek(2);
-    if (operators_.find(third) != operators_.end())
-    {
-        advance();
-        advance();
-        advance();
-        return Token(operators_[third], third, startLine, startColumn);
-    }
-
-    // 处理双字符运算符
-    std::string second(first);
-    second += peek(1);
-    if (operators_.find(second) != operators_.end())
-    {
-        advance();
-        advance();
-        return Token(operators_[second], second, startLine, startColumn);
-    }
-
-    // 处理单字符运算符
-    if (operators_.find(first) != operators_.end())
-    {
-        advance();
-        return Token(operators_[first], first, startLine, startColumn);
+        return Token(TokenType::ERROR, "Invalid number format", offset);
     }
 
-    return Token(TokenType::UNKNOW, first, startLine, startColumn);
-}
-
-Token Lexer::readSymbol()
-{
-    int startLine = currentLine_;
-    int startColumn = currentColumn_;
-
-    std::string symbol;
-    symbol = sourceCode_[currentPosition_++];
-
-    return Token(punctuations_[symbol], symbol, startLine, startColumn);
+    return Token{isFloat ? TokenType::CONSTANT_FLOAT : TokenType::CONSTANT_INTEGER, num, offset};
 }
 
 void Lexer::skipWhitespaceOrComments()
 {
-    while (true)
+    // 空白与注释按块扫描（见 charScanner）；行列号按需由偏移换算，扫描时不统计
+    size_t pos = currentPosition_;
+    size_t length = sourceCode_.length();
+    bool unclosedComment = false;
+
+    while (pos < length)
     {
-        char c = peek();
-        if (c == '/')
+        char c = sourceCode_[pos];
+        char next = pos + 1 < length ? sourceCode_[pos + 1] : '\0';
+        if (c == '/' && next == '/')
         {
-            if (peek(1) == '/')
-            {
-                while (peek() != '\n')
-                    advance();
-            }
-            else if (peek(1) == '*')
-            {
-                advance();
-                advance();
-
-                while (!(peek() == '*' && peek(1) == '/'))
-                {
-                    advance();
-                }
-                if (peek() == '\0')
-                { // 文件结束
-                    tokens_.push_back(Token(TokenType::ERROR, "Unclosed comment", currentLine_, currentColumn_));
-                    return;
-                }
-                advance();
-                advance();
-            }
+            // 行注释：停在换行符处，换行由空白扫描跳过
+            pos = CharScanner::findLineEnd(sourceCode_, pos + 2);
         }
-        else if (isspace(peek()))
+        else if (c == '/' && next == '*')
         {
-            while (std::isspace(peek()))
-            {
-                advance();
+            pos = CharScanner::findCommentEnd(sourceCode_, pos + 2);
+            if (pos >= length)
+            { // 文件结束
+                unclosedComment = true;
+                break;
             }
+            pos += 2;
+        }
+        else if (isspace(static_cast<unsigned char>(c)))
+        {
+            pos = CharScanner::skipWhitespace(sourceCode_, pos);
         }
         else
         {
             break;
         }
     }
-}
 
-bool Lexer::isOperator(char c)
-{
-    static const std::string operators = "+-*/=<>!&|?:";
-    return operators.find(c) != std::string::npos;
+    currentPosition_ = pos;
+
+    if (unclosedComment)
+    {
+        tokens_.push(Token(TokenType::ERROR, "Unclosed comment", static_cast<uint32_t>(pos)));
+    }
 }
 
-bool Lexer::isSymbol(char c)
+TokenType Lexer::classifyKeyword(std::string_view word)
 {
-    static const std::string symbols = "{}();,[]";
-    return symbols.find(c) != std::string::npos;
+    // 所有关键字长度都在 [2, 8] 之间，其余长度无需查表
+    if (word.size() < 2 || word.size() > 8)
+    {
+        return TokenType::IDENTIFIER;
+    }
+    uint8_t slot = kKeywordTable[keywordHash(word)];
+    if (slot != 0 && kKeywords[slot - 1].spelling == word)
+    {
+        return kKeywords[slot - 1].type;
+    }
+    return TokenType::IDENTIFIER;
 }
 
-std::ostream &operator<<(std::ostream &os, const Token &token)
+TokenType Lexer::classifyPunctuation(char c)
 {
-    os << std::left;
-    os << std::setw(30) << Token::tokenTypeToString(token.tokenType_) << std::setw(10) << token.value_ << std::setw(10) << token.line_ << std::setw(10) << token.colume_ << std::endl;
-    return os;
+    switch (c)
+    {
+    case '(':
+        return TokenType::PUNCTUATION_LEFT_PAREN;
+    case ')':
+        return TokenType::PUNCTUATION_RIGHT_PAREN;
+    case '{':
+        return TokenType::PUNCTUATION_LEFT_BRACE;
+    case '}':
+        return TokenType::PUNCTUATION_RIGHT_BRACE;
+    case '[':
+        return TokenType::PUNCTUATION_LEFT_BRACKET;
+    case ']':
+        return TokenType::PUNCTUATION_RIGHT_BRACKET;
+    case ',':
+        return TokenType::PUNCTUATION_COMMA;
+    case ';':
+        return TokenType::PUNCTUATION_SEMICOLON;
+    case ':':
+        return TokenType::PUNCTUATION_COLON;
+    case '.':
+        return TokenType::PUNCTUATION_DOT;
+    default:
+        return TokenType::UNKNOW;
+    }
 }
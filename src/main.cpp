@@ -1,64 +1,316 @@
 #include "lexer.h"
 #include "parser.h"
-#include "symbolTable.h"
 #include "SemanticAnalyzer.h"
 #include "codeGenerator.h"
+#include "threadPool.h"
+#include "tokenCache.h"
+#include "astCache.h"
+#include "functionPrototype.h"
+#include "moduleLinker.h"
 #include <iostream>
-#include <fstream>
+#include <iterator>
+#include "llvm/Support/MemoryBuffer.h"
 
-std::string getFile(std::string filePath);
+std::unique_ptr<llvm::MemoryBuffer> getFile(const std::string &filePath);
+
+namespace
+{
+    struct Options
+    {
+        bool dumpTokens = false;
+        size_t jobs = 1;
+        std::string tokenCacheDir;
+        bool verifyTokenCache = false;
+        std::string astCacheDir;
+    };
+
+    // 一个编译单元（源文件）：token 引用 buffer，语法树节点分配在 arena 中，标识符驻留在 interner 中，
+    // 三者需存活至该单元编译结束；errors 中的错误描述引用其中的名字，须在此之前输出
+    struct Unit
+    {
+        std::string path;
+        std::unique_ptr<llvm::MemoryBuffer> buffer;
+        StringInterner interner;
+        ErrorManager errors;
+        AST::AstArena arena;
+        AST::CompUnit *program = nullptr;
+        std::string bitcode; // 多文件编译时本单元生成的模块
+        bool ok = true;
+    };
+
+    // 词法分析 + 语法分析（或读取缓存）；失败时输出原因并返回 false
+    // pool 非空时大文件的词法分析分块并行，顶层函数定义并行解析
+    bool parseUnit(Unit &unit, const Options &options, ThreadPool *pool)
+    {
+        unit.buffer = getFile(unit.path);
+        if (!unit.buffer)
+        {
+            return false;
+        }
+        std::string_view sourceCode = unit.buffer->getBuffer();
+
+        // 词法分析 + 语法分析（token 直接引用 buffer）
+        Lexer lexer(sourceCode, unit.interner);
+        AstCache astCache(options.astCacheDir);
+        if (!options.astCacheDir.empty() && !options.dumpTokens)
+        {
+            unit.program = astCache.load(sourceCode, unit.arena, unit.interner);
+            if (unit.program)
+            {
+                return true;
+            }
+        }
+
+        if (options.dumpTokens || pool || !options.tokenCacheDir.empty())
+        {
+            // 物化完整 token 序列：优先读缓存，否则扫描（可并行）并写回缓存
+            TokenCache cache(options.tokenCacheDir);
+            bool cached = !options.tokenCacheDir.empty() && cache.load(lexer);
+            if (cached && options.verifyTokenCache)
+            {
+                Lexer fresh(sourceCode, unit.interner);
+                fresh.tokenize();
+                size_t index = TokenCache::firstDifference(lexer.getTokens(), fresh.getTokens());
+                if (index != TokenCache::kSame)
+                {
+                    std::cerr << "token 缓存与重新扫描的结果不一致（第 " << index << " 个 token）: "
+                              << cache.pathFor(sourceCode) << std::endl;
+                    return false;
+                }
+            }
+            if (!cached)
+            {
+                if (pool)
+                {
+                    lexer.tokenizeParallel(*pool);
+                }
+                else
+                {
+                    lexer.tokenize();
+                }
+                if (!options.tokenCacheDir.empty() && !cache.store(lexer))
+                {
+                    std::cerr << "无法写入 token 缓存: " << cache.pathFor(sourceCode) << std::endl;
+                }
+            }
+            if (options.dumpTokens)
+            {
+                lexer.printTokens();
+            }
+            Parser parser(lexer.getTokens(), unit.arena);
+            unit.program = parser.parseCompUnit(pool);
+        }
+        else
+        {
+            Parser parser(lexer, unit.arena);
+            unit.program = parser.parseCompUnit();
+        }
+        if (!options.astCacheDir.empty() && !astCache.store(sourceCode, *unit.program, unit.interner))
+        {
+            std::cerr << "无法写入语法树缓存: " << astCache.pathFor(sourceCode) << std::endl;
+        }
+        return true;
+    }
+
+    // 对每个编译单元执行 task：pool 非空时每个单元一个任务并等待全部完成，否则依次执行
+    template <typename F>
+    void forEachUnit(std::vector<std::unique_ptr<Unit>> &units, ThreadPool *pool, F task)
+    {
+        if (!pool)
+        {
+            for (size_t i = 0; i < units.size(); ++i)
+            {
+                task(i, *units[i]);
+            }
+            return;
+        }
+        std::vector<std::future<void>> done;
+        for (size_t i = 0; i < units.size(); ++i)
+        {
+            done.push_back(pool->submit([&task, &units, i]
+                                        { task(i, *units[i]); }));
+        }
+        for (auto &future : done)
+        {
+            future.get();
+        }
+    }
+
+    // 多文件编译：
+    //   1. 各单元并行做词法分析与语法分析；
+    //   2. 收集各单元定义的函数原型；
+    //   3. 各单元并行做语义分析与代码生成，其他单元的函数按原型声明，模块写成位码；
+    //   4. 在主线程的上下文中读回各单元的模块并链接成一个模块后输出。
+    // 单元之间只通过原型与位码交互，每个单元的驻留表、语法树和 LLVMContext 都只在一个线程中使用。
+    // 单元内部不再并行，以免线程池任务等待同一线程池中的任务
+    bool compileUnits(std::vector<std::unique_ptr<Unit>> &units, const Options &options, ThreadPool *pool)
+    {
+        // --dump-tokens 按单元顺序输出，不并行
+        forEachUnit(units, options.dumpTokens ? nullptr : pool, [&options](size_t, Unit &unit)
+                    { unit.ok = parseUnit(unit, options, nullptr); });
+        for (auto &unit : units)
+        {
+            if (!unit->ok)
+            {
+                return false;
+            }
+        }
+
+        // 全部原型依单元顺序排列，unitBegin[i] 起为第 i 个单元的原型
+        std::vector<FunctionPrototype> prototypes;
+        std::vector<size_t> unitBegin;
+        for (auto &unit : units)
+        {
+            unitBegin.push_back(prototypes.size());
+            std::vector<FunctionPrototype> own = collectPrototypes(*unit->program);
+            std::move(own.begin(), own.end(), std::back_inserter(prototypes));
+        }
+        unitBegin.push_back(prototypes.size());
+
+        forEachUnit(units, pool, [&](size_t i, Unit &unit)
+                    {
+                        // 声明除本单元之外的全部函数
+                        llvm::ArrayRef<FunctionPrototype> all(prototypes);
+                        llvm::ArrayRef<FunctionPrototype> before = all.take_front(unitBegin[i]);
+                        llvm::ArrayRef<FunctionPrototype> after = all.drop_front(unitBegin[i + 1]);
+
+                        SemanticAnalyzer sema(unit.interner, unit.errors);
+                        sema.declareFunctions(before);
+                        sema.declareFunctions(after);
+                        sema.visitNode(*unit.program);
+
+                        CodeGenerator codeGen;
+                        codeGen.visitNode(*unit.program);
+                        std::unique_ptr<llvm::Module> module = codeGen.getModule();
+                        // 位码只能表示合法的模块，验证失败的单元无法交给链接
+                        if (llvm::verifyModule(*module, &llvm::errs()))
+                        {
+                            llvm::errs() << unit.path << ": 生成的模块验证失败\n";
+                            unit.ok = false;
+                            return;
+                        }
+                        unit.bitcode = ModuleLinker::serialize(*module); });
+        for (auto &unit : units)
+        {
+            if (!unit->ok)
+            {
+                return false;
+            }
+        }
+
+        llvm::LLVMContext context;
+        ModuleLinker linker(context);
+        for (auto &unit : units)
+        {
+            if (!linker.add(unit->bitcode, unit->path))
+            {
+                return false;
+            }
+        }
+        std::unique_ptr<llvm::Module> module = linker.take();
+        CodeGenerator::emitIRToFile(*module, "output.ll");
+        CodeGenerator::emitMIPSAssembly(*module, "output.s");
+        return true;
+    }
+}
 
 int main(int argc, char *argv[])
 {
-    // 检查命令行参数数量，确保至少有一个文件名参数
-    if (argc < 2)
+    // 解析命令行：非选项参数为源文件，可以有多个
+    // --dump-tokens  先物化完整 token 序列并输出，再由 Parser 回放；默认流式解析
+    // --jobs=N       使用 N 个线程（0 表示按硬件并发数）；单个源文件时大文件的词法分析分块并行，之后回放解析，
+    //                顶层函数定义并行解析，函数体的语义检查并行；多个源文件时各文件的编译并行，见 compileUnits
+    // --token-cache=DIR    在 DIR 中按源码哈希缓存 token 序列，命中时跳过词法分析
+    // --verify-token-cache 命中缓存后仍重新扫描一遍并与缓存比较，不一致时报错退出
+    // --ast-cache=DIR      在 DIR 中按源码哈希缓存语法树，命中时跳过词法分析与语法分析（--dump-tokens 时不读取）
+    Options options;
+    std::vector<std::unique_ptr<Unit>> units;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--dump-tokens")
+        {
+            options.dumpTokens = true;
+        }
+        else if (arg.rfind("--jobs=", 0) == 0)
+        {
+            options.jobs = std::strtoul(arg.c_str() + 7, nullptr, 10);
+        }
+        else if (arg.rfind("--token-cache=", 0) == 0)
+        {
+            options.tokenCacheDir = arg.substr(14);
+        }
+        else if (arg == "--verify-token-cache")
+        {
+            options.verifyTokenCache = true;
+        }
+        else if (arg.rfind("--ast-cache=", 0) == 0)
+        {
+            options.astCacheDir = arg.substr(12);
+        }
+        else
+        {
+            units.push_back(std::make_unique<Unit>());
+            units.back()->path = arg;
+        }
+    }
+
+    // 确保至少有一个文件名参数
+    if (units.empty())
     {
         std::cerr << "请提供文件名作为命令行参数。" << std::endl;
         return 1;
     }
 
-    // 获取文件名并转换为 std::string 类型
-    std::string filePath = argv[1];
-    std::string sourceCode = getFile(filePath);
+    std::unique_ptr<ThreadPool> pool;
+    if (options.jobs != 1)
+    {
+        pool = std::make_unique<ThreadPool>(options.jobs);
+    }
 
-    // 初始化符号表和错误管理器
-    SymbolTable symbolTable;
-    ErrorManager &errorManager = ErrorManager::getInstance();
-    // 词法分析
-    Lexer lexer(sourceCode);
-    lexer.tokenize();
-    lexer.printTokens();
-    std::vector<Token> tokenVector = lexer.getTokens();
+    if (units.size() > 1)
+    {
+        bool ok = compileUnits(units, options, pool.get());
+        // 各单元的错误按命令行顺序输出
+        for (auto &unit : units)
+        {
+            unit->errors.reportErrors();
+        }
+        return ok ? 0 : 1;
+    }
 
-    // 语法分析
-    Parser parser(tokenVector, symbolTable);
-    std::unique_ptr<AST::CompUnit> program = parser.parseCompUnit();
+    Unit &unit = *units.front();
+    if (!parseUnit(unit, options, pool.get()))
+    {
+        return 1;
+    }
 
-    // 语义分析
-    SemanticAnalyzer sema;
-    program->accept(sema);
+    // 语义分析（有线程池时函数体并行检查）
+    SemanticAnalyzer sema(unit.interner, unit.errors);
+    sema.analyze(*unit.program, pool.get());
 
     CodeGenerator codeGen;
-    program->accept(codeGen);
+    codeGen.visitNode(*unit.program);
     codeGen.emitIRToFile("output.ll");
     codeGen.emitMIPSAssembly("output.s");
 
     // 输出错误信息
-    errorManager.reportErrors();
+    unit.errors.reportErrors();
 
     return 0;
 }
 
 // 从文件中读取源代码
-std::string getFile(std::string filePath)
+// 普通文件由 MemoryBuffer 直接 mmap 映射，词法分析器原地扫描，不再拷贝；
+// 路径为 "-" 时读取标准输入，标准输入与管道退化为一次性缓冲读取
+std::unique_ptr<llvm::MemoryBuffer> getFile(const std::string &filePath)
 {
-    std::ifstream file(filePath);
-    if (!file.is_open())
+    llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> buffer =
+        llvm::MemoryBuffer::getFileOrSTDIN(filePath, /*IsText=*/false, /*RequiresNullTerminator=*/false);
+    if (!buffer)
     {
-        std::cerr << "无法打开文件: " << filePath << std::endl;
+        std::cerr << "无法打开文件: " << filePath << "（" << buffer.getError().message() << "）" << std::endl;
+        return nullptr;
     }
-    // 使用迭代器读取文件内容
-    std::string sourceCode((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-    file.close();
-    return sourceCode;
-}
\ No newline at end of file
+    return std::move(*buffer);
+}
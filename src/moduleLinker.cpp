@@ -0,0 +1,61 @@
+#include "moduleLinker.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/IR/DiagnosticInfo.h"
+#include "llvm/IR/DiagnosticPrinter.h"
+#include "llvm/Linker/Linker.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+ModuleLinker::ModuleLinker(llvm::LLVMContext &context) : context_(context)
+{
+    // 默认的诊断处理在报告错误后直接退出进程；这里只输出，由 add 返回失败
+    context_.setDiagnosticHandlerCallBack(
+        [](const llvm::DiagnosticInfo &info, void *)
+        {
+            if (info.getSeverity() != llvm::DS_Error && info.getSeverity() != llvm::DS_Warning)
+            {
+                return;
+            }
+            llvm::DiagnosticPrinterRawOStream printer(llvm::errs());
+            info.print(printer);
+            llvm::errs() << "\n";
+        });
+}
+
+std::string ModuleLinker::serialize(const llvm::Module &module)
+{
+    std::string bitcode;
+    llvm::raw_string_ostream os(bitcode);
+    llvm::WriteBitcodeToFile(module, os);
+    os.flush();
+    return bitcode;
+}
+
+bool ModuleLinker::add(llvm::StringRef bitcode, llvm::StringRef name)
+{
+    llvm::Expected<std::unique_ptr<llvm::Module>> module =
+        llvm::parseBitcodeFile(llvm::MemoryBufferRef(bitcode, name), context_);
+    if (!module)
+    {
+        llvm::errs() << name << ": " << llvm::toString(module.takeError()) << "\n";
+        return false;
+    }
+    if (!merged_)
+    {
+        merged_ = std::move(*module);
+        return true;
+    }
+
+    llvm::Function *getint = (*module)->getFunction("getint");
+    if (getint && !getint->isDeclaration() && merged_->getFunction("getint"))
+    {
+        getint->deleteBody();
+    }
+    if (llvm::Linker::linkModules(*merged_, std::move(*module)))
+    {
+        llvm::errs() << name << ": 链接失败\n";
+        return false;
+    }
+    return true;
+}
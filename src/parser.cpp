@@ -1,32 +1,57 @@
 #include "parser.h"
+#include "threadPool.h"
+#include <algorithm>
+#include <future>
 
-Parser::Parser(std::vector<Token> &tokens, SymbolTable &symbolTable) : tokens_(tokens), current_(0), token_(tokens[0]), symbolTable_(symbolTable)
+Parser::Parser(const TokenBuffer &tokens, AstArena &arena)
+    : arena_(arena), buffer_(&tokens), tokens_(tokens)
 {
 }
 
-std::unique_ptr<CompUnit> Parser::parseCompUnit()
+Parser::Parser(Lexer &lexer, AstArena &arena)
+    : arena_(arena), buffer_(nullptr), tokens_(lexer)
 {
-    std::unique_ptr<CompUnit> compUnit = std::make_unique<CompUnit>();
+}
+
+Parser::Parser(const TokenBuffer &tokens, size_t begin, size_t end, AstArena &arena)
+    : arena_(arena), buffer_(&tokens), tokens_(tokens, begin, end)
+{
+}
+
+CompUnit *Parser::parseCompUnit(ThreadPool *pool)
+{
+    CompUnit *compUnit = arena_.make<CompUnit>();
 
     // 解析全局声明{Decl}
+    llvm::SmallVector<Decl *, 16> decls;
     while (check(TokenType::KEYWORD_CONST) || (check(TokenType::KEYWORD_INT) && peek(2).tokenType_ != TokenType::PUNCTUATION_LEFT_PAREN))
     {
-        compUnit->decls_.push_back(parseDecl());
+        decls.push_back(parseDecl());
     }
+    compUnit->decls_ = arena_.copy(decls);
 
     // 解析函数定义{FuncDef}
-    while ((check(TokenType::KEYWORD_INT) || check(TokenType::KEYWORD_VOID)) && (peek(2).tokenType_ == TokenType::PUNCTUATION_LEFT_PAREN) && (peek(1).tokenType_ == TokenType::IDENTIFIER))
+    llvm::SmallVector<FuncDef *, 16> funcDefs;
+    if (pool && buffer_)
+    {
+        parseFuncDefsParallel(*pool, funcDefs);
+    }
+    while (isFuncDefStart())
     {
-        compUnit->funcDefs_.push_back(parseFuncDef());
+        funcDefs.push_back(parseFuncDef());
     }
+    compUnit->funcDefs_ = arena_.copy(funcDefs);
 
-    // 解析主函数
-    compUnit->mainfuncDef_ = parseMainFuncDef();
+    // 解析主函数；多文件编译时只有一个编译单元定义 main，其余单元在函数定义后即结束
+    if (!isAtEnd())
+    {
+        compUnit->mainfuncDef_ = parseMainFuncDef();
+    }
 
     return compUnit;
 }
 
-std::unique_ptr<Decl> Parser::parseDecl()
+Decl *Parser::parseDecl()
 {
     if (check(TokenType::KEYWORD_CONST))
     { // 判断是否为常量声明
@@ -38,38 +63,43 @@ std::unique_ptr<Decl> Parser::parseDecl()
     }
 }
 
-std::unique_ptr<ConstDecl> Parser::parseConstDecl()
+ConstDecl *Parser::parseConstDecl()
 {
-    auto const_decl = std::make_unique<ConstDecl>();
+    auto const_decl = arena_.make<ConstDecl>();
 
     advance(); // consume "const"
     // 解析BType（目前只有int）
     const_decl->bType_ = parseBType();
 
     // 解析多个ConstDef，逗号分隔
+    llvm::SmallVector<ConstDef *, 4> constDefs;
     do
     {
         auto const_def = parseConstDef();
 
-        const_decl->constDefs_.push_back(std::move(const_def));
+        constDefs.push_back(const_def);
     } while (match(TokenType::PUNCTUATION_COMMA));
+    const_decl->constDefs_ = arena_.copy(constDefs);
 
     advance(); // consume ";"
 
     return const_decl;
 }
 
-std::unique_ptr<ConstDef> Parser::parseConstDef()
+ConstDef *Parser::parseConstDef()
 {
-    auto const_def = std::make_unique<ConstDef>();
+    auto const_def = arena_.make<ConstDef>();
+    const_def->nameId_ = current().symbol_;
     const_def->name_ = advance().value_;
 
     // 解析数组维度 [ConstExp]
+    llvm::SmallVector<Exp *, 4> dimensions;
     while (match(TokenType::PUNCTUATION_LEFT_BRACKET))
     {
-        const_def->dimensions_.push_back(parseConstExp());
+        dimensions.push_back(parseConstExp());
         advance();
     }
+    const_def->dimensions_ = arena_.copy(dimensions);
 
     // 解析初始化值
     advance();
@@ -81,37 +111,42 @@ std::unique_ptr<ConstDef> Parser::parseConstDef()
     return const_def;
 }
 
-std::unique_ptr<VarDecl> Parser::parseVarDecl()
+VarDecl *Parser::parseVarDecl()
 {
-    auto var_decl = std::make_unique<VarDecl>();
+    auto var_decl = arena_.make<VarDecl>();
     var_decl->bType_ = parseBType();
 
     // 解析多个VarDef，逗号分隔
+    llvm::SmallVector<VarDef *, 4> varDefs;
     do
     {
         auto var_def = parseVarDef();
 
-        var_decl->varDefs_.push_back(std::move(var_def));
+        varDefs.push_back(var_def);
     } while (match(TokenType::PUNCTUATION_COMMA));
+    var_decl->varDefs_ = arena_.copy(varDefs);
 
     advance(); // 必须分号结尾
 
     return var_decl;
 }
 
-std::unique_ptr<VarDef> Parser::parseVarDef()
+VarDef *Parser::parseVarDef()
 {
-    auto var_def = std::make_unique<VarDef>();
+    auto var_def = arena_.make<VarDef>();
     // 解析标识符
+    var_def->nameId_ = current().symbol_;
     var_def->name_ = advance().value_;
 
     // 解析数组维度[ConstExp]
+    llvm::SmallVector<Exp *, 4> constExps;
     while (match(TokenType::PUNCTUATION_LEFT_BRACKET))
     {
         // 非法情况：int a[];需要排除
-        var_def->constExps_.push_back(parseConstExp());
+        constExps.push_back(parseConstExp());
         advance();
     }
+    var_def->constExps_ = arena_.copy(constExps);
 
     // 解析可选的初始化值
     if (match(TokenType::OPERATOR_ASSIGN))
@@ -127,19 +162,101 @@ std::unique_ptr<VarDef> Parser::parseVarDef()
     return var_def;
 }
 
-std::unique_ptr<FuncDef> Parser::parseFuncDef()
+bool Parser::isFuncDefStart()
 {
-    auto func_def = std::make_unique<FuncDef>();
+    return (check(TokenType::KEYWORD_INT) || check(TokenType::KEYWORD_VOID)) &&
+           peek(2).tokenType_ == TokenType::PUNCTUATION_LEFT_PAREN && peek(1).tokenType_ == TokenType::IDENTIFIER;
+}
+
+// 预扫描 token 序列，按花括号配对找出从当前位置起连续的顶层函数定义，
+// 分批在 pool 上解析后按源码顺序追加到 funcDefs，并把当前位置移到最后一个函数之后
+void Parser::parseFuncDefsParallel(ThreadPool &pool, llvm::SmallVectorImpl<FuncDef *> &funcDefs)
+{
+    const TokenBuffer &tokens = *buffer_;
+    auto kindAt = [&tokens](size_t i)
+    {
+        return i < tokens.size() ? tokens.kind(i) : TokenType::END_OF_FILE;
+    };
+
+    // 每个函数定义的 token 区间 [begin, end)
+    std::vector<std::pair<size_t, size_t>> ranges;
+    size_t pos = tokens_.position();
+    while ((kindAt(pos) == TokenType::KEYWORD_INT || kindAt(pos) == TokenType::KEYWORD_VOID) &&
+           kindAt(pos + 1) == TokenType::IDENTIFIER && kindAt(pos + 2) == TokenType::PUNCTUATION_LEFT_PAREN)
+    {
+        size_t end = pos + 3;
+        while (end < tokens.size() && tokens.kind(end) != TokenType::PUNCTUATION_LEFT_BRACE)
+        {
+            ++end;
+        }
+        int depth = 0;
+        for (; end < tokens.size(); ++end)
+        {
+            TokenType kind = tokens.kind(end);
+            if (kind == TokenType::PUNCTUATION_LEFT_BRACE)
+            {
+                ++depth;
+            }
+            else if (kind == TokenType::PUNCTUATION_RIGHT_BRACE && --depth == 0)
+            {
+                ++end;
+                break;
+            }
+        }
+        ranges.emplace_back(pos, end);
+        pos = end;
+    }
+    if (ranges.empty())
+    {
+        return;
+    }
+
+    // 函数通常很小，按批提交以摊薄调度开销；每批一个子 arena，各自写入 funcDefs 中自己的槽位
+    size_t first = funcDefs.size();
+    funcDefs.resize(first + ranges.size());
+    size_t batches = std::min(ranges.size(), pool.size() * 4);
+    size_t perBatch = (ranges.size() + batches - 1) / batches;
+    std::vector<std::future<void>> pending;
+    for (size_t begin = 0; begin < ranges.size(); begin += perBatch)
+    {
+        size_t end = std::min(begin + perBatch, ranges.size());
+        AstArena &arena = arena_.fork();
+        pending.push_back(pool.submit([this, &tokens, &ranges, &funcDefs, &arena, first, begin, end]()
+        {
+            Parser parser(tokens, ranges[begin].first, ranges[end - 1].second, arena);
+            for (size_t i = begin; i < end; ++i)
+            {
+                funcDefs[first + i] = parser.parseFuncDef();
+            }
+        }));
+    }
+    // 先等全部任务结束（它们引用着本函数的局部变量），再转发其中的异常
+    for (auto &task : pending)
+    {
+        task.wait();
+    }
+    for (auto &task : pending)
+    {
+        task.get();
+    }
+    tokens_.seek(pos);
+}
+
+FuncDef *Parser::parseFuncDef()
+{
+    auto func_def = arena_.make<FuncDef>();
 
     // 解析返回类型
     func_def->returnType_ = parseFuncType();
 
     // 解析函数名
+    func_def->nameId_ = current().symbol_;
     func_def->name_ = advance().value_;
 
     // 解析形参列表
     advance(); // consume "("
     std::vector<TokenType> paramTypes;
+    llvm::SmallVector<FuncParam *, 4> params;
     if (!check(TokenType::PUNCTUATION_RIGHT_PAREN))
     {
         do
@@ -149,9 +266,10 @@ std::unique_ptr<FuncDef> Parser::parseFuncDef()
             // 添加参数类型信息
             paramTypes.push_back(param->bType_->typeName_ == "int" ? TokenType::KEYWORD_INT : TokenType::UNKNOW);
 
-            func_def->params_.push_back(std::move(param));
+            params.push_back(param);
         } while (match(TokenType::PUNCTUATION_COMMA));
     }
+    func_def->params_ = arena_.copy(params);
     advance(); // consume ")"
 
     // 解析函数体
@@ -159,9 +277,9 @@ std::unique_ptr<FuncDef> Parser::parseFuncDef()
     return func_def;
 }
 
-std::unique_ptr<MainFuncDef> Parser::parseMainFuncDef()
+MainFuncDef *Parser::parseMainFuncDef()
 {
-    auto main_func_def = std::make_unique<MainFuncDef>();
+    auto main_func_def = arena_.make<MainFuncDef>();
     advance(); // consume "int"
     advance(); // consume "main"
     advance(); // consume "("
@@ -172,67 +290,72 @@ std::unique_ptr<MainFuncDef> Parser::parseMainFuncDef()
     return main_func_def;
 }
 
-std::unique_ptr<FuncParam> Parser::parseFuncParam()
+FuncParam *Parser::parseFuncParam()
 {
-    auto param = std::make_unique<FuncParam>();
+    auto param = arena_.make<FuncParam>();
     param->bType_ = parseBType();
+    param->nameId_ = current().symbol_;
     param->name_ = advance().value_;
     param->isArray_ = false; // 默认不是数组参数
     // 处理数组类型（如 int a[] 或 int a[2][3]）
+    llvm::SmallVector<Exp *, 4> dimSizes;
     while (match(TokenType::PUNCTUATION_LEFT_BRACKET))
     {
         if (match(TokenType::PUNCTUATION_RIGHT_BRACKET))
         {
-            param->dimSizes_.push_back(nullptr); // 第一维空缺
+            dimSizes.push_back(nullptr); // 第一维空缺
         }
         else
         {
-            param->dimSizes_.push_back(parseConstExp());
+            dimSizes.push_back(parseConstExp());
             advance();
         }
         param->isArray_ = true; // 标记为数组参数
     }
+    param->dimSizes_ = arena_.copy(dimSizes);
     return param;
 }
 
-std::unique_ptr<Block> Parser::parseBlock()
+Block *Parser::parseBlock()
 {
-    auto block = std::make_unique<Block>();
+    auto block = arena_.make<Block>();
     if (check(TokenType::PUNCTUATION_LEFT_BRACE))
     {
         advance(); // consume '{'
+        llvm::SmallVector<BlockItem *, 16> items;
         while (!check(TokenType::PUNCTUATION_RIGHT_BRACE))
         {
-            block->items_.push_back(parseBlockItem());
+            items.push_back(parseBlockItem());
         }
+        block->items_ = arena_.copy(items);
     }
 
     advance(); // consume '}'
     return block;
 }
 
-std::unique_ptr<BlockItem> Parser::parseBlockItem()
+BlockItem *Parser::parseBlockItem()
 {
-    auto block_item = std::make_unique<BlockItem>();
+    auto block_item = arena_.make<BlockItem>();
 
     // 判断当前Token是否为声明（const或int开头）
     if (check(TokenType::KEYWORD_CONST) || check(TokenType::KEYWORD_INT))
     {
         // 解析声明（Decl）
         auto decl = parseDecl();
-        block_item->item_ = std::move(decl);
+        block_item->item_ = decl;
     }
     else
     {
         // 解析语句（Stmt）
         auto stmt = parseStmt();
-        block_item->item_ = std::move(stmt);
+        block_item->item_ = stmt;
     }
 
     return block_item;
 }
 
-std::unique_ptr<Stmt> Parser::parseStmt()
+Stmt *Parser::parseStmt()
 {
     if (check(TokenType::IDENTIFIER) && peek(1).tokenType_ == TokenType::OPERATOR_ASSIGN && peek(2).tokenType_ == TokenType::KEYWORD_GETINT)
     {
@@ -269,37 +392,37 @@ std::unique_ptr<Stmt> Parser::parseStmt()
     }
 }
 
-std::unique_ptr<IfStmt> Parser::parseIfStmt()
+IfStmt *Parser::parseIfStmt()
 {
-    auto if_stmt = std::make_unique<IfStmt>();
+    auto if_stmt = arena_.make<IfStmt>();
     advance(); // consume "if"
-    if_stmt->cond_ = parseLogicalOrExp();
+    if_stmt->cond_ = parseCond();
     advance(); // consume ")"
 
     auto stmt = parseStmt();
-    if_stmt->thenBranch_ = std::move(stmt);
+    if_stmt->thenBranch_ = stmt;
 
     if (match(TokenType::KEYWORD_ELSE))
     {
         stmt = parseStmt();
-        if_stmt->elseBranch_ = std::move(stmt);
+        if_stmt->elseBranch_ = stmt;
     }
     return if_stmt;
 }
 
-std::unique_ptr<WhileStmt> Parser::parseWhileStmt()
+WhileStmt *Parser::parseWhileStmt()
 {
-    auto while_stmt = std::make_unique<WhileStmt>();
+    auto while_stmt = arena_.make<WhileStmt>();
     advance();
-    while_stmt->cond_ = parseLogicalOrExp();
+    while_stmt->cond_ = parseCond();
     advance();
     while_stmt->body_ = parseStmt();
     return while_stmt;
 }
 
-std::unique_ptr<ReturnStmt> Parser::parseReturnStmt()
+ReturnStmt *Parser::parseReturnStmt()
 {
-    auto return_stmt = std::make_unique<ReturnStmt>();
+    auto return_stmt = arena_.make<ReturnStmt>();
 
     // 如果下一个 token 是分号，则说明没有返回值
     if (check(TokenType::PUNCTUATION_SEMICOLON))
@@ -316,9 +439,9 @@ std::unique_ptr<ReturnStmt> Parser::parseReturnStmt()
     return return_stmt;
 }
 
-std::unique_ptr<AssignStmt> Parser::parseAssignStmt()
+AssignStmt *Parser::parseAssignStmt()
 {
-    auto assignment = std::make_unique<AssignStmt>();
+    auto assignment = arena_.make<AssignStmt>();
     assignment->lval_ = parseLVal();
     advance(); // consume =
     assignment->exp_ = parseExp();
@@ -326,242 +449,184 @@ std::unique_ptr<AssignStmt> Parser::parseAssignStmt()
     return assignment;
 }
 
-std::unique_ptr<Exp> Parser::parseExp()
+Exp *Parser::parseExp()
 {
-    return parseAddExp();
+    return parseBinaryExp(kAddPrecedence);
 }
 
-std::unique_ptr<LOrExp> Parser::parseLogicalOrExp()
+Exp *Parser::parseCond()
 {
-    auto exp = std::make_unique<LOrExp>();
-    exp->elements_.push_back(parseLogicalAndExp());
-
-    while (match(TokenType::OPERATOR_LOGICAL_OR))
-    {
-        exp->elements_.push_back(TokenType::OPERATOR_LOGICAL_OR);
-        exp->elements_.push_back(parseLogicalAndExp());
-    }
-    return exp;
+    return parseBinaryExp(kLOrPrecedence);
 }
 
-std::unique_ptr<Exp> Parser::parseLogicalAndExp()
+namespace
 {
-    auto exp = std::make_unique<LAndExp>();
-    exp->elements_.push_back(parseEqExp());
-
-    while (match(TokenType::OPERATOR_LOGICAL_AND))
+    // 二元运算符的优先级，对应文法中 LOrExp ~ MulExp 各层；0 表示不是二元运算符
+    int binaryPrecedence(TokenType type)
     {
-        exp->elements_.push_back(TokenType::OPERATOR_LOGICAL_AND);
-        exp->elements_.push_back(parseEqExp());
-    }
-    return exp;
-}
-
-std::unique_ptr<Exp> Parser::parseEqExp()
-{
-    auto exp = std::make_unique<EqExp>();
-    exp->elements_.push_back(parseRelExp());
-
-    while (true)
-    {
-        if (match(TokenType::OPERATOR_EQUAL))
+        switch (type)
         {
-            exp->elements_.push_back(TokenType::OPERATOR_EQUAL);
-            exp->elements_.push_back(parseRelExp());
-        }
-        else if (match(TokenType::OPERATOR_NOT_EQUAL))
-        {
-            exp->elements_.push_back(TokenType::OPERATOR_NOT_EQUAL);
-            exp->elements_.push_back(parseRelExp());
-        }
-        else
-        {
-            break;
+        case TokenType::OPERATOR_LOGICAL_OR:
+            return 1;
+        case TokenType::OPERATOR_LOGICAL_AND:
+            return 2;
+        case TokenType::OPERATOR_EQUAL:
+        case TokenType::OPERATOR_NOT_EQUAL:
+            return 3;
+        case TokenType::OPERATOR_LESS:
+        case TokenType::OPERATOR_GREATER:
+        case TokenType::OPERATOR_LESS_EQUAL:
+        case TokenType::OPERATOR_GREATER_EQUAL:
+            return 4;
+        case TokenType::OPERATOR_PLUS:
+        case TokenType::OPERATOR_MINUS:
+            return 5;
+        case TokenType::OPERATOR_MULTIPLY:
+        case TokenType::OPERATOR_DIVIDE:
+        case TokenType::OPERATOR_MODULO:
+            return 6;
+        default:
+            return 0;
         }
     }
-    return exp;
-}
 
-std::unique_ptr<Exp> Parser::parseRelExp()
-{
-    auto exp = std::make_unique<RelExp>();
-    exp->elements_.push_back(parseAddExp());
-
-    while (true)
+    template <typename T>
+    Exp *makeLayer(AstArena &arena, llvm::ArrayRef<std::variant<Exp *, TokenType>> elements)
     {
-        if (match(TokenType::OPERATOR_LESS))
-        {
-            exp->elements_.push_back(TokenType::OPERATOR_LESS);
-            exp->elements_.push_back(parseAddExp());
-        }
-        else if (match(TokenType::OPERATOR_GREATER))
-        {
-            exp->elements_.push_back(TokenType::OPERATOR_GREATER);
-            exp->elements_.push_back(parseAddExp());
-        }
-        else if (match(TokenType::OPERATOR_LESS_EQUAL))
-        {
-            exp->elements_.push_back(TokenType::OPERATOR_LESS_EQUAL);
-            exp->elements_.push_back(parseAddExp());
-        }
-        else if (match(TokenType::OPERATOR_GREATER_EQUAL))
-        {
-            exp->elements_.push_back(TokenType::OPERATOR_GREATER_EQUAL);
-            exp->elements_.push_back(parseAddExp());
-        }
-        else
-        {
-            break;
-        }
+        auto exp = arena.make<T>();
+        exp->elements_ = arena.copy(elements);
+        return exp;
     }
-    return exp;
 }
 
-std::unique_ptr<AddExp> Parser::parseAddExp()
+// 优先级爬升：同一优先级的连续运算收拢为一个多元层节点，
+// 只有一个操作数的层不建节点，直接返回操作数
+Exp *Parser::parseBinaryExp(int minPrecedence)
 {
-    auto exp = std::make_unique<AddExp>();
-
-    // 第一个元素必须是MulExp
-    exp->elements_.push_back(parseMulExp());
-
-    // 后续处理运算符和操作数
+    Exp *lhs = parseUnaryExp();
     while (true)
     {
-        if (match(TokenType::OPERATOR_PLUS))
-        {
-            exp->elements_.push_back(TokenType::OPERATOR_PLUS);
-            exp->elements_.push_back(parseMulExp());
-        }
-        else if (match(TokenType::OPERATOR_MINUS))
-        {
-            exp->elements_.push_back(TokenType::OPERATOR_MINUS);
-            exp->elements_.push_back(parseMulExp());
-        }
-        else
+        int precedence = binaryPrecedence(current().tokenType_);
+        if (precedence == 0 || precedence < minPrecedence)
         {
-            break;
+            return lhs;
         }
-    }
-    return exp;
-}
-
-std::unique_ptr<MulExp> Parser::parseMulExp()
-{
-    auto exp = std::make_unique<MulExp>();
-
-    // 第一个元素必须是UnaryExp
-    exp->elements_.push_back(parseUnaryExp());
 
-    // 后续处理运算符和操作数
-    while (true)
-    {
-        if (match(TokenType::OPERATOR_MULTIPLY))
-        {
-            exp->elements_.push_back(TokenType::OPERATOR_MULTIPLY);
-            exp->elements_.push_back(parseUnaryExp());
-        }
-        else if (match(TokenType::OPERATOR_DIVIDE))
+        llvm::SmallVector<std::variant<Exp *, TokenType>, 8> elements;
+        elements.push_back(lhs);
+        while (binaryPrecedence(current().tokenType_) == precedence)
         {
-            exp->elements_.push_back(TokenType::OPERATOR_DIVIDE);
-            exp->elements_.push_back(parseUnaryExp());
+            elements.push_back(advance().tokenType_);
+            elements.push_back(parseBinaryExp(precedence + 1));
         }
-        else if (match(TokenType::OPERATOR_MODULO))
-        {
-            exp->elements_.push_back(TokenType::OPERATOR_MODULO);
-            exp->elements_.push_back(parseUnaryExp());
-        }
-        else
+
+        // 右侧已吞掉所有更高优先级的运算符，因此 precedence 在循环中严格递减
+        switch (precedence)
         {
+        case 1:
+            lhs = makeLayer<LOrExp>(arena_, elements);
+            break;
+        case 2:
+            lhs = makeLayer<LAndExp>(arena_, elements);
+            break;
+        case 3:
+            lhs = makeLayer<EqExp>(arena_, elements);
+            break;
+        case 4:
+            lhs = makeLayer<RelExp>(arena_, elements);
+            break;
+        case 5:
+            lhs = makeLayer<AddExp>(arena_, elements);
+            break;
+        default:
+            lhs = makeLayer<MulExp>(arena_, elements);
             break;
         }
     }
-    return exp;
 }
 
-std::unique_ptr<Exp> Parser::parseUnaryExp()
+Exp *Parser::parseUnaryExp()
 {
-    auto unary_exp = std::make_unique<UnaryExp>();
-    // 1. 操作符
+    UnaryExp::Op op;
     if (match(TokenType::OPERATOR_PLUS))
     {
-        unary_exp->op = UnaryExp::Op::Plus;
+        op = UnaryExp::Op::Plus;
     }
     else if (match(TokenType::OPERATOR_MINUS))
     {
-        unary_exp->op = UnaryExp::Op::Minus;
+        op = UnaryExp::Op::Minus;
     }
     else if (match(TokenType::OPERATOR_LOGICAL_NOT))
     {
-        unary_exp->op = UnaryExp::Op::Not;
+        op = UnaryExp::Op::Not;
     }
-
-    // 2. operand_ 现在可能是 CallExp、UnaryExp 或 PrimaryExp
-    if (check(TokenType::IDENTIFIER) && peek(1).tokenType_ == TokenType::PUNCTUATION_LEFT_PAREN)
+    else if (check(TokenType::IDENTIFIER) && peek(1).tokenType_ == TokenType::PUNCTUATION_LEFT_PAREN)
     {
-        unary_exp->operand_ = parseCallExp();
-    }
-    else if (check(TokenType::OPERATOR_PLUS) || check(TokenType::OPERATOR_MINUS) || check(TokenType::OPERATOR_LOGICAL_NOT))
-    {
-        // 连续的一元运算符
-        unary_exp->operand_ = parseUnaryExp();
+        return parseCallExp();
     }
     else
     {
-        unary_exp->operand_ = parsePrimaryExp();
+        // 没有一元运算符时不再包一层 UnaryExp
+        return parsePrimaryExp();
     }
 
+    // operand_ 可能是 CallExp、带运算符的 UnaryExp 或基本表达式
+    auto unary_exp = arena_.make<UnaryExp>();
+    unary_exp->op = op;
+    unary_exp->operand_ = parseUnaryExp();
     return unary_exp;
 }
 
-std::unique_ptr<PrimaryExp> Parser::parsePrimaryExp()
+Exp *Parser::parsePrimaryExp()
 {
-    auto primary_exp = std::make_unique<PrimaryExp>();
-    if (check(TokenType::PUNCTUATION_LEFT_PAREN))
+    // 只有括号表达式保留 PrimaryExp 节点，左值与数字直接返回
+    if (match(TokenType::PUNCTUATION_LEFT_PAREN))
     {
-        advance();
+        auto primary_exp = arena_.make<PrimaryExp>();
         primary_exp->operand_ = parseExp();
+        advance(); // consume ")"
+        return primary_exp;
     }
 
-    if (token_.tokenType_ == TokenType::IDENTIFIER)
+    if (current().tokenType_ == TokenType::IDENTIFIER)
     {
-        primary_exp->operand_ = parseLVal();
+        return parseLVal();
     }
-    else
-    {
-        primary_exp->operand_ = parseNumber();
-    }
-    return primary_exp;
+    return parseNumber();
 }
 
-std::unique_ptr<LVal> Parser::parseLVal()
+LVal *Parser::parseLVal()
 {
-    auto lVal = std::make_unique<LVal>();
-    lVal->name_ = token_.value_;
+    auto lVal = arena_.make<LVal>();
+    lVal->name_ = current().value_;
+    lVal->nameId_ = current().symbol_;
 
     advance(); // consume IDENTIFIER
 
+    llvm::SmallVector<Exp *, 4> indices;
     while (match(TokenType::PUNCTUATION_LEFT_BRACKET))
     {
-        lVal->indices_.push_back(parseExp());
+        indices.push_back(parseExp());
         advance();
     }
+    lVal->indices_ = arena_.copy(indices);
     return lVal;
 }
 
-std::unique_ptr<Number> Parser::parseNumber()
+Number *Parser::parseNumber()
 {
-    auto num = std::make_unique<Number>();
-    num->value_ = std::stoi(token_.value_);
+    auto num = arena_.make<Number>();
+    num->value_ = std::stoi(std::string(current().value_));
     advance();
     return num;
 }
 
-std::unique_ptr<ConstInitVal> Parser::parseConstInitVal()
+ConstInitVal *Parser::parseConstInitVal()
 {
-    auto init_val = std::make_unique<ConstInitVal>();
+    auto init_val = arena_.make<ConstInitVal>();
     if (match(TokenType::PUNCTUATION_LEFT_BRACE))
     {
-        std::vector<std::unique_ptr<ConstInitVal>> elements;
+        llvm::SmallVector<ConstInitVal *, 8> elements;
         if (!check(TokenType::PUNCTUATION_RIGHT_BRACE))
         {
             do
@@ -570,7 +635,7 @@ std::unique_ptr<ConstInitVal> Parser::parseConstInitVal()
             } while (match(TokenType::PUNCTUATION_COMMA));
         }
         advance();
-        init_val->value_ = std::move(elements);
+        init_val->value_ = arena_.copy(elements);
     }
     else
     {
@@ -579,9 +644,9 @@ std::unique_ptr<ConstInitVal> Parser::parseConstInitVal()
     return init_val;
 }
 
-std::unique_ptr<InitVal> Parser::parseInitVal()
+InitVal *Parser::parseInitVal()
 {
-    auto init_val = std::make_unique<InitVal>();
+    auto init_val = arena_.make<InitVal>();
 
     // 情况1：初始化值为表达式（非数组初始化）
     if (!check(TokenType::PUNCTUATION_LEFT_BRACE))
@@ -593,7 +658,7 @@ std::unique_ptr<InitVal> Parser::parseInitVal()
     // 情况2：初始化值为数组初始化列表（{ ... }）
     advance(); // consume '{'
 
-    std::vector<std::unique_ptr<InitVal>> elements;
+    llvm::SmallVector<InitVal *, 8> elements;
 
     // 处理可能的空列表（例如 int a[2] = {};）
     if (!check(TokenType::PUNCTUATION_RIGHT_BRACE))
@@ -610,53 +675,56 @@ std::unique_ptr<InitVal> Parser::parseInitVal()
     }
 
     advance();                              // consume '}'
-    init_val->value_ = std::move(elements); // 保存嵌套的初始化列表
+    init_val->value_ = arena_.copy(elements); // 保存嵌套的初始化列表
     return init_val;
 }
 
-std::unique_ptr<FuncType> Parser::parseFuncType()
+FuncType *Parser::parseFuncType()
 {
-    auto func_type = std::make_unique<FuncType>();
+    auto func_type = arena_.make<FuncType>();
     func_type->typeName_ = peek().value_;
     advance();
     return func_type;
 }
 
-std::unique_ptr<BType> Parser::parseBType()
+BType *Parser::parseBType()
 {
-    auto bType = std::make_unique<BType>();
+    auto bType = arena_.make<BType>();
     bType->typeName_ = advance().value_; //  // 目前只有int
     return bType;
 }
 
-std::unique_ptr<Exp> Parser::parseConstExp()
+Exp *Parser::parseConstExp()
 {
-    return parseAddExp();
+    return parseBinaryExp(kAddPrecedence);
 }
 
-std::unique_ptr<Stmt> Parser::parseExpStmt()
+Stmt *Parser::parseExpStmt()
 {
-    auto exp_stmt = std::make_unique<ExpStmt>();
+    auto exp_stmt = arena_.make<ExpStmt>();
     exp_stmt->exp_ = parseExp();
     advance(); // consume ";"
     return exp_stmt;
 }
 
-std::unique_ptr<CallExp> Parser::parseCallExp()
+CallExp *Parser::parseCallExp()
 {
-    auto call_exp = std::make_unique<CallExp>();
+    auto call_exp = arena_.make<CallExp>();
+    call_exp->funcId_ = current().symbol_;
     call_exp->funcName = advance().value_;
 
     advance(); // consume "("
 
     // 解析参数列表（可能为空）
+    llvm::SmallVector<Exp *, 4> args;
     if (!check(TokenType::PUNCTUATION_RIGHT_PAREN))
     {
         do
         {
-            call_exp->args_.push_back(parseExp());
+            args.push_back(parseExp());
         } while (match(TokenType::PUNCTUATION_COMMA));
     }
+    call_exp->args_ = arena_.copy(args);
 
     advance(); // consume ")"
     return call_exp;
@@ -664,18 +732,18 @@ std::unique_ptr<CallExp> Parser::parseCallExp()
 
 bool Parser::isAtEnd()
 {
-    return current_ >= tokens_.size();
+    return current().tokenType_ == TokenType::END_OF_FILE;
 }
 
-Token Parser::previous()
+const Token &Parser::previous()
 {
-    return current_ != 0 ? tokens_[current_ - 1] : tokens_[0];
+    return tokens_.previous();
 }
 
 bool Parser::isAssignStmt()
 {
     size_t i = 0;
-    while (peek(i).tokenType_ != TokenType::PUNCTUATION_SEMICOLON)
+    while (peek(i).tokenType_ != TokenType::PUNCTUATION_SEMICOLON && peek(i).tokenType_ != TokenType::END_OF_FILE)
     {
         if (peek(i).tokenType_ == TokenType::OPERATOR_ASSIGN)
         {
@@ -686,9 +754,9 @@ bool Parser::isAssignStmt()
     return false;
 }
 
-std::unique_ptr<IOStmt> Parser::parsePrintfStmt()
+IOStmt *Parser::parsePrintfStmt()
 {
-    auto stmt = std::make_unique<IOStmt>();
+    auto stmt = arena_.make<IOStmt>();
     stmt->kind = IOStmt::IOKind::Printf;
     advance(); // consume "printf"
     advance(); // consume "("
@@ -697,26 +765,28 @@ std::unique_ptr<IOStmt> Parser::parsePrintfStmt()
     if (!check(TokenType::CONSTANT_STRING))
     {
     }
-    stmt->formatString_ = token_.value_;
+    stmt->formatString_ = current().value_;
     advance(); // consume format string
 
     // 解析参数列表
+    llvm::SmallVector<Exp *, 4> args;
     if (match(TokenType::PUNCTUATION_COMMA))
     {
         do
         {
-            stmt->args_.push_back(parseExp());
+            args.push_back(parseExp());
         } while (match(TokenType::PUNCTUATION_COMMA));
     }
+    stmt->args_ = arena_.copy(args);
 
     advance(); // consume ")"
     advance(); // consume ";"
     return stmt;
 }
 
-std::unique_ptr<IOStmt> Parser::parseGetintStmt()
+IOStmt *Parser::parseGetintStmt()
 {
-    auto stmt = std::make_unique<IOStmt>();
+    auto stmt = arena_.make<IOStmt>();
     stmt->kind = IOStmt::IOKind::Getint;
     stmt->target_ = parseLVal();
     advance(); // consume "="
@@ -727,33 +797,19 @@ std::unique_ptr<IOStmt> Parser::parseGetintStmt()
     return stmt;
 }
 
-Token Parser::peek(size_t ahead) const
+const Token &Parser::peek(size_t ahead)
 {
-    if (current_ + ahead >= tokens_.size())
-    {
-        return Token(TokenType::END_OF_FILE, "", 0, 0);
-    }
-    return tokens_[current_ + ahead];
+    return tokens_.peek(ahead);
 }
 
-Token Parser::advance()
+const Token &Parser::advance()
 {
-    Token token;
-    if (current_ < tokens_.size())
-    {
-        token = tokens_[current_++];
-        token_ = tokens_[current_];
-    }
-    else
-    {
-        token_ = Token(TokenType::END_OF_FILE, "", 0, 0);
-    }
-    return token;
+    return tokens_.advance();
 }
 
 bool Parser::match(TokenType type)
 {
-    if (token_.tokenType_ == type)
+    if (current().tokenType_ == type)
     {
         advance();
         return true;
@@ -762,7 +818,7 @@ bool Parser::match(TokenType type)
     return false;
 }
 
-bool Parser::check(TokenType type) const
+bool Parser::check(TokenType type)
 {
-    return type == token_.tokenType_;
+    return type == current().tokenType_;
 }
\ No newline at end of file
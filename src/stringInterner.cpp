@@ -0,0 +1,108 @@
+#include "stringInterner.h"
+#include <cstring>
+
+StringInterner::StringInterner() : slots_(256, Slot{0, kNoSymbol}), chunkUsed_(kChunkSize)
+{
+    spellings_.emplace_back(); // 编号 0 保留给 kNoSymbol
+}
+
+SymbolId StringInterner::intern(std::string_view text)
+{
+    uint32_t h = hash(text);
+    size_t index = probe(text, h);
+    if (slots_[index].id != kNoSymbol)
+    {
+        return slots_[index].id;
+    }
+
+    SymbolId id = static_cast<SymbolId>(spellings_.size());
+    spellings_.push_back(store(text));
+    slots_[index] = Slot{h, id};
+    // 装载因子超过 1/2 时扩容
+    if (spellings_.size() * 2 > slots_.size())
+    {
+        grow();
+    }
+    return id;
+}
+
+SymbolId StringInterner::find(std::string_view text) const
+{
+    return slots_[probe(text, hash(text))].id;
+}
+
+std::string_view StringInterner::spelling(SymbolId id) const
+{
+    return id < spellings_.size() ? spellings_[id] : std::string_view();
+}
+
+size_t StringInterner::size() const
+{
+    return spellings_.size();
+}
+
+// FNV-1a
+uint32_t StringInterner::hash(std::string_view text)
+{
+    uint32_t h = 2166136261u;
+    for (char c : text)
+    {
+        h = (h ^ static_cast<unsigned char>(c)) * 16777619u;
+    }
+    return h;
+}
+
+// 线性探测：返回 text 所在槽位，不存在时返回应插入的空槽
+size_t StringInterner::probe(std::string_view text, uint32_t hash) const
+{
+    size_t mask = slots_.size() - 1;
+    for (size_t index = hash & mask;; index = (index + 1) & mask)
+    {
+        const Slot &slot = slots_[index];
+        if (slot.id == kNoSymbol || (slot.hash == hash && spellings_[slot.id] == text))
+        {
+            return index;
+        }
+    }
+}
+
+// 把拼写复制到分块存储中；块写满后另起新块，已有视图不受影响
+std::string_view StringInterner::store(std::string_view text)
+{
+    if (text.size() > kChunkSize)
+    {
+        chunks_.push_back(std::make_unique<char[]>(text.size()));
+        std::memcpy(chunks_.back().get(), text.data(), text.size());
+        chunkUsed_ = kChunkSize; // 独占一块，下一次从新块开始
+        return std::string_view(chunks_.back().get(), text.size());
+    }
+    if (chunkUsed_ + text.size() > kChunkSize)
+    {
+        chunks_.push_back(std::make_unique<char[]>(kChunkSize));
+        chunkUsed_ = 0;
+    }
+    char *data = chunks_.back().get() + chunkUsed_;
+    std::memcpy(data, text.data(), text.size());
+    chunkUsed_ += text.size();
+    return std::string_view(data, text.size());
+}
+
+void StringInterner::grow()
+{
+    std::vector<Slot> old(slots_.size() * 2, Slot{0, kNoSymbol});
+    old.swap(slots_);
+    size_t mask = slots_.size() - 1;
+    for (const Slot &slot : old)
+    {
+        if (slot.id == kNoSymbol)
+        {
+            continue;
+        }
+        size_t index = slot.hash & mask;
+        while (slots_[index].id != kNoSymbol)
+        {
+            index = (index + 1) & mask;
+        }
+        slots_[index] = slot;
+    }
+}
@@ -1,22 +1,37 @@
 #include "symbolTable.h"
+#include <algorithm>
 
 // 构造函数：初始化全局作用域，并添加内置函数
-SymbolTable::SymbolTable()
+SymbolTable::SymbolTable(StringInterner &interner) : interner_(interner)
 {
     // 建立全局作用域
     enterScope();
     addBuiltinFunctions();
 }
 
+SymbolTable::SymbolTable(StringInterner &interner, const SymbolTable &outer) : interner_(interner), outer_(&outer)
+{
+    // 与外层的全局作用域对应的空作用域
+    enterScope();
+}
+
 void SymbolTable::enterScope()
 {
-    scopes_.emplace_back();
+    scopes_.push_back(static_cast<uint32_t>(bindings_.size()));
 }
 
 void SymbolTable::exitScope()
 {
     if (!scopes_.empty())
     {
+        // 逆序撤销本作用域加入的绑定，恢复被遮蔽的外层绑定
+        uint32_t begin = scopes_.back();
+        for (size_t i = bindings_.size(); i > begin; --i)
+        {
+            const Binding &binding = bindings_[i - 1];
+            heads_[binding.symbol_->id_] = binding.shadowed_;
+        }
+        bindings_.resize(begin);
         scopes_.pop_back();
     }
     else
@@ -25,55 +40,56 @@ void SymbolTable::exitScope()
     }
 }
 
-bool SymbolTable::addSymbol(std::unique_ptr<Symbol> symbol)
+Symbol *SymbolTable::addSymbol(Symbol *symbol)
 {
     if (scopes_.empty())
     {
         std::cerr << "Error: No scope exists to add symbol " << symbol->name_ << std::endl;
-        return false;
+        return nullptr;
     }
-    auto &currentScope = scopes_.back();
-    if (currentScope.find(symbol->name_) != currentScope.end())
+    if (lookupInCurrentScope(symbol->id_) != nullptr)
     {
         // 当前作用域中已存在同名符号，视为重定义错误
         std::cerr << "Error: Duplicate definition of symbol " << symbol->name_ << std::endl;
-        return false;
+        return nullptr;
+    }
+    if (symbol->id_ >= heads_.size())
+    {
+        heads_.resize(std::max<size_t>(interner_.size(), symbol->id_ + 1), kNoBinding);
     }
-    currentScope[symbol->name_] = std::move(symbol);
-    return true;
+    uint32_t &head = heads_[symbol->id_];
+    bindings_.push_back({symbol, head});
+    head = static_cast<uint32_t>(bindings_.size() - 1);
+    return symbol;
 }
 
-Symbol *SymbolTable::lookup(const std::string &name)
+Symbol *SymbolTable::lookup(SymbolId id) const
 {
-    for (auto scopeIt = scopes_.rbegin(); scopeIt != scopes_.rend(); ++scopeIt)
+    if (id >= heads_.size() || heads_[id] == kNoBinding)
     {
-        auto it = scopeIt->find(name);
-        if (it != scopeIt->end())
-        {
-            return it->second.get();
-        }
+        return outer_ ? outer_->lookup(id) : nullptr;
     }
-    return nullptr;
+    return bindings_[heads_[id]].symbol_;
 }
 
-Symbol *SymbolTable::lookupInCurrentScope(const std::string &name)
+Symbol *SymbolTable::lookupInCurrentScope(SymbolId id) const
 {
     if (scopes_.empty())
         return nullptr;
-    auto &currentScope = scopes_.back();
-    auto it = currentScope.find(name);
-    if (it != currentScope.end())
+    // 当前作用域的绑定都位于 bindings_ 末尾、作用域起点之后
+    if (id >= heads_.size() || heads_[id] == kNoBinding || heads_[id] < scopes_.back())
     {
-        return it->second.get();
+        return nullptr;
     }
-    return nullptr;
+    return bindings_[heads_[id]].symbol_;
 }
 
 void SymbolTable::addBuiltinFunctions()
 {
     // 添加 getint 函数：返回 int，无参数
-    auto getintSymbol = std::make_unique<FunctionSymbol>();
+    FunctionSymbol *getintSymbol = create<FunctionSymbol>();
     getintSymbol->name_ = "getint";
+    getintSymbol->id_ = interner_.intern(getintSymbol->name_);
     getintSymbol->symbolType_ = SymbolType::FUNCTION;
     getintSymbol->dataType_ = TokenType::KEYWORD_INT; // 返回 int
     getintSymbol->lineDefined_ = 0;
@@ -83,21 +99,22 @@ void SymbolTable::addBuiltinFunctions()
 
     getintSymbol->hasReturn_ = true;
 
-    if (!this->addSymbol(std::move(getintSymbol)))
+    if (!this->addSymbol(getintSymbol))
     {
         // 添加失败，说明已经定义过，报告错误,可以调用错误处理函数
         std::cerr << "Error: Function 'getint' is redefined." << std::endl;
     }
 
-    auto printfSymbol = std::make_unique<FunctionSymbol>();
+    FunctionSymbol *printfSymbol = create<FunctionSymbol>();
     printfSymbol->name_ = "printf";
+    printfSymbol->id_ = interner_.intern(printfSymbol->name_);
     printfSymbol->symbolType_ = SymbolType::FUNCTION;
     printfSymbol->dataType_ = TokenType::KEYWORD_INT;
     printfSymbol->lineDefined_ = 0;
     printfSymbol->paramTypes_ = {TokenType::CONSTANT_STRING};
     printfSymbol->hasReturn_ = true;
 
-    if (!this->addSymbol(std::move(printfSymbol)))
+    if (!this->addSymbol(printfSymbol))
     {
         std::cerr << "Error: Function 'printf' is redefined." << std::endl;
     }
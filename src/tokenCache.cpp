@@ -0,0 +1,132 @@
+#include "tokenCache.h"
+#include "cacheFile.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <algorithm>
+#include <cstring>
+#include <list>
+
+namespace
+{
+    constexpr char kMagic[4] = {'C', 'C', 'L', 'T'};
+
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint64_t sourceHash;
+        uint64_t sourceSize;
+        uint32_t tokenCount;
+        uint32_t messageCount;
+    };
+}
+
+TokenCache::TokenCache(std::string directory) : directory_(std::move(directory)) {}
+
+std::string TokenCache::pathFor(std::string_view source) const
+{
+    return cachefile::pathFor(directory_, source, ".tok");
+}
+
+bool TokenCache::load(Lexer &lexer) const
+{
+    std::string_view source = lexer.sourceCode_;
+    llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> file =
+        llvm::MemoryBuffer::getFile(pathFor(source), /*IsText=*/false, /*RequiresNullTerminator=*/false);
+    if (!file)
+    {
+        return false;
+    }
+
+    cachefile::Reader reader((*file)->getBuffer());
+    Header header;
+    reader.read(&header, sizeof(header));
+    if (reader.failed() || std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+        header.sourceSize != source.size() || header.sourceHash != cachefile::hash(source))
+    {
+        return false;
+    }
+
+    TokenBuffer tokens(source);
+    reader.readArray(tokens.kinds_, header.tokenCount);
+    reader.readArray(tokens.offsets_, header.tokenCount);
+    reader.readArray(tokens.lengths_, header.tokenCount);
+    std::list<std::string> messages;
+    for (uint32_t i = 0; i < header.messageCount && !reader.failed(); ++i)
+    {
+        messages.emplace_back(reader.readString());
+        tokens.messages_.push_back(messages.back());
+    }
+    if (!reader.complete())
+    {
+        return false;
+    }
+
+    // 逐个校验，损坏的文件不能产生越界的视图
+    tokens.symbols_.assign(header.tokenCount, kNoSymbol);
+    for (size_t i = 0; i < tokens.size(); ++i)
+    {
+        if (tokens.kinds_[i] > static_cast<uint8_t>(TokenType::ERROR))
+        {
+            return false;
+        }
+        if (tokens.kind(i) == TokenType::ERROR ? tokens.lengths_[i] >= tokens.messages_.size()
+                                               : tokens.offsets_[i] > source.size() ||
+                                                     tokens.lengths_[i] > source.size() - tokens.offsets_[i])
+        {
+            return false;
+        }
+    }
+    if (tokens.size() == 0 || tokens.kind(tokens.size() - 1) != TokenType::END_OF_FILE)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < tokens.size(); ++i)
+    {
+        if (tokens.kind(i) == TokenType::IDENTIFIER)
+        {
+            tokens.symbols_[i] = lexer.interner_.intern(tokens.text(i));
+        }
+    }
+
+    lexer.tokens_ = std::move(tokens);
+    lexer.messages_.splice(lexer.messages_.end(), messages);
+    lexer.currentPosition_ = source.size();
+    return true;
+}
+
+bool TokenCache::store(const Lexer &lexer) const
+{
+    const TokenBuffer &tokens = lexer.tokens_;
+    std::string_view source = lexer.sourceCode_;
+    return cachefile::writeAtomically(directory_, pathFor(source), [&](llvm::raw_ostream &os) {
+        Header header;
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.sourceHash = cachefile::hash(source);
+        header.sourceSize = source.size();
+        header.tokenCount = static_cast<uint32_t>(tokens.size());
+        header.messageCount = static_cast<uint32_t>(tokens.messages_.size());
+        cachefile::writeValue(os, header);
+        cachefile::writeArray<uint8_t>(os, tokens.kinds_);
+        cachefile::writeArray<uint32_t>(os, tokens.offsets_);
+        cachefile::writeArray<uint32_t>(os, tokens.lengths_);
+        for (std::string_view message : tokens.messages_)
+        {
+            cachefile::writeString(os, message);
+        }
+    });
+}
+
+size_t TokenCache::firstDifference(const TokenBuffer &lhs, const TokenBuffer &rhs)
+{
+    size_t count = std::min(lhs.size(), rhs.size());
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (lhs.kind(i) != rhs.kind(i) || lhs.offset(i) != rhs.offset(i) || lhs.text(i) != rhs.text(i) ||
+            lhs.symbol(i) != rhs.symbol(i))
+        {
+            return i;
+        }
+    }
+    return lhs.size() == rhs.size() ? kSame : count;
+}
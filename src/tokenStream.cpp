@@ -0,0 +1,81 @@
+#include "tokenStream.h"
+
+TokenStream::TokenStream(Lexer &lexer)
+    : lexer_(&lexer), tokens_(nullptr), replayPosition_(0), replayEnd_(0), ring_(kInitialCapacity), mask_(kInitialCapacity - 1), head_(1), count_(0),
+      endOfFile_(TokenType::END_OF_FILE, "", 0), exhausted_(false)
+{
+}
+
+TokenStream::TokenStream(const TokenBuffer &tokens) : TokenStream(tokens, 0, tokens.size())
+{
+}
+
+TokenStream::TokenStream(const TokenBuffer &tokens, size_t begin, size_t end)
+    : lexer_(nullptr), tokens_(&tokens), replayPosition_(begin), replayEnd_(end), ring_(kInitialCapacity),
+      mask_(kInitialCapacity - 1), head_(1), count_(0), endOfFile_(TokenType::END_OF_FILE, "", 0), exhausted_(false)
+{
+}
+
+void TokenStream::seek(size_t index)
+{
+    replayPosition_ = index;
+    count_ = 0;
+    exhausted_ = false;
+}
+
+// 从数据源取下一个 token 写入 slot；遇到 END_OF_FILE 后不再访问数据源
+void TokenStream::fetch(Token &slot)
+{
+    if (exhausted_)
+    {
+        slot = endOfFile_;
+        return;
+    }
+
+    if (lexer_)
+    {
+        slot = lexer_->getNextToken();
+    }
+    else if (replayPosition_ < replayEnd_)
+    {
+        slot = (*tokens_)[replayPosition_++];
+    }
+    else
+    {
+        slot = endOfFile_;
+    }
+
+    if (slot.tokenType_ == TokenType::END_OF_FILE)
+    {
+        exhausted_ = true;
+        endOfFile_ = slot;
+    }
+}
+
+// 保证缓冲区中至少有 count 个未消费的 token
+void TokenStream::fill(size_t count)
+{
+    while (count_ < count)
+    {
+        if (count_ + 1 == ring_.size())
+        {
+            grow();
+        }
+        fetch(ring_[(head_ + count_) & mask_]);
+        ++count_;
+    }
+}
+
+// 前瞻超过当前容量时（如 isAssignStmt 扫描整条语句）按 2 倍扩容，
+// 保持元素顺序，并把刚被消费的 token 一并搬到新缓冲区 head_ 之前
+void TokenStream::grow()
+{
+    std::vector<Token> larger(ring_.size() * 2);
+    for (size_t i = 0; i <= count_; ++i)
+    {
+        larger[i] = ring_[(head_ - 1 + i) & mask_];
+    }
+    ring_.swap(larger);
+    mask_ = ring_.size() - 1;
+    head_ = 1;
+}
@@ -0,0 +1,140 @@
+// 语法树缓存测试：把 tests/inputs 语料及内置用例解析后写入缓存，再用全新的驻留表与 arena 读回，
+// 检查两棵树的 SyntaxOutputVisitor 输出、节点数与标识符编号完全相同；
+// 同时检查源码改动后不命中、截断或损坏的缓存文件被拒绝。
+// 用法：ast_cache_test <语料目录> <临时缓存目录>
+#include "SyntaxOutputVisitor.hpp"
+#include "astCache.h"
+#include "testFixtures.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+    using TestFixtures::readFile;
+
+    // 语法输出直接写 std::cout，这里临时重定向
+    std::string syntaxOutput(AST::CompUnit &program)
+    {
+        std::ostringstream out;
+        std::streambuf *saved = std::cout.rdbuf(out.rdbuf());
+        SyntaxOutputVisitor visitor(out);
+        visitor.visitNode(program);
+        std::cout.rdbuf(saved);
+        return out.str();
+    }
+
+    void writeFile(const std::string &path, const std::string &content)
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << content;
+    }
+
+    bool roundTrip(const std::string &name, const std::string &source, const AstCache &cache)
+    {
+        StringInterner interner;
+        AST::AstArena arena;
+        Lexer lexer(source, interner);
+        Parser parser(lexer, arena);
+        CompUnit *program = parser.parseCompUnit();
+        std::string expected = syntaxOutput(*program);
+        FlatAst expectedFlat = FlatAst::build(*program);
+        if (!cache.store(source, *program, interner))
+        {
+            std::cerr << "FAIL " << name << ": cannot write " << cache.pathFor(source) << std::endl;
+            return false;
+        }
+
+        StringInterner loadedInterner;
+        AST::AstArena loadedArena;
+        CompUnit *loaded = cache.load(source, loadedArena, loadedInterner);
+        if (!loaded)
+        {
+            std::cerr << "FAIL " << name << ": cache miss after store" << std::endl;
+            return false;
+        }
+        if (syntaxOutput(*loaded) != expected || loadedArena.nodeCount() != arena.nodeCount() ||
+            loadedInterner.size() != interner.size())
+        {
+            std::cerr << "FAIL " << name << ": loaded tree differs from the parsed tree" << std::endl;
+            return false;
+        }
+        // 编号一致，后续阶段以编号为键的结果不受缓存影响
+        FlatAst actualFlat = FlatAst::build(*loaded);
+        for (uint32_t i = 0; i < expectedFlat.size(); ++i)
+        {
+            if (actualFlat.size() != expectedFlat.size() || actualFlat[i].value_ != expectedFlat[i].value_)
+            {
+                std::cerr << "FAIL " << name << ": node #" << i << " differs after reload" << std::endl;
+                return false;
+            }
+        }
+
+        // 源码改变后不应命中
+        StringInterner otherInterner;
+        AST::AstArena otherArena;
+        if (cache.load(source + " ", otherArena, otherInterner))
+        {
+            std::cerr << "FAIL " << name << ": cache hit for a different source" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // 截断与逐字节破坏的缓存文件要么被拒绝，要么重建出合法的树，不能崩溃
+    bool rejectsDamage(const std::string &source, const AstCache &cache)
+    {
+        std::string path = cache.pathFor(source);
+        std::string original = readFile(path);
+        bool ok = true;
+        for (size_t size : {size_t(0), size_t(7), original.size() / 2, original.size() - 1})
+        {
+            writeFile(path, original.substr(0, size));
+            StringInterner interner;
+            AST::AstArena arena;
+            if (cache.load(source, arena, interner))
+            {
+                std::cerr << "FAIL truncated cache (" << size << " bytes) was accepted" << std::endl;
+                ok = false;
+            }
+        }
+        for (size_t i = 40; i < original.size(); i += 7)
+        {
+            std::string damaged = original;
+            damaged[i] = static_cast<char>(damaged[i] ^ 0x5a);
+            writeFile(path, damaged);
+            StringInterner interner;
+            AST::AstArena arena;
+            if (CompUnit *program = cache.load(source, arena, interner))
+            {
+                syntaxOutput(*program);
+            }
+        }
+        writeFile(path, original);
+        return ok;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+    {
+        std::cerr << "usage: ast_cache_test <inputs dir> <cache dir>" << std::endl;
+        return 2;
+    }
+
+    std::filesystem::remove_all(argv[2]);
+    AstCache cache(argv[2]);
+    size_t failures = 0;
+    auto corpus = TestFixtures::loadCorpus(argv[1]);
+    for (const auto &[name, source] : corpus)
+    {
+        failures += !roundTrip(name, source, cache);
+    }
+    failures += !roundTrip("<program>", TestFixtures::kProgram, cache);
+    failures += !rejectsDamage(TestFixtures::kProgram, cache);
+
+    std::cout << corpus.size() + 1 << " programs, " << failures << " failures" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,223 @@
+// 扁平语法树测试：把 tests/inputs 语料及内置用例的语法树转换为 FlatAst，逐节点与原节点比较
+// （类型、名字、字面量、子树边界），并检查两种表示上的常量求值结果一致、树上求值只为常量子树留下折叠标注；
+// 同时以 FlatAst 为规范形式，检查并行解析函数定义与顺序解析得到的语法树完全相同。
+// 用法：flat_ast_test <语料目录>
+#include "evalConstant.h"
+#include "flatAst.h"
+#include "parser.h"
+#include "testFixtures.h"
+#include "threadPool.h"
+#include <iostream>
+
+namespace
+{
+    // 含大量函数定义的程序，覆盖分批并行解析
+    std::string manyFunctions(size_t count)
+    {
+        std::string source = "const int K = 3;\nint g[2] = {1, 2};\n";
+        for (size_t i = 0; i < count; ++i)
+        {
+            std::string n = std::to_string(i);
+            source += (i % 3 == 0 ? "void f" : "int f") + n + "(int a, int b[])\n{\n";
+            source += "    int x = a * " + n + " + b[0];\n";
+            source += "    if (x > K)\n    {\n        x = x - 1;\n    }\n";
+            source += i % 3 == 0 ? "    return;\n}\n" : "    return x + " + n + ";\n}\n";
+        }
+        source += "int main()\n{\n    return 0;\n}\n";
+        return source;
+    }
+
+    bool isEvaluable(Node::Kind kind)
+    {
+        switch (kind)
+        {
+        case Node::ND_Number:
+        case Node::ND_LVal:
+        case Node::ND_CallExp:
+        case Node::ND_PrimaryExp:
+        case Node::ND_UnaryExp:
+        case Node::ND_AddExp:
+        case Node::ND_MulExp:
+        case Node::ND_LOrExp:
+        case Node::ND_LAndExp:
+        case Node::ND_EqExp:
+        case Node::ND_RelExp:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // 求值失败（如除零）时返回 false
+    template <typename F>
+    bool tryEval(F &&eval, int &value)
+    {
+        try
+        {
+            value = eval();
+            return true;
+        }
+        catch (std::runtime_error &)
+        {
+            return false;
+        }
+    }
+
+    bool sameTree(const std::string &name, std::string_view source)
+    {
+        StringInterner interner;
+        AST::AstArena arena;
+        Lexer lexer(source, interner);
+        Parser parser(lexer, arena);
+        CompUnit *program = parser.parseCompUnit();
+
+        std::vector<Node *> origins;
+        FlatAst flat = FlatAst::build(*program, &origins);
+        if (flat.size() != origins.size() || flat.size() == 0 || flat[FlatAst::kRoot].end_ != flat.size())
+        {
+            std::cerr << "FAIL " << name << ": bad node count " << flat.size() << std::endl;
+            return false;
+        }
+
+        EvalConstant evaluator;
+        for (uint32_t i = 0; i < flat.size(); ++i)
+        {
+            Node *node = origins[i];
+            const FlatNode &n = flat[i];
+            bool ok = n.kind() == node->getKind() && n.end_ > i && n.end_ <= flat.size();
+            for (uint32_t child : flat.children(i))
+            {
+                ok = ok && flat[child].end_ <= n.end_;
+            }
+
+            switch (node->getKind())
+            {
+            case Node::ND_Number:
+                ok = ok && n.value_ == static_cast<Number *>(node)->value_;
+                break;
+            case Node::ND_LVal:
+                ok = ok && static_cast<SymbolId>(n.value_) == static_cast<LVal *>(node)->nameId_;
+                break;
+            case Node::ND_CallExp:
+                ok = ok && static_cast<SymbolId>(n.value_) == static_cast<CallExp *>(node)->funcId_;
+                break;
+            case Node::ND_IOStmt:
+                ok = ok && (!(n.flags_ & FlatAst::kPrintf) ||
+                            flat.string(i) == static_cast<IOStmt *>(node)->formatString_);
+                break;
+            default:
+                break;
+            }
+
+            if (ok && isEvaluable(node->getKind()))
+            {
+                int expected = 0;
+                int actual = 0;
+                bool treeOk = tryEval([&] { return evaluator.Eval(node); }, expected);
+                bool constant = treeOk && evaluator.isConstant();
+                bool flatOk = tryEval([&] { return evaluator.Eval(flat, i); }, actual);
+                ok = treeOk == flatOk && expected == actual;
+                // 常量子树的成功求值在节点上留下标注，再次求值读取同一结果
+                auto *exp = static_cast<Exp *>(node);
+                ok = ok && exp->folded_ == constant && (!constant || exp->foldedValue_ == expected);
+                ok = ok && (!treeOk || evaluator.Eval(node) == expected);
+            }
+
+            if (!ok)
+            {
+                std::cerr << "FAIL " << name << ": flat node #" << i << " (kind " << static_cast<int>(n.kind_)
+                          << ") differs from the tree" << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 含变量引用的子树（如 x + 1）不是常量，求值后不留下折叠标注；常量子树照常标注
+    bool foldsOnlyConstants()
+    {
+        StringInterner interner;
+        AST::AstArena arena;
+        Lexer lexer("int main()\n{\n    int x = 1;\n    int y = x + 1;\n    int z = 2 + 3;\n    return 0;\n}\n", interner);
+        Parser parser(lexer, arena);
+        std::vector<Node *> origins;
+        FlatAst::build(*parser.parseCompUnit(), &origins);
+
+        std::vector<AddExp *> sums; // 依次为 x + 1 与 2 + 3
+        for (Node *node : origins)
+        {
+            auto *add = llvm::dyn_cast<AddExp>(node);
+            if (add && add->elements_.size() == 3)
+                sums.push_back(add);
+        }
+        EvalConstant evaluator;
+        bool ok = sums.size() == 2;
+        if (ok)
+        {
+            ok = evaluator.Eval(sums[0]) == 1 && !evaluator.isConstant() && !sums[0]->folded_ &&
+                 evaluator.Eval(sums[1]) == 5 && evaluator.isConstant() && sums[1]->folded_ && sums[1]->foldedValue_ == 5;
+            // 子树中的常量部分仍被标注
+            auto *one = std::get<Exp *>(sums[0]->elements_[2]);
+            ok = ok && one->folded_ && one->foldedValue_ == 1;
+        }
+        if (!ok)
+        {
+            std::cerr << "FAIL <folding>: non-constant subtree marked folded" << std::endl;
+        }
+        return ok;
+    }
+
+    bool sameParallelParse(const std::string &name, std::string_view source, ThreadPool &pool)
+    {
+        StringInterner interner;
+        Lexer lexer(source, interner);
+        lexer.tokenize();
+
+        AST::AstArena sequentialArena;
+        Parser sequential(lexer.getTokens(), sequentialArena);
+        FlatAst expected = FlatAst::build(*sequential.parseCompUnit());
+
+        AST::AstArena parallelArena;
+        Parser parallel(lexer.getTokens(), parallelArena);
+        FlatAst actual = FlatAst::build(*parallel.parseCompUnit(&pool));
+
+        bool same = expected.size() == actual.size() && sequentialArena.nodeCount() == parallelArena.nodeCount();
+        for (uint32_t i = 0; same && i < expected.size(); ++i)
+        {
+            const FlatNode &a = expected[i];
+            const FlatNode &b = actual[i];
+            same = a.kind_ == b.kind_ && a.op_ == b.op_ && a.unaryOp_ == b.unaryOp_ && a.flags_ == b.flags_ &&
+                   a.end_ == b.end_ && a.value_ == b.value_ && (!(a.flags_ & FlatAst::kPrintf) || expected.string(i) == actual.string(i));
+        }
+        if (!same)
+        {
+            std::cerr << "FAIL " << name << ": parallel parse differs from sequential parse" << std::endl;
+        }
+        return same;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: flat_ast_test <inputs dir>" << std::endl;
+        return 2;
+    }
+
+    ThreadPool pool(4);
+    size_t failures = 0;
+    auto corpus = TestFixtures::loadCorpus(argv[1]);
+    for (const auto &[name, source] : corpus)
+    {
+        failures += !sameTree(name, source);
+        failures += !sameParallelParse(name, source, pool);
+    }
+    failures += !sameTree("<program>", TestFixtures::kProgram);
+    failures += !sameParallelParse("<program>", TestFixtures::kProgram, pool);
+    failures += !sameParallelParse("<many functions>", manyFunctions(500), pool);
+    failures += !foldsOnlyConstants();
+
+    std::cout << corpus.size() + 1 << " programs, " << failures << " failures" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,15 @@
+const int SCALE = 3;
+int counter = 0;
+int scale(int x)
+{
+    counter = counter + 1;
+    return x * SCALE;
+}
+int combine(int a, int b)
+{
+    return a * 10 + b;
+}
+void report(int v)
+{
+    printf("%d\n", v);
+}
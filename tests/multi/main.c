@@ -0,0 +1,12 @@
+int base = 4;
+int twice(int n)
+{
+    return scale(n) + scale(n);
+}
+int main()
+{
+    int k;
+    k = getint();
+    report(combine(twice(k), base));
+    return 0;
+}
@@ -0,0 +1,501 @@
+// 逐个 reader 函数分派的词法分析器（状态机版本之前的实现），仅作为差分测试的参照。
+// 只在测试中使用：它在 '?'、':' 与未闭合的字符串上不会终止，生成输入时需避开。
+#include "referenceLexer.h"
+#include "charScanner.h"
+#include <algorithm>
+
+ReferenceLexer::ReferenceLexer(std::string_view sourceCode) : sourceCode_(sourceCode), currentPosition_(0), currentLine_(1), currentColumn_(1) {}
+
+void ReferenceLexer::tokenize()
+{
+    ReferenceToken token;
+    while (token.tokenType_ != TokenType::END_OF_FILE)
+    {
+        token = getNextToken();
+        tokens_.push_back(token);
+    }
+}
+
+std::vector<ReferenceToken> &ReferenceLexer::getTokens()
+{
+    return tokens_;
+}
+
+ReferenceToken ReferenceLexer::getNextToken()
+{
+
+    // 跳过空白字符
+    skipWhitespaceOrComments();
+
+    // 是否结尾
+    if (currentPosition_ >= sourceCode_.length())
+    {
+        return ReferenceToken(TokenType::END_OF_FILE, std::string_view(), currentLine_, currentColumn_);
+    }
+
+    char c = peek(); // 读取当前指向字符
+
+    // 起始状态
+    // 进入识别标识符/关键字状态
+    if (isalpha(c) || c == '_')
+    {
+        return readIdentifierOrKeyword();
+    }
+    else if (c == '"')
+    {
+        return readString();
+    }
+    else if (isdigit(c))
+    {
+        return readNumber();
+    }
+    else if (isOperator(peek()))
+    {
+        return readOperator();
+    }
+
+    else if (isSymbol(sourceCode_[currentPosition_]))
+    {
+        return readSymbol();
+    }
+    else
+    {
+        ReferenceToken error(TokenType::UNKNOW, sourceCode_.substr(currentPosition_, 1), currentLine_, currentColumn_);
+        advance();
+        return error;
+    }
+}
+
+// 默认读取当前指向字符
+char ReferenceLexer::peek(size_t ahead) const
+{
+    size_t pos = currentPosition_ + ahead;
+    return pos < sourceCode_.length() ? sourceCode_[pos] : '\0';
+}
+
+// 读取当前pos指向位置字符，并后移一位
+char ReferenceLexer::advance()
+{
+    if (currentPosition_ >= sourceCode_.length())
+        return '\0';
+
+    char c = sourceCode_[currentPosition_++];
+    if (c == '\n')
+    {
+        currentLine_++;
+        currentColumn_ = 1;
+    }
+    else
+    {
+        currentColumn_++;
+    }
+    return c;
+}
+
+ReferenceToken ReferenceLexer::readIdentifierOrKeyword()
+{
+    int startLine = currentLine_;
+    int startColumn = currentColumn_;
+    size_t start = currentPosition_;
+
+    while (std::isalnum(peek()) || peek() == '_')
+    {
+        advance();
+    }
+
+    std::string_view identifier = sourceCode_.substr(start, currentPosition_ - start);
+    return ReferenceToken(Lexer::classifyKeyword(identifier), identifier, startLine, startColumn);
+}
+
+ReferenceToken ReferenceLexer::readNumber()
+{
+    int startLine = currentLine_;
+    int startColumn = currentColumn_;
+    size_t start = currentPosition_;
+    bool isFloat = false;
+    bool isHex = false;
+    bool isScientific = false;
+    bool error = false;
+    std::string errorMsg;
+
+    // 数字类型检测
+    if (peek() == '0' && (peek(1) == 'x' || peek(1) == 'X'))
+    {
+        // 十六进制处理
+        advance();
+        advance();
+        isHex = true;
+
+        bool hasDigits = false;
+        while (isxdigit(peek()))
+        {
+            advance();
+            hasDigits = true;
+        }
+
+        if (!hasDigits)
+        {
+            error = true;
+            errorMsg = "Hexadecimal number requires at least one digit";
+        }
+    }
+    else
+    {
+        // 十进制处理（可能包含浮点数）
+        while (std::isdigit(peek()) || peek() == '.')
+        {
+            if (peek() == '.')
+            {
+                if (isFloat)
+                {
+                    error = true;
+                    errorMsg = "Multiple decimal points in number";
+                }
+                isFloat = true;
+                advance();
+
+                // 小数点后必须有数字
+                if (!std::isdigit(peek()))
+                {
+                    error = true;
+                    errorMsg = "Decimal point must be followed by digit";
+                }
+            }
+            else
+            {
+                advance();
+            }
+        }
+
+        // 科学计数法处理
+        if (!isHex && (peek() == 'e') || peek() == 'E')
+        {
+            isScientific = true;
+            isFloat = true;
+            ;
+            advance(); // e/E
+
+            // 处理符号
+            if (peek() == '+' || peek() == '-')
+            {
+                advance();
+            }
+
+            // 指数部分必须有数字
+            bool hasExponentDigits = false;
+            while (std::isdigit(peek()))
+            {
+                advance();
+                hasExponentDigits = true;
+            }
+
+            if (!hasExponentDigits)
+            {
+                error = true;
+                errorMsg = "Exponent requires at least one digit";
+            }
+        }
+    }
+
+    // 后缀处理（可扩展类型后缀，如f/F、u/U等）
+    if (!isHex)
+    {
+        while (std::isalpha(peek()))
+        {
+            char c = advance();
+            if (c == 'f' || c == 'F' || c == 'l' || c == 'L')
+            {
+                isFloat = true;
+            }
+            else
+            {
+                error = true;
+                errorMsg = "Invalid numeric suffix '" + std::string(1, c) + "'";
+            }
+        }
+    }
+
+    // 错误处理
+    if (error)
+    {
+        // 读取到非法字符时继续前进知道数字结束
+        while (std::isalnum(peek()) || peek() == '.')
+        {
+            advance();
+        }
+        messages_.push_back(errorMsg);
+        return ReferenceToken(TokenType::ERROR, messages_.back(), startLine, startColumn);
+    }
+
+    std::string_view num = sourceCode_.substr(start, currentPosition_ - start);
+
+    // 验证数字格式
+    if (isHex && isFloat)
+    {
+        return ReferenceToken(TokenType::ERROR, "Hexadecimal cannot have decimal point,startLine,startColumn", startLine, startColumn);
+    }
+    if (num.find('.') != std::string_view::npos && !isFloat)
+    {
+        return ReferenceToken(TokenType::ERROR, "Invalid number format", startLine, startColumn);
+    }
+
+    return ReferenceToken{isFloat ? TokenType::CONSTANT_FLOAT : TokenType::CONSTANT_INTEGER, num, startLine, startColumn};
+}
+
+ReferenceToken ReferenceLexer::readString()
+{
+    int startLine = currentLine_;
+    int startColumn = currentColumn_;
+    size_t start = currentPosition_;
+
+    advance();
+    while (peek() != '"' && currentPosition_ <= sourceCode_.length())
+    {
+        if (peek() == '\\')
+        { // 处理转义
+            // advance();
+            //  只允许\n转义
+            if (peek(1) != 'n')
+            {
+                return ReferenceToken(TokenType::ERROR, "Invalid escape sequence", startLine, startColumn);
+            }
+            advance(); // 跳过
+        }
+        advance();
+    }
+
+    if (currentPosition_ >= sourceCode_.length())
+        return ReferenceToken(TokenType::ERROR, "Unclosed string", startLine, startColumn);
+    advance(); // 跳过闭合的"
+    return ReferenceToken(TokenType::CONSTANT_STRING, sourceCode_.substr(start, currentPosition_ - start), startLine, startColumn);
+}
+
+TokenType ReferenceLexer::classifyOperator(std::string_view text, size_t &length)
+{
+    char c0 = text.size() > 0 ? text[0] : '\0';
+    char c1 = text.size() > 1 ? text[1] : '\0';
+    char c2 = text.size() > 2 ? text[2] : '\0';
+
+    length = 1;
+    switch (c0)
+    {
+    case '+':
+        if (c1 == '+')
+        {
+            length = 2;
+            return TokenType::OPERATOR_INCREMENT;
+        }
+        if (c1 == '=')
+        {
+            length = 2;
+            return TokenType::OPERATOR_AND_ASSIGN; // 与原 operators_ 表中的映射一致
+        }
+        return TokenType::OPERATOR_PLUS;
+    case '-':
+        if (c1 == '-')
+        {
+            length = 2;
+            return TokenType::OPERATOR_DECREMENT;
+        }
+        if (c1 == '=')
+        {
+            length = 2;
+            return TokenType::OPERATOR_MINUS_ASSIGN;
+        }
+        return TokenType::OPERATOR_MINUS;
+    case '*':
+        if (c1 == '=')
+        {
+            length = 2;
+            return TokenType::OPERATOR_MULTIPLY_ASSIGN;
+        }
+        return TokenType::OPERATOR_MULTIPLY;
+    case '/':
+        if (c1 == '=')
+        {
+            length = 2;
+            return TokenType::OPERATOR_DIVIDE_ASSIGN;
+        }
+        return TokenType::OPERATOR_DIVIDE;
+    case '%':
+        if (c1 == '=')
+        {
+            length = 2;
+            return TokenType::OPERATOR_MODULO_ASSIGN;
+        }
+        return TokenType::OPERATOR_MODULO;
+    case '=':
+        if (c1 == '=')
+        {
+            length = 2;
+            return TokenType::OPERATOR_EQUAL;
+        }
+        return TokenType::OPERATOR_ASSIGN;
+    case '!':
+        if (c1 == '=')
+        {
+            length = 2;
+            return TokenType::OPERATOR_NOT_EQUAL;
+        }
+        return TokenType::OPERATOR_LOGICAL_NOT;
+    case '<':
+        if (c1 == '<')
+        {
+            length = c2 == '=' ? 3 : 2;
+            return c2 == '=' ? TokenType::OPERATOR_LEFT_SHIFT_ASSIGN : TokenType::OPERATOR_LEFT_SHIFT;
+        }
+        if (c1 == '=')
+        {
+            length = 2;
+            return TokenType::OPERATOR_LESS_EQUAL;
+        }
+        return TokenType::OPERATOR_LESS;
+    case '>':
+        if (c1 == '>')
+        {
+            length = c2 == '=' ? 3 : 2;
+            return c2 == '=' ? TokenType::OPERATOR_RIGHT_SHIFT_ASSIGN : TokenType::OPERATOR_RIGHT_SHIFT;
+        }
+        if (c1 == '=')
+        {
+            length = 2;
+            return TokenType::OPERATOR_GREATER_EQUAL;
+        }
+        return TokenType::OPERATOR_GREATER;
+    case '&':
+        if (c1 == '&')
+        {
+            length = 2;
+            return TokenType::OPERATOR_LOGICAL_AND;
+        }
+        if (c1 == '=')
+        {
+            length = 2;
+            return TokenType::OPERATOR_AND_ASSIGN;
+        }
+        return TokenType::OPERATOR_BITWISE_AND;
+    case '|':
+        if (c1 == '|')
+        {
+            length = 2;
+            return TokenType::OPERATOR_LOGICAL_OR;
+        }
+        if (c1 == '=')
+        {
+            length = 2;
+            return TokenType::OPERATOR_OR_ASSIGN;
+        }
+        return TokenType::OPERATOR_BITWISE_OR;
+    case '^':
+        if (c1 == '=')
+        {
+            length = 2;
+            return TokenType::OPERATOR_XOR_ASSIGN;
+        }
+        return TokenType::OPERATOR_BITWISE_XOR;
+    case '~':
+        return TokenType::OPERATOR_BITWISE_NOT;
+    default:
+        length = 0;
+        return TokenType::UNKNOW;
+    }
+}
+
+ReferenceToken ReferenceLexer::readOperator()
+{
+    int startLine = currentLine_;
+    int startColumn = currentColumn_;
+
+    std::string_view rest = sourceCode_.substr(currentPosition_, 3);
+    size_t length = 0;
+    TokenType type = classifyOperator(rest, length);
+    if (length == 0)
+    {
+        return ReferenceToken(TokenType::UNKNOW, rest.substr(0, 1), startLine, startColumn);
+    }
+
+    for (size_t i = 0; i < length; ++i)
+    {
+        advance();
+    }
+    return ReferenceToken(type, rest.substr(0, length), startLine, startColumn);
+}
+
+ReferenceToken ReferenceLexer::readSymbol()
+{
+    int startLine = currentLine_;
+    int startColumn = currentColumn_;
+
+    std::string_view symbol = sourceCode_.substr(currentPosition_, 1);
+    advance();
+
+    return ReferenceToken(Lexer::classifyPunctuation(symbol[0]), symbol, startLine, startColumn);
+}
+
+void ReferenceLexer::skipWhitespaceOrComments()
+{
+    // 空白与注释按块扫描（见 charScanner），扫描结束后统计跳过的换行，一次性同步位置、行号与列号
+    size_t start = currentPosition_;
+    size_t pos = currentPosition_;
+    size_t length = sourceCode_.length();
+    bool unclosedComment = false;
+
+    while (pos < length)
+    {
+        char c = sourceCode_[pos];
+        char next = pos + 1 < length ? sourceCode_[pos + 1] : '\0';
+        if (c == '/' && next == '/')
+        {
+            // 行注释：停在换行符处，换行由空白扫描跳过
+            pos = CharScanner::findLineEnd(sourceCode_, pos + 2);
+        }
+        else if (c == '/' && next == '*')
+        {
+            pos = CharScanner::findCommentEnd(sourceCode_, pos + 2);
+            if (pos >= length)
+            { // 文件结束
+                unclosedComment = true;
+                break;
+            }
+            pos += 2;
+        }
+        else if (isspace(static_cast<unsigned char>(c)))
+        {
+            pos = CharScanner::skipWhitespace(sourceCode_, pos);
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    std::string_view skipped = sourceCode_.substr(start, pos - start);
+    size_t lastNewline = skipped.rfind('\n');
+    if (lastNewline != std::string_view::npos)
+    {
+        currentLine_ += static_cast<int>(std::count(skipped.begin(), skipped.end(), '\n'));
+        currentColumn_ = static_cast<int>(skipped.size() - lastNewline);
+    }
+    else
+    {
+        currentColumn_ += static_cast<int>(pos - start);
+    }
+    currentPosition_ = pos;
+
+    if (unclosedComment)
+    {
+        tokens_.push_back(ReferenceToken(TokenType::ERROR, "Unclosed comment", currentLine_, currentColumn_));
+    }
+}
+
+bool ReferenceLexer::isOperator(char c)
+{
+    static const std::string operators = "+-*/=<>!&|?:";
+    return operators.find(c) != std::string::npos;
+}
+
+bool ReferenceLexer::isSymbol(char c)
+{
+    static const std::string symbols = "{}();,[]";
+    return symbols.find(c) != std::string::npos;
+}
@@ -0,0 +1,54 @@
+#ifndef REFERENCELEXER_H
+#define REFERENCELEXER_H
+
+#include "lexer.h"
+
+// 参照实现逐字符维护行列号，用来检验 Lexer 由偏移按需换算出的行列号
+struct ReferenceToken
+{
+    ReferenceToken() : tokenType_(TokenType::UNKNOW), value_("unknow"), line_(-1), colume_(-1) {}
+    ReferenceToken(TokenType tokenType, std::string_view value, int line, int colume)
+        : tokenType_(tokenType), value_(value), line_(line), colume_(colume) {}
+    TokenType tokenType_;
+    std::string_view value_;
+    int line_;
+    int colume_;
+};
+
+// 差分测试的参照：按首字符分派到各个 reader 函数的原词法分析器
+class ReferenceLexer
+{
+public:
+    explicit ReferenceLexer(std::string_view sourceCode);
+    void tokenize();
+    std::vector<ReferenceToken> &getTokens();
+    ReferenceToken getNextToken();
+
+    // 运算符：按首字符分支的最长匹配，length 返回匹配长度（0 表示不是运算符）。
+    // Lexer 的状态机取代了它，保留在参照实现中用于差分测试与基准
+    static TokenType classifyOperator(std::string_view text, size_t &length);
+
+private:
+    std::string_view sourceCode_;
+    size_t currentPosition_;
+    int currentLine_;
+    int currentColumn_;
+
+    std::vector<ReferenceToken> tokens_;
+    std::list<std::string> messages_;
+
+    char peek(size_t ahead = 0) const;
+    char advance();
+
+    void skipWhitespaceOrComments();
+    ReferenceToken readIdentifierOrKeyword();
+    ReferenceToken readNumber();
+    ReferenceToken readString();
+    ReferenceToken readOperator();
+    ReferenceToken readSymbol();
+
+    bool isOperator(char c);
+    bool isSymbol(char c);
+};
+
+#endif // REFERENCELEXER_H
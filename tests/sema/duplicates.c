@@ -0,0 +1,51 @@
+int g = 1;
+int f0(int a)
+{
+    int x0 = 1;
+    int x0 = 2;
+    x0 = a + g;
+    return x0;
+}
+int f1(int a)
+{
+    int x1 = 1;
+    int x1 = 2;
+    x1 = a + g;
+    return x1;
+}
+int f2(int a)
+{
+    int x2 = 1;
+    int x2 = 2;
+    x2 = a + g;
+    return x2;
+}
+int f3(int a)
+{
+    int x3 = 1;
+    int x3 = 2;
+    x3 = a + g;
+    return x3;
+}
+int f4(int a)
+{
+    int x4 = 1;
+    int x4 = 2;
+    x4 = a + g;
+    return x4;
+}
+int f5(int a)
+{
+    int x5 = 1;
+    int x5 = 2;
+    x5 = a + g;
+    return x5;
+}
+int main()
+{
+    int y = 0;
+    int y = 1;
+    y = f5(1);
+    printf("%d", y);
+    return 0;
+}
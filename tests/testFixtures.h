@@ -0,0 +1,68 @@
+#ifndef TESTFIXTURES_H
+#define TESTFIXTURES_H
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// 测试共用的输入：内置用例程序与 tests/inputs 语料
+namespace TestFixtures
+{
+    // 覆盖多维常量数组、数组形参、条件、括号、一元运算、各层二元运算、空块、
+    // 调用语句与不带参数的 printf 的用例
+    inline const char *kProgram = R"(const int N = 2 * (3 + 4) / 5, M[2][2] = {{1, 2}, {3}};
+int g[N + 1] = {1, -2, +3}, h;
+void p(int a[], int b[][N]) { return; }
+int f(int a, int b[][4])
+{
+    return -(a - 1) * !a + b[0][1] / 2;
+}
+int main()
+{
+    int x = (1 + 2) * 3, y;
+    y = getint();
+    if (x < 3 && y == 1 || !x)
+        x = x + f(x, g) * 3 / 2;
+    else
+        x = - + - x;
+    while (x >= 1 && x != 7)
+    {
+        x = x - 1;
+        f(x, M);
+    }
+    {}
+    printf("%d %d\n", x, y * 2);
+    printf("done\n");
+    return 0;
+}
+)";
+
+    inline std::string readFile(const std::string &path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        return buffer.str();
+    }
+
+    // 目录中全部 .c 文件的（文件名，源码），按文件名排序
+    inline std::vector<std::pair<std::string, std::string>> loadCorpus(const std::string &dir)
+    {
+        std::vector<std::pair<std::string, std::string>> corpus;
+        for (const auto &entry : std::filesystem::directory_iterator(dir))
+        {
+            if (entry.is_regular_file() && entry.path().extension() == ".c")
+            {
+                corpus.emplace_back(entry.path().filename().string(), readFile(entry.path().string()));
+            }
+        }
+        std::sort(corpus.begin(), corpus.end());
+        return corpus;
+    }
+}
+
+#endif // TESTFIXTURES_H